@@ -6,6 +6,9 @@
  * Bluefruit library on nRF52 boards. It scans for BLE advertisements
  * and parses any detected beacons.
  *
+ * The scan callback only queues reports; parsing and printing happen in
+ * loop(), so the radio event path is never held up by Serial output.
+ *
  * Hardware Requirements:
  * - Adafruit nRF52 Feather or compatible board
  * - Bluefruit library installed
@@ -16,6 +19,7 @@
 #include "bluefruit.h"
 
 BluefruitBeaconParser parser;
+ScanRingBuffer<32> scan_queue;
 
 void printBeaconData(const BeaconData& result) {
   Serial.print("Beacon Type: ");
@@ -24,7 +28,7 @@ void printBeaconData(const BeaconData& result) {
     case BEACON_TYPE_IBEACON:
       Serial.println("iBeacon");
       Serial.print("  UUID: ");
-      Serial.println(result.getIBeacon().uuid);
+      Serial.println(result.getIBeacon().uuidString());
       Serial.print("  Major: ");
       Serial.println(result.getIBeacon().major);
       Serial.print("  Minor: ");
@@ -107,20 +111,23 @@ void printBeaconData(const BeaconData& result) {
   Serial.println();
 }
 
+/**
+ * @brief Called from loop() for each queued report that parsed as a beacon
+ */
+void on_beacon(const BeaconData& result, const ScanObservation& observation) {
+  Serial.println("=== Beacon Detected ===");
+  Serial.print("RSSI: ");
+  Serial.print(observation.rssi);
+  Serial.println(" dBm");
+  printBeaconData(result);
+}
+
 /**
  * @brief Scan callback function called when an advertisement is received
  */
 void scan_callback(ble_gap_evt_adv_report_t* report) {
-  BeaconData result;
-
-  // Try to parse the advertisement as a beacon
-  if (parser.parse(report, result) && result.valid) {
-    Serial.println("=== Beacon Detected ===");
-    Serial.print("RSSI: ");
-    Serial.print(report->rssi);
-    Serial.println(" dBm");
-    printBeaconData(result);
-  }
+  // Copy the report and return; parsing happens in loop()
+  parser.enqueue(report);
 
   // Resume scanning
   Bluefruit.Scanner.resume();
@@ -132,6 +139,8 @@ void setup() {
     delay(10);
   }
 
+  parser.setQueue(&scan_queue);
+
   Serial.println("BLE Beacon Parser - Bluefruit Example");
   Serial.println("======================================");
   Serial.println();
@@ -152,7 +161,16 @@ void setup() {
 }
 
 void loop() {
-  // Scanning is handled in the callback
-  delay(100);
+  // Parse reports queued by the scan callback
+  if (parser.drain(on_beacon) == 0) {
+    delay(10);
+  }
+
+  static uint32_t last_overflows = 0;
+  if (scan_queue.overflows() != last_overflows) {
+    last_overflows = scan_queue.overflows();
+    Serial.print("Scan queue overflows: ");
+    Serial.println(last_overflows);
+  }
 }
 
@@ -76,7 +76,7 @@ void printBeaconData(const BeaconData& result) {
     case BEACON_TYPE_IBEACON:
       Serial.println("iBeacon");
       Serial.print("  UUID: ");
-      Serial.println(result.getIBeacon().uuid);
+      Serial.println(result.getIBeacon().uuidString());
       Serial.print("  Major: ");
       Serial.println(result.getIBeacon().major);
       Serial.print("  Minor: ");
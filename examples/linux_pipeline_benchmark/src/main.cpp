@@ -0,0 +1,137 @@
+/**
+ * @file linux_pipeline_benchmark/main.cpp
+ * @brief Throughput of BeaconPipeline as worker threads are added
+ *
+ * Feeds synthetic scan traffic (iBeacon, Eddystone-UID and non-beacon
+ * advertisements from a few thousand advertisers) through a BeaconPipeline
+ * with 1, 2, 4, 8 and 16 workers and prints reports per second for each.
+ *
+ * Usage: program [max_workers] [reports_per_run] [ingest_threads]
+ *
+ * Ingest threads retry when a shard queue is full, so the figure is the
+ * rate the workers sustain. Run on an otherwise idle machine with at least
+ * max_workers + ingest_threads cores for meaningful scaling numbers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <thread>
+#include <vector>
+#include "BeaconPipeline.h"
+
+#define POOL_SIZE 4096
+
+struct SyntheticReport {
+  uint8_t data[31];
+  uint8_t len;
+  uint8_t address[6];
+};
+
+static SyntheticReport pool[POOL_SIZE];
+
+static void buildPool() {
+  const uint8_t ibeacon[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                             0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                             0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+  const uint8_t eddystone_uid[] = {0x03, 0x03, 0xAA, 0xFE, 0x17, 0x16, 0xAA, 0xFE, 0x00, 0xEB,
+                                   0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
+                                   0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x00, 0x00};
+  const uint8_t other[] = {0x02, 0x01, 0x06, 0x09, 0xFF, 0x59, 0x00, 0x01,
+                           0x02, 0x03, 0x04, 0x05, 0x06};
+
+  for (uint16_t i = 0; i < POOL_SIZE; i++) {
+    SyntheticReport& report = pool[i];
+    switch (i % 4) {
+      case 0:
+      case 1:
+        memcpy(report.data, ibeacon, sizeof(ibeacon));
+        report.len = sizeof(ibeacon);
+        report.data[24] = i >> 8;
+        report.data[25] = i & 0xFF;
+        break;
+      case 2:
+        memcpy(report.data, eddystone_uid, sizeof(eddystone_uid));
+        report.len = sizeof(eddystone_uid);
+        report.data[24] = i >> 8;
+        report.data[25] = i & 0xFF;
+        break;
+      default:
+        memcpy(report.data, other, sizeof(other));
+        report.len = sizeof(other);
+        report.data[12] = i & 0xFF;
+        break;
+    }
+
+    report.address[0] = 0xC0;
+    report.address[1] = 0x11;
+    report.address[2] = 0x22;
+    report.address[3] = 0x33;
+    report.address[4] = i >> 8;
+    report.address[5] = i & 0xFF;
+  }
+}
+
+static double seconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static double run(uint8_t workers, uint32_t reports, uint8_t ingest_threads, uint64_t& steals) {
+  BeaconPipelineConfig config;
+  config.workers = workers;
+  config.shards = 256;
+  config.queue_slots = 4096;
+  BeaconPipeline pipeline(config);
+
+  pipeline.start();
+  double begin = seconds();
+
+  std::vector<std::thread> ingest;
+  for (uint8_t t = 0; t < ingest_threads; t++) {
+    ingest.push_back(std::thread([&pipeline, reports, ingest_threads, t]() {
+      for (uint32_t n = t; n < reports; n += ingest_threads) {
+        const SyntheticReport& report = pool[n % POOL_SIZE];
+        while (!pipeline.submit(report.data, report.len, -60, report.address)) {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+  for (size_t t = 0; t < ingest.size(); t++) {
+    ingest[t].join();
+  }
+  pipeline.stop();
+
+  double elapsed = seconds() - begin;
+  steals = pipeline.steals();
+  return pipeline.processed() / elapsed;
+}
+
+int main(int argc, char** argv) {
+  int requested = argc > 1 ? atoi(argv[1]) : 16;
+  uint8_t max_workers = requested < 1 ? 1 : (requested > 255 ? 255 : requested);
+  uint32_t reports = argc > 2 ? strtoul(argv[2], nullptr, 10) : 4000000;
+  uint8_t ingest_threads = argc > 3 ? atoi(argv[3]) : 4;
+
+  buildPool();
+  printf("%u reports per run, %u ingest threads, %u CPUs\n", reports, ingest_threads,
+         std::thread::hardware_concurrency());
+  printf("%8s %14s %8s %10s\n", "workers", "reports/s", "speedup", "steals");
+
+  double baseline = 0;
+  // Wider than max_workers so doubling past 128 ends the loop
+  for (uint16_t workers = 1; workers <= max_workers; workers *= 2) {
+    uint64_t steals = 0;
+    double rate = run((uint8_t)workers, reports, ingest_threads, steals);
+    if (baseline == 0) {
+      baseline = rate;
+    }
+    printf("%8u %14.0f %7.2fx %10llu\n", workers, rate, rate / baseline,
+           (unsigned long long)steals);
+  }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+#include "ADStructures.h"
+#include <string.h>
+
+const ADField* ADFields::find(uint8_t type, uint16_t id) const {
+  for (uint8_t i = 0; i < count; i++) {
+    if (fields[i].type == type && fields[i].id == id) {
+      return &fields[i];
+    }
+  }
+  return nullptr;
+}
+
+ADTokenizer::ADTokenizer(const uint8_t* advertisement, uint16_t length)
+    : data(advertisement), len(advertisement == nullptr ? 0 : length), pos(0) {}
+
+bool ADTokenizer::next(ADField& field) {
+  // Parse AD structures: [Length][Type][Data...]
+  while (pos < len) {
+    uint8_t ad_len = data[pos];
+
+    // Check for valid length (0 means end of data)
+    if (ad_len == 0) {
+      break;
+    }
+
+    // ad_len includes the Type byte, so the structure occupies 1 + ad_len bytes
+    if (pos + 1 + ad_len > len) {
+      break;
+    }
+
+    uint16_t start = pos;
+    uint8_t ad_type = data[start + 1];
+
+    // Move to next AD structure
+    pos += ad_len + 1;
+
+    // Return manufacturer/service data carrying at least a 2-byte ID
+    // (Type + ID = 3 bytes)
+    if ((ad_type == AD_TYPE_MANUFACTURER_SPECIFIC_DATA || ad_type == AD_TYPE_SERVICE_DATA) &&
+        ad_len >= 3) {
+      field.type = ad_type;
+      field.id = (data[start + 3] << 8) | data[start + 2];  // Little-endian
+      field.data = &data[start + 4];
+      field.len = ad_len - 3;  // Subtract Type and ID bytes
+      return true;
+    }
+  }
+
+  // End of data or a truncated structure ends the walk
+  pos = len;
+  return false;
+}
+
+uint8_t ADTokenizer::tokenize(const uint8_t* data, uint16_t len, ADFields& out) {
+  out.count = 0;
+
+  ADTokenizer tokens(data, len);
+  while (out.count < AD_MAX_FIELDS && tokens.next(out.fields[out.count])) {
+    out.count++;
+  }
+
+  return out.count;
+}
+
+uint8_t ADTokenizer::tokenize(const uint8_t* data, uint16_t len, ADFields& out, uint8_t type,
+                              uint16_t id) {
+  out.count = 0;
+
+  ADTokenizer tokens(data, len);
+  ADField field;
+  while (out.count < AD_MAX_FIELDS && tokens.next(field)) {
+    if (field.type == type && field.id == id) {
+      out.fields[out.count++] = field;
+    }
+  }
+
+  return out.count;
+}
+
+// AD types recorded as ADFields
+static bool isFieldType(uint8_t ad_type) {
+  return ad_type == AD_TYPE_MANUFACTURER_SPECIFIC_DATA || ad_type == AD_TYPE_SERVICE_DATA;
+}
+
+ADChainTokenizer::ADChainTokenizer(const AdvFragment* chain, uint8_t chain_count)
+    : fragments(chain), count(chain == nullptr ? 0 : chain_count), index(0), offset(0),
+      copy_count(0) {}
+
+uint16_t ADChainTokenizer::advance(uint16_t n, uint8_t* out) {
+  uint16_t done = 0;
+
+  // Step across fragment boundaries, copying if asked to
+  while (done < n && index < count) {
+    const AdvFragment& fragment = fragments[index];
+    uint16_t available = fragment.data == nullptr ? 0 : fragment.len - offset;
+    uint16_t take = n - done < available ? n - done : available;
+    if (out != nullptr && take > 0) {
+      memcpy(&out[done], &fragment.data[offset], take);
+    }
+    done += take;
+    offset += take;
+    if (take == available) {
+      index++;
+      offset = 0;
+    }
+  }
+
+  // Leave the cursor on a fragment with bytes left, if any
+  while (index < count && (fragments[index].data == nullptr || fragments[index].len == 0)) {
+    index++;
+  }
+
+  return done;
+}
+
+bool ADChainTokenizer::next(ADField& field) {
+  uint8_t ad_len;
+
+  // Parse AD structures: [Length][Type][Data...]
+  while (advance(1, &ad_len) == 1 && ad_len != 0) {
+    const uint8_t* structure;
+
+    if (index < count && fragments[index].data != nullptr &&
+        fragments[index].len - offset >= ad_len) {
+      // Wholly inside the current fragment
+      structure = &fragments[index].data[offset];
+      advance(ad_len, nullptr);
+    } else {
+      // Straddles a boundary: copy it only if it may be returned
+      if (advance(1, scratch) != 1) {
+        break;
+      }
+      bool wanted = isFieldType(scratch[0]) && ad_len >= 3;
+      if (advance(ad_len - 1, wanted ? &scratch[1] : nullptr) != ad_len - 1) {
+        break;
+      }
+      if (wanted) {
+        copy_count++;
+      }
+      structure = scratch;
+    }
+
+    if (isFieldType(structure[0]) && ad_len >= 3) {
+      field.type = structure[0];
+      field.id = (structure[2] << 8) | structure[1];  // Little-endian
+      field.data = &structure[3];
+      field.len = ad_len - 3;  // Subtract Type and ID bytes
+      return true;
+    }
+  }
+
+  // End of data or a truncated structure ends the walk
+  index = count;
+  return false;
+}
@@ -0,0 +1,186 @@
+#ifndef AD_STRUCTURES_H
+#define AD_STRUCTURES_H
+
+#include <stdint.h>
+
+// AD Structure types
+#define AD_TYPE_SERVICE_DATA 0x16
+#define AD_TYPE_MANUFACTURER_SPECIFIC_DATA 0xFF
+
+// Maximum number of manufacturer/service data structures ADFields records
+// (ADTokenizer::next() visits every one)
+#define AD_MAX_FIELDS 4
+
+// Largest AD structure body (type and data bytes)
+#define AD_MAX_STRUCTURE_SIZE 255
+
+/**
+ * @brief Pre-located manufacturer-specific or service data slice
+ *
+ * Points into the caller's advertisement buffer; no bytes are copied.
+ */
+struct ADField {
+  uint8_t type;         // AD type (AD_TYPE_MANUFACTURER_SPECIFIC_DATA or AD_TYPE_SERVICE_DATA)
+  uint16_t id;          // Company ID or 16-bit service UUID (host order)
+  const uint8_t* data;  // Payload following the ID bytes
+  uint8_t len;          // Payload length (excludes length, type and ID bytes)
+};
+
+/**
+ * @brief Manufacturer-specific and service data structures of one packet
+ *
+ * Fields are stored in the order they appear in the advertisement, up to
+ * AD_MAX_FIELDS of them.
+ */
+struct ADFields {
+  ADField fields[AD_MAX_FIELDS];
+  uint8_t count;
+
+  ADFields() : count(0) {}
+
+  /**
+   * @brief Find the first field with the given AD type and ID
+   * @param type AD type to match
+   * @param id Company ID or service UUID to match
+   * @return Pointer to the matching field, or nullptr if none
+   */
+  const ADField* find(uint8_t type, uint16_t id) const;
+};
+
+/**
+ * @brief Single-pass AD structure tokenizer
+ *
+ * Walks the [Length][Type][Data...] structures of an advertisement exactly
+ * once and locates every manufacturer-specific (0xFF) and service data (0x16)
+ * structure together with its company ID / service UUID. Format parsers then
+ * work on the pre-located slices instead of re-walking the packet.
+ *
+ * next() hands out the fields one at a time, however many the packet holds,
+ * so a caller can dispatch each as it is found:
+ *
+ * @code
+ * ADTokenizer tokens(data, len);
+ * ADField field;
+ * while (tokens.next(field)) {
+ *   // field points into data
+ * }
+ * @endcode
+ *
+ * tokenize() collects them into an ADFields instead, keeping the first
+ * AD_MAX_FIELDS.
+ *
+ * Structures that run past the end of the buffer terminate the walk, and
+ * structures too short to carry a 2-byte ID are skipped.
+ */
+class ADTokenizer {
+ public:
+  /**
+   * @param data Raw advertisement data (must outlive the tokenizer)
+   * @param len Length of advertisement data
+   */
+  ADTokenizer(const uint8_t* data, uint16_t len);
+
+  /**
+   * @brief Find the next manufacturer-specific or service data structure
+   * @param field Set to the structure, pointing into the advertisement data
+   * @return false at the end of the data, a zero length byte or a structure
+   *         running past the end of the buffer
+   */
+  bool next(ADField& field);
+
+  /**
+   * @brief Tokenize raw advertisement data
+   * @param data Raw advertisement data
+   * @param len Length of advertisement data
+   * @param out Fields found in the packet (count is reset first)
+   * @return Number of fields recorded (at most AD_MAX_FIELDS)
+   */
+  static uint8_t tokenize(const uint8_t* data, uint16_t len, ADFields& out);
+
+  /**
+   * @brief Tokenize raw advertisement data, recording only fields with one key
+   *
+   * Used by the per-format parsers, whose field may follow any number of
+   * other manufacturer or service data structures.
+   *
+   * @param type AD type to record
+   * @param id Company ID or service UUID to record
+   * @return Number of fields recorded (at most AD_MAX_FIELDS)
+   */
+  static uint8_t tokenize(const uint8_t* data, uint16_t len, ADFields& out, uint8_t type,
+                          uint16_t id);
+
+ private:
+  const uint8_t* data;
+  uint16_t len;
+  uint16_t pos;  // Next structure's length byte
+};
+
+/**
+ * @brief One fragment of a chained extended advertisement
+ *
+ * Extended advertising data (up to 1650 bytes) arrives split over an
+ * AUX_ADV_IND and its AUX_CHAIN_IND PDUs, or over several HCI extended
+ * reports; AD structures may straddle the fragment boundaries.
+ */
+struct AdvFragment {
+  const uint8_t* data;  // Fragment bytes
+  uint16_t len;         // Length of the fragment
+};
+
+/**
+ * @brief AD structure tokenizer over a chain of fragments
+ *
+ * Walks the fragments as one advertisement without joining them first.
+ * Manufacturer-specific and service data structures that lie inside one
+ * fragment point into it; only those that straddle a boundary are copied,
+ * into a 255-byte scratch buffer, which next() reuses. Other structures
+ * are skipped in place whichever fragments they cover.
+ *
+ * @code
+ * AdvFragment chain[] = {{aux_adv_data, aux_adv_len}, {aux_chain_data, aux_chain_len}};
+ * ADChainTokenizer tokens(chain, 2);
+ * ADField field;
+ * while (tokens.next(field)) {
+ *   // field is valid until the next call
+ * }
+ * @endcode
+ */
+class ADChainTokenizer {
+ public:
+  /**
+   * @param fragments Fragments in order (must outlive the tokenizer)
+   * @param count Number of fragments
+   */
+  ADChainTokenizer(const AdvFragment* fragments, uint8_t count);
+
+  ADChainTokenizer(const ADChainTokenizer&) = delete;
+  ADChainTokenizer& operator=(const ADChainTokenizer&) = delete;
+
+  /**
+   * @brief Find the next manufacturer-specific or service data structure
+   * @param field Set to the structure; its data stays valid until the next call
+   * @return false at the end of the data, a zero length byte or a structure
+   *         running past the last fragment
+   */
+  bool next(ADField& field);
+
+  /**
+   * @brief Structures that straddled a fragment boundary and were copied
+   */
+  uint16_t copies() const {
+    return copy_count;
+  }
+
+ private:
+  uint16_t advance(uint16_t n, uint8_t* out);
+
+  const AdvFragment* fragments;
+  uint8_t count;
+  uint8_t index;                           // Current fragment
+  uint16_t offset;                         // Next byte within the current fragment
+  uint16_t copy_count;
+  uint8_t scratch[AD_MAX_STRUCTURE_SIZE];  // Body of a straddling structure
+};
+
+#endif  // AD_STRUCTURES_H
@@ -1,13 +1,29 @@
 #include "BLEBeaconParser.h"
+#include "ADStructures.h"
+#include "BeaconPrefilter.h"
 #include "parsers/AltBeaconParser.h"
 #include "parsers/EddystoneParser.h"
 #include "parsers/iBeaconParser.h"
 
-// AD Structure types
-#define AD_TYPE_MANUFACTURER_SPECIFIC_DATA 0xFF
-#define AD_TYPE_SERVICE_DATA 0x16
+BLEBeaconParser::BLEBeaconParser() : cache(nullptr), url_cache(nullptr) {
+  dispatch.add<iBeaconParser>();
+  dispatch.add<AltBeaconParser>();
+  dispatch.add<EddystoneParser>();  // Handles UID, URL, and TLM internally
+}
+
+bool BLEBeaconParser::addFormat(const BeaconSignature& signature, BeaconDecodeFn decode) {
+  return dispatch.add(signature, decode);
+}
 
-bool BLEBeaconParser::parse(const uint8_t* data, uint8_t len, BeaconData& result) {
+void BLEBeaconParser::setCache(BeaconParseCache* parse_cache) {
+  cache = parse_cache;
+}
+
+void BLEBeaconParser::setURLCache(EddystoneURLCache* cache) {
+  url_cache = cache;
+}
+
+bool BLEBeaconParser::parse(const uint8_t* data, uint16_t len, BeaconData& result) {
   // Initialize result to unknown/invalid state
   result.type = BEACON_TYPE_UNKNOWN;
   result.valid = false;
@@ -17,37 +33,242 @@ bool BLEBeaconParser::parse(const uint8_t* data, uint8_t len, BeaconData& result
     return false;
   }
 
-  // Try each format parser in sequence
-  // Order matters: try more specific formats first
+  // Repeated packets are answered from the cache without decoding
+  const BeaconParseCache::Entry* entry = cachedEntry(data, len);
+  if (entry != nullptr) {
+    result = entry->result;
+    return entry->parsed;
+  }
+
+  ADField matched;
+  return decodePacket(data, len, result, matched);
+}
+
+bool BLEBeaconParser::decodePacket(const uint8_t* data, uint16_t len, BeaconData& result,
+                                   ADField& matched) const {
+  // Walk the AD structures once, dispatching each manufacturer or service
+  // data field on its (AD type, ID) key as it is found
+  ADTokenizer tokens(data, len);
+  ADField field;
+  while (tokens.next(field)) {
+    if (decodeField(field, result)) {
+      matched = field;
+      return true;
+    }
+  }
+
+  // No format matched
+  return false;
+}
+
+bool BLEBeaconParser::decodeField(const ADField& field, BeaconData& result) const {
+  // Eddystone is registered first for its key, so taking it ahead of the
+  // table only adds this parser's URL cache; custom formats still follow,
+  // without running the table's Eddystone decoder a second time
+  if (url_cache != nullptr && field.type == EddystoneParser::AD_TYPE &&
+      field.id == EddystoneParser::AD_ID) {
+    return EddystoneParser::decode(field, result, url_cache) ||
+           dispatch.decode(field, result, (BeaconDecodeFn)&EddystoneParser::decode);
+  }
+  return dispatch.decode(field, result);
+}
+
+const BeaconParseCache::Entry* BLEBeaconParser::cachedEntry(const uint8_t* data, uint16_t len) {
+  if (cache == nullptr || len > BEACON_PARSE_CACHE_PACKET_SIZE) {
+    return nullptr;
+  }
+
+  uint32_t hash = BeaconParseCache::hashPacket(data, len);
+  const BeaconParseCache::Entry* hit = cache->lookup(data, len, hash);
+  if (hit != nullptr) {
+    return hit;
+  }
+
+  // Miss: decode once and record both the result and where the matched
+  // field sits, so parseView() can re-point a view at identical bytes
+  BeaconParseCache::Entry* entry = cache->insert(data, len, hash);
+  ADField matched;
+
+  entry->result.type = BEACON_TYPE_UNKNOWN;
+  entry->result.valid = false;
+  entry->parsed = decodePacket(data, len, entry->result, matched);
+  entry->view_type = BEACON_TYPE_UNKNOWN;
+
+  if (entry->parsed) {
+    entry->view_type = dispatch.classify(matched);
+    entry->field_offset = matched.data - data;
+    entry->field_len = matched.len;
+    entry->field_type = matched.type;
+    entry->field_id = matched.id;
+  }
+
+  return entry;
+}
+
+bool BLEBeaconParser::parse(const uint8_t* data, uint16_t len, BeaconData& result,
+                            BeaconKey& key) {
+  bool parsed = parse(data, len, result);
+  key = BeaconKey::fromData(result);
+  return parsed;
+}
+
+bool BLEBeaconParser::parseChain(const AdvFragment* fragments, uint8_t count, BeaconData& result) {
+  result.type = BEACON_TYPE_UNKNOWN;
+  result.valid = false;
+
+  if (fragments == nullptr || count == 0) {
+    return false;
+  }
+  if (count == 1) {
+    return parse(fragments[0].data, fragments[0].len, result);
+  }
 
-  // Try iBeacon
-  if (iBeaconParser::canParse(data, len)) {
-    if (iBeaconParser::parse(data, len, result)) {
+  // Dispatch each field as it is found; a straddling field lives in the
+  // tokenizer's scratch buffer only until the next one is read
+  ADChainTokenizer tokens(fragments, count);
+  ADField field;
+  while (tokens.next(field)) {
+    if (decodeField(field, result)) {
       return true;
     }
   }
 
-  // Try AltBeacon
-  if (AltBeaconParser::canParse(data, len)) {
-    if (AltBeaconParser::parse(data, len, result)) {
+  return false;
+}
+
+bool BLEBeaconParser::parseView(const uint8_t* data, uint16_t len, BeaconView& view) {
+  view.clear();
+
+  if (data == nullptr || len == 0) {
+    return false;
+  }
+
+  // Cached packets only need the view re-pointed at the caller's bytes
+  const BeaconParseCache::Entry* entry = cachedEntry(data, len);
+  if (entry != nullptr) {
+    if (entry->view_type == BEACON_TYPE_UNKNOWN) {
+      return false;
+    }
+    ADField field = {entry->field_type, entry->field_id, &data[entry->field_offset],
+                     entry->field_len};
+    view.set((BeaconType)entry->view_type, field);
+    return true;
+  }
+
+  // Classification only checks signatures and lengths; nothing is decoded
+  ADTokenizer tokens(data, len);
+  ADField field;
+  while (tokens.next(field)) {
+    BeaconType type = dispatch.classify(field);
+    if (type != BEACON_TYPE_UNKNOWN) {
+      view.set(type, field);
       return true;
     }
   }
 
-  // Try Eddystone (handles UID, URL, and TLM internally)
-  if (EddystoneParser::canParse(data, len)) {
-    if (EddystoneParser::parse(data, len, result)) {
+  return false;
+}
+
+bool BLEBeaconParser::parse(const ScanObservation& observation, BeaconData& result) {
+  return parse(observation.payload, observation.payload_len, result);
+}
+
+bool BLEBeaconParser::parse(const ScanObservation& observation, BeaconData& result,
+                            BeaconKey& key) {
+  bool parsed = parse(observation, result);
+  key = BeaconKey::fromData(result);
+  return parsed;
+}
+
+bool BLEBeaconParser::parseView(const ScanObservation& observation, BeaconView& view) {
+  return parseView(observation.payload, observation.payload_len, view);
+}
+
+uint16_t BLEBeaconParser::parseBatch(const AdvPacket* packets, uint16_t count, BeaconBatch& batch) {
+  if (packets == nullptr) {
+    count = 0;
+  }
+  if (count > batch.capacity) {
+    count = batch.capacity;
+  }
+
+  uint16_t parsed = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    // Pull upcoming packet data into cache while this one is decoded
+    if (i + BEACON_BATCH_PREFETCH_DISTANCE < count) {
+      BEACON_PREFETCH(packets[i + BEACON_BATCH_PREFETCH_DISTANCE].data);
+    }
+
+    if (parseRow(packets[i].data, packets[i].len, batch, i)) {
+      parsed++;
+    }
+  }
+
+  batch.count = count;
+  return parsed;
+}
+
+uint16_t BLEBeaconParser::parseBatch(const uint8_t* buffer, const uint16_t* offsets,
+                                     uint16_t count, BeaconBatch& batch) {
+  if (buffer == nullptr || offsets == nullptr) {
+    count = 0;
+  }
+  if (count > batch.capacity) {
+    count = batch.capacity;
+  }
+
+  uint16_t parsed = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    if (i + BEACON_BATCH_PREFETCH_DISTANCE < count) {
+      BEACON_PREFETCH(&buffer[offsets[i + BEACON_BATCH_PREFETCH_DISTANCE]]);
+    }
+
+    uint16_t start = offsets[i];
+    uint16_t end = offsets[i + 1];
+
+    // Reject malformed offsets
+    if (end < start) {
+      batch.type[i] = BEACON_TYPE_UNKNOWN;
+      batch.valid[i] = false;
+      continue;
+    }
+
+    if (parseRow(&buffer[start], end - start, batch, i)) {
+      parsed++;
+    }
+  }
+
+  batch.count = count;
+  return parsed;
+}
+
+bool BLEBeaconParser::parseRow(const uint8_t* data, uint16_t len, BeaconBatch& batch,
+                               uint16_t row) const {
+  batch.type[row] = BEACON_TYPE_UNKNOWN;
+  batch.valid[row] = false;
+
+  // Vectorized signature scan rejects non-beacon traffic before tokenizing
+  if (BeaconPrefilter::scan(data, len) == 0) {
+    return false;
+  }
+
+  ADTokenizer tokens(data, len);
+  ADField field;
+  while (tokens.next(field)) {
+    if (dispatch.decodeColumns(field, batch, row)) {
+      batch.valid[row] = true;
       return true;
     }
   }
 
-  // No format matched
   return false;
 }
 
-bool BLEBeaconParser::findManufacturerData(const uint8_t* data, uint8_t len, uint16_t company_id,
+bool BLEBeaconParser::findManufacturerData(const uint8_t* data, uint16_t len, uint16_t company_id,
                                            const uint8_t*& out_data, uint8_t& out_len) {
-  uint8_t pos = 0;
+  uint16_t pos = 0;
 
   // Parse AD structures: [Length][Type][Data...]
   while (pos < len) {
@@ -68,8 +289,9 @@ bool BLEBeaconParser::findManufacturerData(const uint8_t* data, uint8_t len, uin
     // Check for Manufacturer Specific Data
     if (ad_type == AD_TYPE_MANUFACTURER_SPECIFIC_DATA) {
       // Manufacturer data starts at pos + 2
-      // First 2 bytes are Company ID (little-endian)
-      if (ad_len >= 2) {
+      // First 2 bytes are Company ID (little-endian); the type byte and
+      // both ID bytes must lie inside the structure
+      if (ad_len >= 3) {
         uint8_t company_id_low = data[pos + 2];
         uint8_t company_id_high = data[pos + 3];
         uint16_t found_company_id = (company_id_high << 8) | company_id_low;
@@ -91,9 +313,9 @@ bool BLEBeaconParser::findManufacturerData(const uint8_t* data, uint8_t len, uin
   return false;
 }
 
-bool BLEBeaconParser::findServiceData(const uint8_t* data, uint8_t len, uint16_t service_uuid,
+bool BLEBeaconParser::findServiceData(const uint8_t* data, uint16_t len, uint16_t service_uuid,
                                       const uint8_t*& out_data, uint8_t& out_len) {
-  uint8_t pos = 0;
+  uint16_t pos = 0;
 
   // Parse AD structures: [Length][Type][Data...]
   while (pos < len) {
@@ -114,8 +336,9 @@ bool BLEBeaconParser::findServiceData(const uint8_t* data, uint8_t len, uint16_t
     // Check for Service Data
     if (ad_type == AD_TYPE_SERVICE_DATA) {
       // Service data starts at pos + 2
-      // First 2 bytes are Service UUID (little-endian)
-      if (ad_len >= 2) {
+      // First 2 bytes are Service UUID (little-endian); the type byte and
+      // both UUID bytes must lie inside the structure
+      if (ad_len >= 3) {
         uint8_t uuid_low = data[pos + 2];
         uint8_t uuid_high = data[pos + 3];
         uint16_t found_uuid = (uuid_high << 8) | uuid_low;
@@ -137,9 +360,9 @@ bool BLEBeaconParser::findServiceData(const uint8_t* data, uint8_t len, uint16_t
   return false;
 }
 
-bool BLEBeaconParser::findADType(const uint8_t* data, uint8_t len, uint8_t ad_type,
+bool BLEBeaconParser::findADType(const uint8_t* data, uint16_t len, uint8_t ad_type,
                                  const uint8_t*& out_data, uint8_t& out_len) {
-  uint8_t pos = 0;
+  uint16_t pos = 0;
 
   // Parse AD structures: [Length][Type][Data...]
   while (pos < len) {
@@ -2,7 +2,14 @@
 #define BLE_BEACON_PARSER_H
 
 #include <stdint.h>
+#include "BeaconBatch.h"
 #include "BeaconData.h"
+#include "BeaconDispatch.h"
+#include "BeaconKey.h"
+#include "BeaconParseCache.h"
+#include "BeaconView.h"
+#include "ScanObservation.h"
+#include "parsers/EddystoneURL.h"
 
 /**
  * @brief Main BLE Beacon Parser class
@@ -24,7 +31,7 @@
  * if (parser.parse(adv_data, adv_len, result) && result.valid) {
  *   switch (result.type) {
  *     case BEACON_TYPE_IBEACON:
- *       Serial.println(result.getIBeacon().uuid);
+ *       Serial.println(result.getIBeacon().uuidString());
  *       break;
  *     // ... handle other types
  *   }
@@ -33,19 +40,186 @@
  */
 class BLEBeaconParser {
  public:
+  /**
+   * @brief Construct a parser with the built-in iBeacon, AltBeacon and
+   * Eddystone formats registered in its dispatch table
+   */
+  BLEBeaconParser();
+
+  /**
+   * @brief Register a custom beacon format
+   *
+   * The decoder is slotted into the same dispatch table as the built-in
+   * formats, so custom beacons are recognised in the single tokenizer pass
+   * made by parse(). It runs for fields matching the signature that no
+   * earlier-registered decoder accepted, and should fill result.custom and
+   * set result.type = BEACON_TYPE_CUSTOM and result.valid = true.
+   *
+   * Custom formats are decoded by parse() only; parseView() and parseBatch()
+   * report the built-in formats.
+   *
+   * @code
+   * static bool decodeSensorTag(const ADField& field, BeaconData& result) {
+   *   if (field.len < 4) return false;
+   *   memcpy(result.custom.data, &field.data[2], 2);
+   *   result.custom.len = 2;
+   *   result.custom.format = 1;
+   *   result.type = BEACON_TYPE_CUSTOM;
+   *   result.valid = true;
+   *   return true;
+   * }
+   *
+   * BeaconSignature sensor_tag = {AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x0059, {0xCA, 0xFE}, 2};
+   * parser.addFormat(sensor_tag, decodeSensorTag);
+   * @endcode
+   *
+   * @param signature AD type, company ID / service UUID and payload prefix to match
+   * @param decode Decoder for matching fields (field.data starts at the prefix)
+   * @return true if registered, false if the dispatch table is full or the prefix too long
+   */
+  bool addFormat(const BeaconSignature& signature, BeaconDecodeFn decode);
+
+  /**
+   * @brief Enable or disable the raw-payload parse cache
+   *
+   * With a cache set, parse() and parseView() return the stored result for
+   * a packet whose bytes match a cached one, without decoding it again.
+   * The cache stores results of this parser's registered formats; clear it
+   * after calling addFormat().
+   *
+   * @param parse_cache Cache to use, or nullptr to disable caching (default)
+   */
+  void setCache(BeaconParseCache* parse_cache);
+
+  /**
+   * @brief Enable or disable the Eddystone-URL cache
+   *
+   * With a cache set, this parser expands URL frames through it, so
+   * repeated encodings skip the expansion. The cache belongs to this
+   * parser only; give each parsing thread its own parser and cache.
+   *
+   * @param cache Cache to use, or nullptr to disable caching (default)
+   */
+  void setURLCache(EddystoneURLCache* cache);
+
   /**
    * @brief Parse beacon data from raw advertisement packet
    *
    * Automatically detects the beacon format and parses it into a unified
-   * BeaconData structure. Tries each format parser in sequence until one
-   * successfully parses the data.
+   * BeaconData structure. The AD structures are tokenized once, then the
+   * first field whose (AD type, company ID / service UUID) key has a
+   * registered decoder is dispatched straight to that decoder.
    *
    * @param data Raw advertisement packet data
    * @param len Length of advertisement data
    * @param result BeaconData structure to fill with parsed data
    * @return true if a beacon format was successfully parsed, false otherwise
    */
-  bool parse(const uint8_t* data, uint8_t len, BeaconData& result);
+  bool parse(const uint8_t* data, uint16_t len, BeaconData& result);
+
+  /**
+   * @brief Parse beacon data and build its identity key
+   *
+   * Same as parse(), additionally filling key with the canonical identity
+   * and its precomputed hash (empty for types without identity fields).
+   *
+   * @param data Raw advertisement packet data
+   * @param len Length of advertisement data
+   * @param result BeaconData structure to fill with parsed data
+   * @param key Identity key of the parsed beacon
+   * @return true if a beacon format was successfully parsed, false otherwise
+   */
+  bool parse(const uint8_t* data, uint16_t len, BeaconData& result, BeaconKey& key);
+
+  /**
+   * @brief Parse extended advertising data split over chained fragments
+   *
+   * Takes the data of an AUX_ADV_IND and its AUX_CHAIN_IND fragments (or of
+   * the HCI reports carrying them) as they were received, up to 1650 bytes
+   * in all. Fields are dispatched as ADChainTokenizer finds them; a field
+   * that straddles two fragments is copied into a scratch buffer, the rest
+   * are decoded in place. A single fragment is parsed like a contiguous
+   * packet, cache included.
+   *
+   * @code
+   * AdvFragment chain[] = {{aux_adv_data, aux_adv_len}, {aux_chain_data, aux_chain_len}};
+   * parser.parseChain(chain, 2, result);
+   * @endcode
+   *
+   * @param fragments Fragment buffers in chain order
+   * @param count Number of fragments
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if a beacon format was successfully parsed, false otherwise
+   */
+  bool parseChain(const AdvFragment* fragments, uint8_t count, BeaconData& result);
+
+  /**
+   * @brief Classify a packet without decoding it
+   *
+   * Locates the first field that a registered format accepts and records
+   * its type and position in a BeaconView; no fields are copied or
+   * converted until the view's accessors are called. The view points into
+   * data, which must outlive it.
+   *
+   * @param data Raw advertisement packet data
+   * @param len Length of advertisement data
+   * @param view View to point at the beacon (cleared on failure)
+   * @return true if a beacon format was recognised
+   */
+  bool parseView(const uint8_t* data, uint16_t len, BeaconView& view);
+
+  /**
+   * @brief Parse the payload of a scan observation
+   *
+   * The observation's metadata (address, RSSI, timestamp) is left for the
+   * caller to pass on with the result, e.g. to BeaconTracker::update().
+   *
+   * @param observation Received advertisement and its metadata
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if a beacon format was successfully parsed, false otherwise
+   */
+  bool parse(const ScanObservation& observation, BeaconData& result);
+
+  /**
+   * @brief Parse the payload of a scan observation and build its identity key
+   */
+  bool parse(const ScanObservation& observation, BeaconData& result, BeaconKey& key);
+
+  /**
+   * @brief Classify the payload of a scan observation without decoding it
+   */
+  bool parseView(const ScanObservation& observation, BeaconView& view);
+
+  /**
+   * @brief Parse a batch of advertisement packets into structure-of-arrays columns
+   *
+   * Decodes identity fields straight into the caller's BeaconBatch columns
+   * without building a BeaconData record per packet.
+   * Packets are first screened by BeaconPrefilter, so only packets carrying
+   * a built-in beacon signature are tokenized and decoded. Upcoming packets
+   * are prefetched while the current one is decoded.
+   *
+   * @param packets Array of pointer/length pairs
+   * @param count Number of packets (clamped to batch.capacity)
+   * @param batch Caller-owned output columns; batch.count is set to the rows written
+   * @return Number of packets that parsed as beacons
+   */
+  uint16_t parseBatch(const AdvPacket* packets, uint16_t count, BeaconBatch& batch);
+
+  /**
+   * @brief Parse a batch of packets stored back-to-back in one buffer
+   *
+   * Packet i occupies buffer[offsets[i]] up to (not including) buffer[offsets[i + 1]].
+   * Descending offsets mark the packet invalid.
+   *
+   * @param buffer Packed advertisement data
+   * @param offsets count + 1 ascending offsets into buffer
+   * @param count Number of packets (clamped to batch.capacity)
+   * @param batch Caller-owned output columns; batch.count is set to the rows written
+   * @return Number of packets that parsed as beacons
+   */
+  uint16_t parseBatch(const uint8_t* buffer, const uint16_t* offsets, uint16_t count,
+                      BeaconBatch& batch);
 
   /**
    * @brief Find manufacturer-specific data by company ID
@@ -60,7 +234,7 @@ class BLEBeaconParser {
    * @param out_len Output length of manufacturer data
    * @return true if manufacturer data was found
    */
-  static bool findManufacturerData(const uint8_t* data, uint8_t len, uint16_t company_id,
+  static bool findManufacturerData(const uint8_t* data, uint16_t len, uint16_t company_id,
                                    const uint8_t*& out_data, uint8_t& out_len);
 
   /**
@@ -76,7 +250,7 @@ class BLEBeaconParser {
    * @param out_len Output length of service data
    * @return true if service data was found
    */
-  static bool findServiceData(const uint8_t* data, uint8_t len, uint16_t service_uuid,
+  static bool findServiceData(const uint8_t* data, uint16_t len, uint16_t service_uuid,
                               const uint8_t*& out_data, uint8_t& out_len);
 
  private:
@@ -92,8 +266,36 @@ class BLEBeaconParser {
    * @param out_len Output length of AD data
    * @return true if AD type was found
    */
-  static bool findADType(const uint8_t* data, uint8_t len, uint8_t ad_type,
+  static bool findADType(const uint8_t* data, uint16_t len, uint8_t ad_type,
                          const uint8_t*& out_data, uint8_t& out_len);
+
+  /**
+   * @brief Tokenize and dispatch one packet
+   * @param matched Set to the field that was decoded when parsing succeeds
+   * @return true if a registered decoder parsed a field
+   */
+  bool decodePacket(const uint8_t* data, uint16_t len, BeaconData& result, ADField& matched) const;
+
+  /**
+   * @brief Decode one field, through the URL cache for Eddystone fields
+   */
+  bool decodeField(const ADField& field, BeaconData& result) const;
+
+  /**
+   * @brief Find or create the cache entry for a packet
+   * @return Entry holding the packet's parse result, or nullptr if the packet is not cacheable
+   */
+  const BeaconParseCache::Entry* cachedEntry(const uint8_t* data, uint16_t len);
+
+  /**
+   * @brief Parse one packet into row of a batch
+   * @return true if the packet parsed as a beacon
+   */
+  bool parseRow(const uint8_t* data, uint16_t len, BeaconBatch& batch, uint16_t row) const;
+
+  BeaconDispatch dispatch;
+  BeaconParseCache* cache;
+  EddystoneURLCache* url_cache;
 };
 
 #endif  // BLE_BEACON_PARSER_H
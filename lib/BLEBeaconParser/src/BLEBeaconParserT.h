@@ -0,0 +1,193 @@
+#ifndef BLE_BEACON_PARSER_T_H
+#define BLE_BEACON_PARSER_T_H
+
+#include <stdint.h>
+#include "ADStructures.h"
+#include "BeaconBatch.h"
+#include "BeaconData.h"
+#include "BeaconView.h"
+#include "parsers/AltBeaconParser.h"
+#include "parsers/EddystoneParser.h"
+#include "parsers/iBeaconParser.h"
+
+/**
+ * @brief Compile-time list of format parsers
+ *
+ * Each step compares the field's (AD type, ID) key against the parser's
+ * AD_TYPE / AD_ID constants and falls through to the rest of the list, so
+ * the whole chain inlines into a few compares and direct calls.
+ */
+template <class... Parsers>
+struct BeaconFormatList;
+
+template <>
+struct BeaconFormatList<> {
+  static bool decode(const ADField&, BeaconData&) {
+    return false;
+  }
+
+  static bool decodeColumns(const ADField&, BeaconBatch&, uint16_t) {
+    return false;
+  }
+
+  static BeaconType classify(const ADField&) {
+    return BEACON_TYPE_UNKNOWN;
+  }
+};
+
+template <class Parser, class... Rest>
+struct BeaconFormatList<Parser, Rest...> {
+  static bool matches(const ADField& field) {
+    return field.type == Parser::AD_TYPE && field.id == Parser::AD_ID;
+  }
+
+  static bool decode(const ADField& field, BeaconData& result) {
+    if (matches(field) && Parser::decode(field, result)) {
+      return true;
+    }
+    return BeaconFormatList<Rest...>::decode(field, result);
+  }
+
+  static bool decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row) {
+    if (matches(field) && Parser::decodeColumns(field, batch, row)) {
+      return true;
+    }
+    return BeaconFormatList<Rest...>::decodeColumns(field, batch, row);
+  }
+
+  static BeaconType classify(const ADField& field) {
+    if (matches(field)) {
+      BeaconType type = Parser::classify(field);
+      if (type != BEACON_TYPE_UNKNOWN) {
+        return type;
+      }
+    }
+    return BeaconFormatList<Rest...>::classify(field);
+  }
+};
+
+/**
+ * @brief BLE beacon parser composed from a fixed set of formats at compile time
+ *
+ * Same parsing behaviour as BLEBeaconParser, but the formats are template
+ * arguments instead of runtime dispatch table entries: dispatch inlines
+ * completely, and parsers that are not listed are never referenced, so the
+ * linker drops them from the firmware.
+ *
+ * Formats are tried in the listed order for each AD field. BLEBeaconParser
+ * remains the all-formats parser with runtime registration.
+ *
+ * Usage:
+ * @code
+ * BLEBeaconParserT<iBeaconParser> parser;  // iBeacon-only scanner
+ * BeaconData result;
+ *
+ * if (parser.parse(adv_data, adv_len, result)) {
+ *   Serial.println(result.getIBeacon().major);
+ * }
+ * @endcode
+ */
+template <class... Parsers>
+class BLEBeaconParserT {
+ public:
+  typedef BeaconFormatList<Parsers...> Formats;
+
+  /**
+   * @brief Parse beacon data from raw advertisement packet
+   * @param data Raw advertisement packet data
+   * @param len Length of advertisement data
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if one of the composed formats was successfully parsed
+   */
+  bool parse(const uint8_t* data, uint16_t len, BeaconData& result) const {
+    result.type = BEACON_TYPE_UNKNOWN;
+    result.valid = false;
+
+    if (data == nullptr || len == 0) {
+      return false;
+    }
+
+    ADTokenizer tokens(data, len);
+    ADField field;
+    while (tokens.next(field)) {
+      if (Formats::decode(field, result)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Classify a packet without decoding it (see BLEBeaconParser::parseView)
+   * @param data Raw advertisement packet data
+   * @param len Length of advertisement data
+   * @param view View to point at the beacon (cleared on failure)
+   * @return true if one of the composed formats was recognised
+   */
+  bool parseView(const uint8_t* data, uint16_t len, BeaconView& view) const {
+    view.clear();
+
+    if (data == nullptr || len == 0) {
+      return false;
+    }
+
+    ADTokenizer tokens(data, len);
+    ADField field;
+    while (tokens.next(field)) {
+      BeaconType type = Formats::classify(field);
+      if (type != BEACON_TYPE_UNKNOWN) {
+        view.set(type, field);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Parse a batch of advertisement packets into structure-of-arrays columns
+   *
+   * See BLEBeaconParser::parseBatch. No prefilter is run: the composed
+   * formats are checked directly on each tokenized packet.
+   *
+   * @param packets Array of pointer/length pairs
+   * @param count Number of packets (clamped to batch.capacity)
+   * @param batch Caller-owned output columns; batch.count is set to the rows written
+   * @return Number of packets that parsed as beacons
+   */
+  uint16_t parseBatch(const AdvPacket* packets, uint16_t count, BeaconBatch& batch) const {
+    if (packets == nullptr) {
+      count = 0;
+    }
+    if (count > batch.capacity) {
+      count = batch.capacity;
+    }
+
+    uint16_t parsed = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+      if (i + BEACON_BATCH_PREFETCH_DISTANCE < count) {
+        BEACON_PREFETCH(packets[i + BEACON_BATCH_PREFETCH_DISTANCE].data);
+      }
+
+      batch.type[i] = BEACON_TYPE_UNKNOWN;
+      batch.valid[i] = false;
+
+      ADTokenizer tokens(packets[i].data, packets[i].len);
+      ADField field;
+      while (tokens.next(field)) {
+        if (Formats::decodeColumns(field, batch, i)) {
+          batch.valid[i] = true;
+          parsed++;
+          break;
+        }
+      }
+    }
+
+    batch.count = count;
+    return parsed;
+  }
+};
+
+#endif  // BLE_BEACON_PARSER_T_H
@@ -0,0 +1,258 @@
+#include "BeaconAggregator.h"
+#include <string.h>
+
+#define AGGREGATOR_LIVE 0x01
+#define AGGREGATOR_HAS_TLM 0x02
+
+// Saturation value for pane counters
+#define AGGREGATOR_COUNT_MAX 0xFFFF
+
+BeaconAggregator::BeaconAggregator(Pane* pane_storage, uint8_t panes_per_window,
+                                   BeaconKey* key_storage, EddystoneTLMData* tlm_storage,
+                                   uint8_t* flag_storage, uint16_t* free_storage,
+                                   IndexEntry* index_storage, uint16_t capacity, uint32_t window)
+    : panes(pane_storage),
+      keys(key_storage),
+      tlm(tlm_storage),
+      flags(flag_storage),
+      free_slots(free_storage),
+      index(index_storage),
+      handler(nullptr),
+      context(nullptr),
+      pane_length(window / panes_per_window > 0 ? window / panes_per_window : 1),
+      pane_start(0),
+      overflow_count(0),
+      slot_count(capacity),
+      index_mask((uint16_t)(2 * capacity - 1)),
+      free_count(0),
+      live_count(0),
+      pane_count(panes_per_window),
+      current_pane(0),
+      filled_panes(0),
+      started(false) {}
+
+void BeaconAggregator::clear() {
+  for (uint8_t p = 0; p < pane_count; p++) {
+    clearPane(p);
+  }
+
+  memset(flags, 0, slot_count);
+  memset(index, 0, sizeof(IndexEntry) * (index_mask + 1));
+
+  // Hand out low slots first
+  for (uint16_t i = 0; i < slot_count; i++) {
+    free_slots[i] = slot_count - 1 - i;
+  }
+  free_count = slot_count;
+  live_count = 0;
+  overflow_count = 0;
+  current_pane = 0;
+  filled_panes = 0;
+  started = false;
+}
+
+bool BeaconAggregator::update(const BeaconKey& key, const BeaconData& data, int8_t rssi,
+                              uint32_t now) {
+  if (!key.valid()) {
+    return false;
+  }
+
+  advance(now);
+
+  int32_t found = findSlot(key);
+  uint16_t slot;
+  if (found >= 0) {
+    slot = (uint16_t)found;
+  } else {
+    if (free_count == 0) {
+      overflow_count++;
+      return false;
+    }
+    slot = free_slots[--free_count];
+    keys[slot] = key;
+    flags[slot] = AGGREGATOR_LIVE;
+    live_count++;
+    indexInsert(slot);
+  }
+
+  Pane& pane = panes[current_pane];
+  if (pane.count[slot] != AGGREGATOR_COUNT_MAX) {
+    uint8_t bin = rssi < 0 ? (uint8_t)((rssi + 128) / BEACON_AGGREGATOR_BIN_DB)
+                           : BEACON_AGGREGATOR_BINS - 1;
+    pane.count[slot]++;
+    pane.rssi_sum[slot] += rssi;
+    pane.histogram[slot][bin]++;
+    if (rssi < pane.rssi_min[slot]) {
+      pane.rssi_min[slot] = rssi;
+    }
+    if (rssi > pane.rssi_max[slot]) {
+      pane.rssi_max[slot] = rssi;
+    }
+  }
+
+  if (data.valid && data.type == BEACON_TYPE_EDDYSTONE_TLM) {
+    tlm[slot] = data.eddystone_tlm;
+    flags[slot] |= AGGREGATOR_HAS_TLM;
+  }
+
+  return true;
+}
+
+void BeaconAggregator::advance(uint32_t now) {
+  if (!started) {
+    pane_start = now - now % pane_length;
+    filled_panes = 1;
+    started = true;
+    return;
+  }
+
+  // A late packet (e.g. from a slower scanner) is counted in the current
+  // pane; time running backwards never closes panes
+  if ((int32_t)(now - pane_start) < 0) {
+    return;
+  }
+
+  while ((uint32_t)(now - pane_start) >= pane_length) {
+    if (live_count == 0) {
+      // Nothing left to summarise: skip straight to the pane holding now
+      pane_start = now - now % pane_length;
+      filled_panes = 1;
+      break;
+    }
+    closePane();
+  }
+}
+
+static int8_t quantile(const uint32_t* histogram, uint32_t count, uint8_t percent, int8_t low,
+                       int8_t high) {
+  uint32_t target = (count * percent + 99) / 100;
+  if (target == 0) {
+    target = 1;
+  }
+
+  uint32_t seen = 0;
+  for (uint8_t bin = 0; bin < BEACON_AGGREGATOR_BINS; bin++) {
+    seen += histogram[bin];
+    if (seen >= target) {
+      // Bin midpoint, clamped to the exact extremes
+      int16_t value = -128 + bin * BEACON_AGGREGATOR_BIN_DB + BEACON_AGGREGATOR_BIN_DB / 2;
+      if (value < low) {
+        return low;
+      }
+      return value > high ? high : (int8_t)value;
+    }
+  }
+  return high;
+}
+
+void BeaconAggregator::closePane() {
+  // Pane that drops out of the window (still empty until the window fills)
+  uint8_t oldest = (current_pane + 1) % pane_count;
+  uint16_t freed = 0;
+
+  BeaconSummary summary;
+  summary.window_end = pane_start + pane_length;
+  summary.window_start = summary.window_end - filled_panes * pane_length;
+
+  for (uint16_t slot = 0; slot < slot_count; slot++) {
+    if (!(flags[slot] & AGGREGATOR_LIVE)) {
+      continue;
+    }
+
+    uint32_t count = 0;
+    int32_t sum = 0;
+    int8_t low = 127;
+    int8_t high = -128;
+    uint32_t histogram[BEACON_AGGREGATOR_BINS] = {0};
+
+    for (uint8_t p = 0; p < pane_count; p++) {
+      const Pane& pane = panes[p];
+      count += pane.count[slot];
+      sum += pane.rssi_sum[slot];
+      low = pane.rssi_min[slot] < low ? pane.rssi_min[slot] : low;
+      high = pane.rssi_max[slot] > high ? pane.rssi_max[slot] : high;
+
+      // Fixed-length widening add; vectorized by the compiler
+      const uint16_t* bins = pane.histogram[slot];
+      for (uint8_t bin = 0; bin < BEACON_AGGREGATOR_BINS; bin++) {
+        histogram[bin] += bins[bin];
+      }
+    }
+
+    if (count > 0 && handler != nullptr) {
+      summary.key = keys[slot];
+      summary.count = count;
+      summary.rssi_min = low;
+      summary.rssi_max = high;
+      summary.rssi_mean = (float)sum / count;
+      summary.rssi_p10 = quantile(histogram, count, 10, low, high);
+      summary.rssi_p50 = quantile(histogram, count, 50, low, high);
+      summary.rssi_p90 = quantile(histogram, count, 90, low, high);
+      summary.has_tlm = (flags[slot] & AGGREGATOR_HAS_TLM) != 0;
+      if (summary.has_tlm) {
+        summary.tlm = tlm[slot];
+      }
+      handler(summary, context);
+    }
+
+    // Beacons with nothing left once the oldest pane drops out are freed
+    if (count == panes[oldest].count[slot]) {
+      flags[slot] = 0;
+      free_slots[free_count++] = slot;
+      live_count--;
+      freed++;
+    }
+  }
+
+  clearPane(oldest);
+  current_pane = oldest;
+  pane_start += pane_length;
+  if (filled_panes < pane_count) {
+    filled_panes++;
+  }
+
+  // The index has no deletion; rebuild it from the remaining beacons
+  if (freed > 0) {
+    memset(index, 0, sizeof(IndexEntry) * (index_mask + 1));
+    for (uint16_t slot = 0; slot < slot_count; slot++) {
+      if (flags[slot] & AGGREGATOR_LIVE) {
+        indexInsert(slot);
+      }
+    }
+  }
+}
+
+void BeaconAggregator::clearPane(uint8_t pane) {
+  Pane& columns = panes[pane];
+  memset(columns.count, 0, sizeof(uint16_t) * slot_count);
+  memset(columns.rssi_sum, 0, sizeof(int32_t) * slot_count);
+  memset(columns.rssi_min, 127, slot_count);
+  memset(columns.rssi_max, 0x80, slot_count);
+  memset(columns.histogram, 0, sizeof(uint16_t) * BEACON_AGGREGATOR_BINS * slot_count);
+}
+
+int32_t BeaconAggregator::findSlot(const BeaconKey& key) const {
+  uint16_t tag = (uint16_t)(key.hash >> 48);
+  uint16_t pos = (uint16_t)key.hash & index_mask;
+
+  while (index[pos].slot != 0) {
+    uint16_t slot = index[pos].slot - 1;
+    if (index[pos].tag == tag && keys[slot] == key) {
+      return slot;
+    }
+    pos = (pos + 1) & index_mask;
+  }
+  return -1;
+}
+
+void BeaconAggregator::indexInsert(uint16_t slot) {
+  uint64_t hash = keys[slot].hash;
+  uint16_t pos = (uint16_t)hash & index_mask;
+
+  // At most half full, so an empty entry is always found
+  while (index[pos].slot != 0) {
+    pos = (pos + 1) & index_mask;
+  }
+  index[pos].slot = slot + 1;
+  index[pos].tag = (uint16_t)(hash >> 48);
+}
@@ -0,0 +1,232 @@
+#ifndef BEACON_AGGREGATOR_H
+#define BEACON_AGGREGATOR_H
+
+#include <stdint.h>
+#include "BeaconData.h"
+#include "BeaconKey.h"
+#include "ScanObservation.h"
+
+// RSSI sketch: BEACON_AGGREGATOR_BINS histogram bins of BEACON_AGGREGATOR_BIN_DB
+// dB each, covering -128 to -1 dBm (non-negative readings go to the top bin)
+#define BEACON_AGGREGATOR_BINS 32
+#define BEACON_AGGREGATOR_BIN_DB 4
+
+/**
+ * @brief One beacon's statistics over one closed window
+ */
+struct BeaconSummary {
+  BeaconKey key;
+  uint32_t window_start;  // First time covered by the window
+  uint32_t window_end;    // First time after the window
+  uint32_t count;         // Packets in the window
+  int8_t rssi_min;
+  int8_t rssi_max;
+  int8_t rssi_p10;        // RSSI quantiles estimated from the sketch
+  int8_t rssi_p50;
+  int8_t rssi_p90;
+  bool has_tlm;           // tlm holds the latest Eddystone-TLM seen for the beacon
+  float rssi_mean;
+  EddystoneTLMData tlm;
+};
+
+/**
+ * @brief Called for each beacon with packets in a window that just closed
+ */
+typedef void (*BeaconSummaryHandler)(const BeaconSummary& summary, void* context);
+
+/**
+ * @brief Per-beacon statistics over tumbling or sliding windows
+ *
+ * Downsamples a packet stream to one BeaconSummary per beacon per window:
+ * packet count, min / max / mean RSSI, RSSI quantiles and the latest TLM
+ * snapshot. Quantiles come from a fixed 32-bin RSSI histogram, so memory
+ * per beacon is fixed and update() is O(1).
+ *
+ * Time is split into panes of window / panes. With one pane the windows
+ * tumble; with P panes a window covering the last P panes closes every
+ * pane, giving sliding windows that overlap by P - 1 panes. Statistics are
+ * stored column-wise per pane, so closing a pane merges and clears whole
+ * columns in loops the compiler vectorizes.
+ *
+ * Windows close when update() or advance() sees a time at or past the end
+ * of the current pane. Beacons without packets in any live pane are
+ * dropped at that point. Packets timed before the current pane (as when
+ * several scanners feed one aggregator) are counted in it. Storage is
+ * provided by BeaconAggregatorBuffer.
+ *
+ * Usage:
+ * @code
+ * static BeaconAggregatorBuffer<512, 1> aggregator(10000);  // 10 s tumbling windows
+ *
+ * void on_summary(const BeaconSummary& summary, void* context) {
+ *   // Uplink summary
+ * }
+ *
+ * aggregator.setHandler(on_summary, nullptr);
+ * if (parser.parse(data, len, result, key)) {
+ *   aggregator.update(key, result, rssi, millis());
+ * }
+ * aggregator.advance(millis());
+ * @endcode
+ */
+class BeaconAggregator {
+ public:
+  /**
+   * @brief Set the callback that receives closed-window summaries
+   */
+  void setHandler(BeaconSummaryHandler summary_handler, void* summary_context) {
+    handler = summary_handler;
+    context = summary_context;
+  }
+
+  /**
+   * @brief Add a packet to its beacon's current pane
+   *
+   * Closes any windows that ended at or before now first; a packet older
+   * than the current pane is counted in it. Eddystone-TLM
+   * frames carry no identity; pass the key of the beacon they belong to.
+   *
+   * @return true if counted, false if the key is empty or the table is full
+   */
+  bool update(const BeaconKey& key, const BeaconData& data, int8_t rssi, uint32_t now);
+
+  /**
+   * @brief Add a packet using the observation's RSSI and time (in milliseconds)
+   */
+  bool update(const BeaconKey& key, const BeaconData& data, const ScanObservation& observation) {
+    return update(key, data, observation.rssi, observation.timestampMs());
+  }
+
+  /**
+   * @brief Close every window that ended at or before now
+   */
+  void advance(uint32_t now);
+
+  /**
+   * @brief Drop all beacons and statistics
+   */
+  void clear();
+
+  uint16_t size() const {
+    return live_count;
+  }
+
+  uint16_t capacity() const {
+    return slot_count;
+  }
+
+  /**
+   * @brief Packets dropped because the table was full
+   */
+  uint32_t overflows() const {
+    return overflow_count;
+  }
+
+  /**
+   * @brief Column storage for one pane
+   */
+  struct Pane {
+    uint16_t* count;
+    int32_t* rssi_sum;
+    int8_t* rssi_min;
+    int8_t* rssi_max;
+    uint16_t (*histogram)[BEACON_AGGREGATOR_BINS];
+  };
+
+  /**
+   * @brief Hash index entry (slot + 1, 0 for empty)
+   */
+  struct IndexEntry {
+    uint16_t slot;
+    uint16_t tag;
+  };
+
+ protected:
+  /**
+   * @param pane_storage Array of panes_per_window panes, each with capacity rows
+   * @param panes_per_window Panes per window (1 for tumbling windows)
+   * @param key_storage Array of capacity keys
+   * @param tlm_storage Array of capacity TLM snapshots
+   * @param flag_storage Array of capacity bytes
+   * @param free_storage Array of capacity slot numbers
+   * @param index_storage Array of 2 * capacity index entries
+   * @param capacity Number of beacons (power of two, at most 32768)
+   * @param window Window length, in the caller's time unit
+   */
+  BeaconAggregator(Pane* pane_storage, uint8_t panes_per_window, BeaconKey* key_storage,
+                   EddystoneTLMData* tlm_storage, uint8_t* flag_storage, uint16_t* free_storage,
+                   IndexEntry* index_storage, uint16_t capacity, uint32_t window);
+
+  // Columns live in the derived storage, so the aggregator must not be copied
+  BeaconAggregator(const BeaconAggregator&) = delete;
+  BeaconAggregator& operator=(const BeaconAggregator&) = delete;
+
+ private:
+  int32_t findSlot(const BeaconKey& key) const;
+  void indexInsert(uint16_t slot);
+  void clearPane(uint8_t pane);
+  void closePane();
+
+  Pane* panes;
+  BeaconKey* keys;
+  EddystoneTLMData* tlm;
+  uint8_t* flags;
+  uint16_t* free_slots;
+  IndexEntry* index;
+  BeaconSummaryHandler handler;
+  void* context;
+  uint32_t pane_length;
+  uint32_t pane_start;
+  uint32_t overflow_count;
+  uint16_t slot_count;
+  uint16_t index_mask;
+  uint16_t free_count;
+  uint16_t live_count;
+  uint8_t pane_count;
+  uint8_t current_pane;
+  uint8_t filled_panes;  // Panes since the first packet, up to pane_count
+  bool started;
+};
+
+/**
+ * @brief BeaconAggregator with inline storage for N beacons and P panes per window
+ */
+template <uint16_t N, uint8_t P = 1>
+class BeaconAggregatorBuffer : public BeaconAggregator {
+  static_assert(N >= 2 && N <= 32768 && (N & (N - 1)) == 0,
+                "Aggregator capacity must be a power of two between 2 and 32768");
+  static_assert(P >= 1, "At least one pane per window");
+
+ public:
+  /**
+   * @param window Window length (e.g. milliseconds); a new window closes every window / P
+   */
+  explicit BeaconAggregatorBuffer(uint32_t window)
+      : BeaconAggregator(pane_storage, P, key_storage, tlm_storage, flag_storage, free_storage,
+                         index_storage, N, window) {
+    for (uint8_t p = 0; p < P; p++) {
+      pane_storage[p].count = count_column[p];
+      pane_storage[p].rssi_sum = sum_column[p];
+      pane_storage[p].rssi_min = min_column[p];
+      pane_storage[p].rssi_max = max_column[p];
+      pane_storage[p].histogram = histogram_column[p];
+    }
+    // Storage is constructed after the base class, so empty it here
+    clear();
+  }
+
+ private:
+  Pane pane_storage[P];
+  uint16_t count_column[P][N];
+  int32_t sum_column[P][N];
+  int8_t min_column[P][N];
+  int8_t max_column[P][N];
+  uint16_t histogram_column[P][N][BEACON_AGGREGATOR_BINS];
+  BeaconKey key_storage[N];
+  EddystoneTLMData tlm_storage[N];
+  uint8_t flag_storage[N];
+  uint16_t free_storage[N];
+  IndexEntry index_storage[2 * N];
+};
+
+#endif  // BEACON_AGGREGATOR_H
@@ -0,0 +1,89 @@
+#ifndef BEACON_BATCH_H
+#define BEACON_BATCH_H
+
+#include <stdint.h>
+
+// Width of the identity column: iBeacon UUID, AltBeacon ID, or
+// Eddystone-UID namespace (10 bytes) followed by instance (6 bytes)
+#define BEACON_BATCH_ID_LENGTH 16
+
+// How many packets ahead parseBatch prefetches
+#define BEACON_BATCH_PREFETCH_DISTANCE 2
+
+// Prefetch hint for the next packets in a batch
+#if defined(__GNUC__)
+#define BEACON_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define BEACON_PREFETCH(addr) ((void)0)
+#endif
+
+/**
+ * @brief One raw advertisement in a batch
+ */
+struct AdvPacket {
+  const uint8_t* data;  // Raw advertisement data
+  uint16_t len;         // Length of advertisement data (up to 1650 bytes extended)
+};
+
+/**
+ * @brief Structure-of-arrays output of BLEBeaconParser::parseBatch
+ *
+ * Each column holds one entry per input packet. The columns are owned by
+ * the caller; use BeaconBatchBuffer for fixed-capacity inline storage.
+ *
+ * Column contents per type:
+ * - iBeacon: id = UUID, major, minor, tx_power
+ * - AltBeacon: id = beacon ID, major, minor, tx_power = reference RSSI
+ * - Eddystone-UID: id = namespace + instance, tx_power
+ * - Eddystone-URL: tx_power (id zeroed)
+ * - Eddystone-TLM: type only (id zeroed)
+ *
+ * id, major, minor and tx_power are only meaningful where valid is true.
+ */
+struct BeaconBatch {
+  uint8_t* type;                          // BeaconType per packet
+  bool* valid;                            // true if the packet parsed as a beacon
+  uint8_t (*id)[BEACON_BATCH_ID_LENGTH];  // Identity bytes
+  uint16_t* major;                        // Major (0 where the format has none)
+  uint16_t* minor;                        // Minor (0 where the format has none)
+  int8_t* tx_power;                       // TX power / reference RSSI
+  uint16_t capacity;                      // Number of rows each column can hold
+  uint16_t count;                         // Number of rows written by the last parseBatch
+};
+
+/**
+ * @brief BeaconBatch with inline column storage for N packets
+ *
+ * @code
+ * static BeaconBatchBuffer<256> batch;
+ * parser.parseBatch(packets, packet_count, batch);
+ * @endcode
+ */
+template <uint16_t N>
+class BeaconBatchBuffer : public BeaconBatch {
+ public:
+  BeaconBatchBuffer() {
+    type = type_column;
+    valid = valid_column;
+    id = id_column;
+    major = major_column;
+    minor = minor_column;
+    tx_power = tx_power_column;
+    capacity = N;
+    count = 0;
+  }
+
+  // Columns point into this object, so it must not be copied
+  BeaconBatchBuffer(const BeaconBatchBuffer&) = delete;
+  BeaconBatchBuffer& operator=(const BeaconBatchBuffer&) = delete;
+
+ private:
+  uint8_t type_column[N];
+  bool valid_column[N];
+  uint8_t id_column[N][BEACON_BATCH_ID_LENGTH];
+  uint16_t major_column[N];
+  uint16_t minor_column[N];
+  int8_t tx_power_column[N];
+};
+
+#endif  // BEACON_BATCH_H
@@ -0,0 +1,298 @@
+#include "BeaconCapture.h"
+#include <string.h>
+
+static void writeU16(uint8_t* out, uint16_t value) {
+  out[0] = value & 0xFF;
+  out[1] = value >> 8;
+}
+
+static uint16_t readU16(const uint8_t* data) {
+  return (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+}
+
+static uint64_t readU64(const uint8_t* data) {
+  uint64_t value = 0;
+  for (uint8_t i = 8; i > 0; i--) {
+    value = (value << 8) | data[i - 1];
+  }
+  return value;
+}
+
+// Record size for a header size read from the file
+static size_t paddedSize(uint16_t header_size, uint16_t payload_len) {
+  size_t size = (size_t)header_size + payload_len;
+  return (size + BEACON_CAPTURE_ALIGNMENT - 1) & ~(size_t)(BEACON_CAPTURE_ALIGNMENT - 1);
+}
+
+void BeaconCapture::encodeFileHeader(uint8_t* out) {
+  memset(out, 0, BEACON_CAPTURE_FILE_HEADER_SIZE);
+  memcpy(out, BEACON_CAPTURE_MAGIC, 4);
+  writeU16(&out[4], BEACON_CAPTURE_VERSION);
+  writeU16(&out[6], BEACON_CAPTURE_RECORD_HEADER_SIZE);
+}
+
+uint16_t BeaconCapture::checkFileHeader(const uint8_t* data, size_t len) {
+  if (len < BEACON_CAPTURE_FILE_HEADER_SIZE || memcmp(data, BEACON_CAPTURE_MAGIC, 4) != 0 ||
+      readU16(&data[4]) != BEACON_CAPTURE_VERSION) {
+    return 0;
+  }
+
+  // Later versions may only grow the record header, in aligned steps
+  uint16_t header_size = readU16(&data[6]);
+  if (header_size < BEACON_CAPTURE_RECORD_HEADER_SIZE ||
+      header_size % BEACON_CAPTURE_ALIGNMENT != 0) {
+    return 0;
+  }
+  return header_size;
+}
+
+uint32_t BeaconCapture::encodeRecord(const ScanObservation& observation, uint8_t* out) {
+  uint32_t size = recordSize(observation.payload_len);
+
+  uint64_t timestamp = observation.timestamp_us;
+  for (uint8_t i = 0; i < 8; i++) {
+    out[i] = timestamp & 0xFF;
+    timestamp >>= 8;
+  }
+  writeU16(&out[8], observation.payload_len);
+  memcpy(&out[10], observation.address, 6);
+  out[16] = observation.address_type;
+  out[17] = (uint8_t)observation.rssi;
+  out[18] = observation.channel;
+  out[19] = (uint8_t)observation.tx_power;
+  out[20] = observation.flags;
+
+  // Reserved bytes and padding are zero so captures are reproducible
+  uint32_t payload_end = BEACON_CAPTURE_RECORD_HEADER_SIZE + observation.payload_len;
+  memset(&out[21], 0, BEACON_CAPTURE_RECORD_HEADER_SIZE - 21);
+  if (observation.payload_len > 0) {
+    memcpy(&out[BEACON_CAPTURE_RECORD_HEADER_SIZE], observation.payload, observation.payload_len);
+  }
+  memset(&out[payload_end], 0, size - payload_end);
+
+  return size;
+}
+
+uint32_t BeaconCapture::decodeRecord(const uint8_t* data, size_t available, uint16_t header_size,
+                                     ScanObservation& observation) {
+  if (available < header_size) {
+    return 0;
+  }
+
+  uint16_t payload_len = readU16(&data[8]);
+  size_t size = paddedSize(header_size, payload_len);
+  if (available < (size_t)header_size + payload_len) {
+    return 0;
+  }
+
+  observation.timestamp_us = readU64(data);
+  observation.payload_len = payload_len;
+  memcpy(observation.address, &data[10], 6);
+  observation.address_type = data[16];
+  observation.rssi = (int8_t)data[17];
+  observation.channel = data[18];
+  observation.tx_power = (int8_t)data[19];
+  observation.flags = data[20];
+  observation.reserved = 0;
+  observation.payload = &data[header_size];
+
+  // The final record's padding may be missing from a capture cut short
+  return size <= available ? (uint32_t)size : (uint32_t)available;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BeaconCaptureWriter::BeaconCaptureWriter() : file(nullptr), record_count(0) {}
+
+BeaconCaptureWriter::~BeaconCaptureWriter() {
+  close();
+}
+
+bool BeaconCaptureWriter::open(const char* path) {
+  close();
+
+  file = fopen(path, "a+b");
+  if (file == nullptr) {
+    return false;
+  }
+
+  fseeko(file, 0, SEEK_END);
+  off_t size = ftello(file);
+
+  if (size == 0) {
+    uint8_t header[BEACON_CAPTURE_FILE_HEADER_SIZE];
+    BeaconCapture::encodeFileHeader(header);
+    if (fwrite(header, sizeof(header), 1, file) != 1) {
+      close();
+      return false;
+    }
+  } else if (!complete(size)) {
+    // Appending after a torn record would misalign everything written
+    // from here on
+    close();
+    return false;
+  }
+
+  // Switching an update stream from reading to writing needs a seek
+  fseeko(file, 0, SEEK_END);
+  record_count = 0;
+  return true;
+}
+
+bool BeaconCaptureWriter::complete(off_t size) {
+  // Only version 1 captures are appended to
+  uint8_t header[BEACON_CAPTURE_RECORD_HEADER_SIZE];
+  fseeko(file, 0, SEEK_SET);
+  if (fread(header, BEACON_CAPTURE_FILE_HEADER_SIZE, 1, file) != 1 ||
+      BeaconCapture::checkFileHeader(header, BEACON_CAPTURE_FILE_HEADER_SIZE) !=
+        BEACON_CAPTURE_RECORD_HEADER_SIZE) {
+    return false;
+  }
+
+  // Walk the record headers; a crash can leave an aligned size with a
+  // record cut anywhere, so the walk has to end exactly at the end of file
+  off_t pos = BEACON_CAPTURE_FILE_HEADER_SIZE;
+  ScanObservation observation;
+  while (pos < size) {
+    if (size - pos < BEACON_CAPTURE_RECORD_HEADER_SIZE ||
+        fread(header, sizeof(header), 1, file) != 1) {
+      return false;
+    }
+    uint32_t record = BeaconCapture::decodeRecord(header, (size_t)(size - pos),
+                                                  BEACON_CAPTURE_RECORD_HEADER_SIZE, observation);
+    if (record == 0) {
+      return false;
+    }
+    pos += record;
+    fseeko(file, pos, SEEK_SET);
+  }
+
+  // The last record's padding must be there too
+  return pos == size && size % BEACON_CAPTURE_ALIGNMENT == 0;
+}
+
+bool BeaconCaptureWriter::write(const ScanObservation& observation) {
+  if (file == nullptr) {
+    return false;
+  }
+
+  // Records fit a 64 KiB payload plus header; encode through a small
+  // buffer for advertisements and in pieces for anything larger
+  uint8_t buffer[BEACON_CAPTURE_RECORD_HEADER_SIZE + 256];
+  uint32_t size = BeaconCapture::recordSize(observation.payload_len);
+
+  if (size <= sizeof(buffer)) {
+    BeaconCapture::encodeRecord(observation, buffer);
+    if (fwrite(buffer, size, 1, file) != 1) {
+      return false;
+    }
+  } else {
+    ScanObservation header = observation;
+    header.payload_len = 0;
+    BeaconCapture::encodeRecord(header, buffer);
+    writeU16(&buffer[8], observation.payload_len);
+
+    static const uint8_t padding[BEACON_CAPTURE_ALIGNMENT] = {0};
+    uint32_t pad = size - BEACON_CAPTURE_RECORD_HEADER_SIZE - observation.payload_len;
+    if (fwrite(buffer, BEACON_CAPTURE_RECORD_HEADER_SIZE, 1, file) != 1 ||
+        fwrite(observation.payload, observation.payload_len, 1, file) != 1 ||
+        (pad > 0 && fwrite(padding, pad, 1, file) != 1)) {
+      return false;
+    }
+  }
+
+  record_count++;
+  return true;
+}
+
+bool BeaconCaptureWriter::flush() {
+  return file != nullptr && fflush(file) == 0;
+}
+
+void BeaconCaptureWriter::close() {
+  if (file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+}
+
+BeaconCaptureReader::BeaconCaptureReader()
+    : base(nullptr), length(0), offset(0), header_size(0), cut_short(false) {}
+
+BeaconCaptureReader::~BeaconCaptureReader() {
+  close();
+}
+
+bool BeaconCaptureReader::open(const char* path) {
+  close();
+
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (size_t)info.st_size < BEACON_CAPTURE_FILE_HEADER_SIZE) {
+    ::close(fd);
+    return false;
+  }
+
+  void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // The mapping keeps the file open
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  base = (const uint8_t*)mapping;
+  length = (size_t)info.st_size;
+  header_size = BeaconCapture::checkFileHeader(base, length);
+  if (header_size == 0) {
+    close();
+    return false;
+  }
+
+  // Replay reads front to back: let the kernel read ahead aggressively
+  posix_madvise(mapping, length, POSIX_MADV_SEQUENTIAL);
+  rewind();
+  return true;
+}
+
+bool BeaconCaptureReader::next(ScanObservation& observation) {
+  if (base == nullptr || offset >= length) {
+    return false;
+  }
+
+  uint32_t size = BeaconCapture::decodeRecord(&base[offset], length - offset, header_size,
+                                              observation);
+  if (size == 0) {
+    cut_short = true;
+    offset = length;
+    return false;
+  }
+
+  offset += size;
+  return true;
+}
+
+void BeaconCaptureReader::rewind() {
+  offset = BEACON_CAPTURE_FILE_HEADER_SIZE;
+  cut_short = false;
+}
+
+void BeaconCaptureReader::close() {
+  if (base != nullptr) {
+    munmap((void*)base, length);
+    base = nullptr;
+  }
+  length = 0;
+  offset = 0;
+  header_size = 0;
+  cut_short = false;
+}
+
+#endif  // __unix__ || __APPLE__
@@ -0,0 +1,223 @@
+#ifndef BEACON_CAPTURE_H
+#define BEACON_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ScanObservation.h"
+
+// File header: magic, version, record header size
+#define BEACON_CAPTURE_MAGIC "BBCP"
+#define BEACON_CAPTURE_VERSION 1
+#define BEACON_CAPTURE_FILE_HEADER_SIZE 16
+#define BEACON_CAPTURE_RECORD_HEADER_SIZE 24
+
+// Records start on multiples of this many bytes from the start of the file
+#define BEACON_CAPTURE_ALIGNMENT 8
+
+/**
+ * @brief Binary capture format for replaying scan traffic
+ *
+ * An append-only file of fixed-header records, one per ScanObservation.
+ * All multi-byte fields are little-endian.
+ *
+ * File header (16 bytes):
+ * | Offset | Size | Field                                 |
+ * |--------|------|---------------------------------------|
+ * | 0      | 4    | Magic "BBCP"                          |
+ * | 4      | 2    | Version (1)                           |
+ * | 6      | 2    | Record header size (24)               |
+ * | 8      | 8    | Reserved (0)                          |
+ *
+ * Record (24-byte header, payload, zero padding to a multiple of 8 bytes):
+ * | Offset | Size | Field                                 |
+ * |--------|------|---------------------------------------|
+ * | 0      | 8    | Timestamp in microseconds             |
+ * | 8      | 2    | Payload length                        |
+ * | 10     | 6    | Advertiser address                    |
+ * | 16     | 1    | Address type                          |
+ * | 17     | 1    | RSSI (dBm, 127 if unavailable)        |
+ * | 18     | 1    | Channel (0 if unknown)                |
+ * | 19     | 1    | TX power (dBm, 127 if unavailable)    |
+ * | 20     | 1    | Flags (SCAN_OBSERVATION_*)            |
+ * | 21     | 3    | Reserved (0)                          |
+ * | 24     | n    | Payload                               |
+ *
+ * Readers use the record header size from the file header, so later
+ * versions may append fields to the record header. A record cut short by
+ * a crash while writing ends the file.
+ *
+ * The static helpers encode and decode records in memory on any target
+ * (e.g. to log to an SD card). BeaconCaptureWriter and BeaconCaptureReader
+ * add POSIX file I/O.
+ */
+class BeaconCapture {
+ public:
+  /**
+   * @brief Write the 16-byte file header
+   */
+  static void encodeFileHeader(uint8_t* out);
+
+  /**
+   * @brief Check a file header
+   * @return Record header size, or 0 if the header is not a supported capture header
+   */
+  static uint16_t checkFileHeader(const uint8_t* data, size_t len);
+
+  /**
+   * @brief Bytes a record with this payload occupies, padding included
+   */
+  static uint32_t recordSize(uint16_t payload_len) {
+    uint32_t size = BEACON_CAPTURE_RECORD_HEADER_SIZE + (uint32_t)payload_len;
+    return (size + BEACON_CAPTURE_ALIGNMENT - 1) & ~(uint32_t)(BEACON_CAPTURE_ALIGNMENT - 1);
+  }
+
+  /**
+   * @brief Encode one record
+   * @param observation Observation and payload to store
+   * @param out Buffer of at least recordSize(observation.payload_len) bytes
+   * @return Bytes written
+   */
+  static uint32_t encodeRecord(const ScanObservation& observation, uint8_t* out);
+
+  /**
+   * @brief Decode one record without copying its payload
+   * @param data Record start
+   * @param available Bytes from data to the end of the capture
+   * @param header_size Record header size from checkFileHeader()
+   * @param observation Filled in; payload points into data
+   * @return Bytes the record occupies, or 0 if it is incomplete
+   */
+  static uint32_t decodeRecord(const uint8_t* data, size_t available, uint16_t header_size,
+                               ScanObservation& observation);
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <stdio.h>
+#include <sys/types.h>
+
+/**
+ * @brief Appends observations to a capture file
+ *
+ * Writes go through a stdio buffer; call flush() to push them to the OS.
+ */
+class BeaconCaptureWriter {
+ public:
+  BeaconCaptureWriter();
+  ~BeaconCaptureWriter();
+
+  BeaconCaptureWriter(const BeaconCaptureWriter&) = delete;
+  BeaconCaptureWriter& operator=(const BeaconCaptureWriter&) = delete;
+
+  /**
+   * @brief Open a capture for appending, creating it if missing
+   *
+   * An existing capture is walked record by record first (header reads
+   * and seeks only), and refused unless its last record is complete.
+   *
+   * @return false if the file cannot be opened, is not a capture or ends
+   *         in a torn record
+   */
+  bool open(const char* path);
+
+  /**
+   * @brief Append one record
+   */
+  bool write(const ScanObservation& observation);
+
+  bool flush();
+
+  void close();
+
+  /**
+   * @brief Records written since open()
+   */
+  uint64_t records() const {
+    return record_count;
+  }
+
+ private:
+  bool complete(off_t size);
+
+  FILE* file;
+  uint64_t record_count;
+};
+
+/**
+ * @brief Memory-mapped capture reader
+ *
+ * Maps the whole file read-only and walks it record by record. next()
+ * points the observation's payload straight into the mapping, so records
+ * go to BLEBeaconParser::parse() without a copy or allocation; payloads
+ * stay valid until close().
+ *
+ * Usage:
+ * @code
+ * BeaconCaptureReader capture;
+ * ScanObservation observation;
+ * if (capture.open("day.bbcp")) {
+ *   while (capture.next(observation)) {
+ *     parser.parse(observation, result);
+ *   }
+ * }
+ * @endcode
+ */
+class BeaconCaptureReader {
+ public:
+  BeaconCaptureReader();
+  ~BeaconCaptureReader();
+
+  BeaconCaptureReader(const BeaconCaptureReader&) = delete;
+  BeaconCaptureReader& operator=(const BeaconCaptureReader&) = delete;
+
+  /**
+   * @brief Map a capture file
+   * @return false if the file cannot be mapped or is not a capture
+   */
+  bool open(const char* path);
+
+  /**
+   * @brief Read the next record
+   * @return false at the end of the capture
+   */
+  bool next(ScanObservation& observation);
+
+  /**
+   * @brief Go back to the first record
+   */
+  void rewind();
+
+  void close();
+
+  /**
+   * @brief Whether the capture ended in an incomplete record
+   */
+  bool truncated() const {
+    return cut_short;
+  }
+
+  /**
+   * @brief Capture size in bytes
+   */
+  size_t size() const {
+    return length;
+  }
+
+  /**
+   * @brief Bytes consumed so far, headers included
+   */
+  size_t position() const {
+    return offset;
+  }
+
+ private:
+  const uint8_t* base;
+  size_t length;
+  size_t offset;
+  uint16_t header_size;
+  bool cut_short;
+};
+
+#endif  // __unix__ || __APPLE__
+
+#endif  // BEACON_CAPTURE_H
@@ -2,13 +2,26 @@
 #define BEACON_DATA_H
 
 #include <stdint.h>
-#include <new>
 #ifdef NATIVE_BUILD
 #include "mock_arduino.h"
 #else
 #include <Arduino.h>
 #endif
 
+// UUID length in bytes
+#define IBEACON_UUID_LENGTH 16
+
+// Buffer size for a formatted UUID: 32 hex digits + 4 dashes + terminator
+#define BEACON_UUID_STRING_SIZE 37
+
+// Eddystone-URL limits: at most 17 encoded bytes follow the scheme byte, and
+// the longest expansion is "https://www." (12) + 17 x ".info/" (6) = 114 chars
+#define EDDYSTONE_URL_MAX_ENCODED_LENGTH 17
+#define EDDYSTONE_URL_MAX_LENGTH 114
+
+// Size of the user-extension area written by custom format decoders
+#define BEACON_CUSTOM_DATA_SIZE 64
+
 /**
  * @brief Enumeration of supported beacon types
  */
@@ -18,17 +31,47 @@ enum BeaconType {
   BEACON_TYPE_EDDYSTONE_UID,
   BEACON_TYPE_EDDYSTONE_URL,
   BEACON_TYPE_EDDYSTONE_TLM,
-  BEACON_TYPE_ALTBEACON
+  BEACON_TYPE_ALTBEACON,
+  BEACON_TYPE_CUSTOM  // Decoded by a format registered with BLEBeaconParser::addFormat
 };
 
 /**
  * @brief iBeacon data structure
  */
 struct iBeaconData {
-  String uuid;  // UUID as hex string (e.g., "5F2DD896-B886-4549-AE01-E41ACD7A354A")
+  uint8_t uuid[IBEACON_UUID_LENGTH];  // UUID bytes in transmission order
   uint16_t major;
   uint16_t minor;
   int8_t tx_power;
+
+  /**
+   * @brief Format the UUID as "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX"
+   * @param out Buffer of at least BEACON_UUID_STRING_SIZE bytes (NUL-terminated)
+   */
+  void uuidToChars(char* out) const {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    uint8_t pos = 0;
+    for (uint8_t i = 0; i < IBEACON_UUID_LENGTH; i++) {
+      // Dashes before bytes 4, 6, 8 and 10
+      if (i == 4 || i == 6 || i == 8 || i == 10) {
+        out[pos++] = '-';
+      }
+      out[pos++] = HEX_DIGITS[uuid[i] >> 4];
+      out[pos++] = HEX_DIGITS[uuid[i] & 0x0F];
+    }
+    out[pos] = '\0';
+  }
+
+  /**
+   * @brief UUID as a String (e.g., "5F2DD896-B886-4549-AE01-E41ACD7A354A")
+   *
+   * Allocates; prefer uuidToChars() or the raw bytes on hot paths.
+   */
+  String uuidString() const {
+    char buffer[BEACON_UUID_STRING_SIZE];
+    uuidToChars(buffer);
+    return String(buffer);
+  }
 };
 
 /**
@@ -44,7 +87,7 @@ struct EddystoneUIDData {
  * @brief Eddystone URL data structure
  */
 struct EddystoneURLData {
-  String url;
+  char url[EDDYSTONE_URL_MAX_LENGTH + 1];  // Decoded URL (NUL-terminated)
   int8_t tx_power;
 };
 
@@ -69,11 +112,28 @@ struct AltBeaconData {
   uint8_t mfg_reserved;  // Manufacturer reserved byte
 };
 
+/**
+ * @brief User-extension area for custom formats
+ *
+ * Filled by the custom decoder registered with BLEBeaconParser::addFormat.
+ * data starts the union, so it is aligned for 32-bit fields and decoders may
+ * store their own small struct there.
+ */
+struct CustomBeaconData {
+  uint8_t data[BEACON_CUSTOM_DATA_SIZE];  // Decoder-defined contents
+  uint16_t format;                        // Format tag chosen by the decoder
+  uint8_t len;                            // Bytes of data in use
+};
+
 /**
  * @brief Unified beacon data structure containing all format-specific data
  *
  * Use the type field to determine which union member contains valid data.
  * Always check the valid flag before accessing union members.
+ *
+ * BeaconData is trivially copyable and never allocates: it can be copied or
+ * relocated with memcpy, and textual forms (UUID strings) are produced on
+ * demand from the raw bytes.
  */
 struct BeaconData {
   BeaconType type;
@@ -85,103 +145,13 @@ struct BeaconData {
     EddystoneURLData eddystone_url;
     EddystoneTLMData eddystone_tlm;
     AltBeaconData altbeacon;
+    CustomBeaconData custom;
   };
 
   /**
    * @brief Constructor - initializes to unknown/invalid state
    */
-  BeaconData() : type(BEACON_TYPE_UNKNOWN), valid(false) {
-    // Initialize union members using placement new
-    new (&ibeacon) iBeaconData();
-  }
-
-  /**
-   * @brief Destructor - properly destroys union members
-   */
-  ~BeaconData() {
-    // Call destructor for the active union member
-    switch (type) {
-      case BEACON_TYPE_IBEACON:
-        ibeacon.~iBeaconData();
-        break;
-      case BEACON_TYPE_EDDYSTONE_URL:
-        eddystone_url.~EddystoneURLData();
-        break;
-      default:
-        // Other types don't have non-trivial destructors
-        break;
-    }
-  }
-
-  /**
-   * @brief Copy constructor
-   */
-  BeaconData(const BeaconData& other) : type(other.type), valid(other.valid) {
-    // Copy the appropriate union member
-    switch (type) {
-      case BEACON_TYPE_IBEACON:
-        new (&ibeacon) iBeaconData(other.ibeacon);
-        break;
-      case BEACON_TYPE_EDDYSTONE_UID:
-        eddystone_uid = other.eddystone_uid;
-        break;
-      case BEACON_TYPE_EDDYSTONE_URL:
-        new (&eddystone_url) EddystoneURLData(other.eddystone_url);
-        break;
-      case BEACON_TYPE_EDDYSTONE_TLM:
-        eddystone_tlm = other.eddystone_tlm;
-        break;
-      case BEACON_TYPE_ALTBEACON:
-        altbeacon = other.altbeacon;
-        break;
-      default:
-        break;
-    }
-  }
-
-  /**
-   * @brief Assignment operator
-   */
-  BeaconData& operator=(const BeaconData& other) {
-    if (this != &other) {
-      // Destroy current union member
-      switch (type) {
-        case BEACON_TYPE_IBEACON:
-          ibeacon.~iBeaconData();
-          break;
-        case BEACON_TYPE_EDDYSTONE_URL:
-          eddystone_url.~EddystoneURLData();
-          break;
-        default:
-          break;
-      }
-
-      type = other.type;
-      valid = other.valid;
-
-      // Copy the appropriate union member
-      switch (type) {
-        case BEACON_TYPE_IBEACON:
-          new (&ibeacon) iBeaconData(other.ibeacon);
-          break;
-        case BEACON_TYPE_EDDYSTONE_UID:
-          eddystone_uid = other.eddystone_uid;
-          break;
-        case BEACON_TYPE_EDDYSTONE_URL:
-          new (&eddystone_url) EddystoneURLData(other.eddystone_url);
-          break;
-        case BEACON_TYPE_EDDYSTONE_TLM:
-          eddystone_tlm = other.eddystone_tlm;
-          break;
-        case BEACON_TYPE_ALTBEACON:
-          altbeacon = other.altbeacon;
-          break;
-        default:
-          break;
-      }
-    }
-    return *this;
-  }
+  BeaconData() : type(BEACON_TYPE_UNKNOWN), valid(false) {}
 
   /**
    * @brief Get iBeacon data (only valid if type == BEACON_TYPE_IBEACON)
@@ -217,6 +187,16 @@ struct BeaconData {
   const AltBeaconData& getAltBeacon() const {
     return altbeacon;
   }
+
+  /**
+   * @brief Get custom format data (only valid if type == BEACON_TYPE_CUSTOM)
+   */
+  const CustomBeaconData& getCustom() const {
+    return custom;
+  }
 };
 
+// Keep the unified record within two 64-byte cache lines
+static_assert(sizeof(BeaconData) <= 128, "BeaconData must fit in two cache lines");
+
 #endif  // BEACON_DATA_H
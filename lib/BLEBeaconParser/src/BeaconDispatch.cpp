@@ -0,0 +1,164 @@
+#include "BeaconDispatch.h"
+#include <string.h>
+
+BeaconDispatch::BeaconDispatch() : count(0) {
+  for (uint8_t i = 0; i < BEACON_DISPATCH_SLOTS; i++) {
+    slots[i].decode = nullptr;
+    slots[i].columns = nullptr;
+    slots[i].classify = nullptr;
+    slots[i].id = 0;
+    slots[i].ad_type = 0;
+    slots[i].prefix_len = 0;
+  }
+}
+
+uint8_t BeaconDispatch::slotFor(uint8_t ad_type, uint16_t id) {
+  // Multiplicative hash of the ID; the top bits are well mixed
+  uint16_t mixed = (uint16_t)(id * 0x9E37u);
+  return ((mixed >> (16 - BEACON_DISPATCH_BITS)) ^ ad_type) & (BEACON_DISPATCH_SLOTS - 1);
+}
+
+BeaconFormatEntry* BeaconDispatch::insert(uint8_t ad_type, uint16_t id, BeaconDecodeFn decode) {
+  if (decode == nullptr || count >= BEACON_DISPATCH_SLOTS) {
+    return nullptr;
+  }
+
+  // Linear probing to the first empty slot keeps same-key decoders in
+  // registration order along the probe sequence
+  uint8_t slot = slotFor(ad_type, id);
+  while (slots[slot].decode != nullptr) {
+    slot = (slot + 1) & (BEACON_DISPATCH_SLOTS - 1);
+  }
+
+  BeaconFormatEntry& entry = slots[slot];
+  entry.decode = decode;
+  entry.columns = nullptr;
+  entry.classify = nullptr;
+  entry.id = id;
+  entry.ad_type = ad_type;
+  entry.prefix_len = 0;
+  count++;
+  return &entry;
+}
+
+bool BeaconDispatch::add(uint8_t ad_type, uint16_t id, BeaconDecodeFn decode,
+                         BeaconColumnsFn columns, BeaconClassifyFn classify) {
+  BeaconFormatEntry* entry = insert(ad_type, id, decode);
+  if (entry == nullptr) {
+    return false;
+  }
+
+  entry->columns = columns;
+  entry->classify = classify;
+  return true;
+}
+
+bool BeaconDispatch::add(const BeaconSignature& signature, BeaconDecodeFn decode) {
+  if (signature.prefix_len > BEACON_SIGNATURE_MAX_PREFIX) {
+    return false;
+  }
+
+  BeaconFormatEntry* entry = insert(signature.ad_type, signature.id, decode);
+  if (entry == nullptr) {
+    return false;
+  }
+
+  memcpy(entry->prefix, signature.prefix, signature.prefix_len);
+  entry->prefix_len = signature.prefix_len;
+  return true;
+}
+
+bool BeaconDispatch::matches(const BeaconFormatEntry& entry, const ADField& field) {
+  if (entry.ad_type != field.type || entry.id != field.id) {
+    return false;
+  }
+
+  // Built-in parsers check their own prefixes
+  if (entry.prefix_len == 0) {
+    return true;
+  }
+
+  return field.len >= entry.prefix_len && memcmp(field.data, entry.prefix, entry.prefix_len) == 0;
+}
+
+bool BeaconDispatch::decode(const ADField& field, BeaconData& result,
+                            BeaconDecodeFn skip) const {
+  uint8_t slot = slotFor(field.type, field.id);
+
+  for (uint8_t probe = 0; probe < BEACON_DISPATCH_SLOTS; probe++) {
+    const BeaconFormatEntry& entry = slots[slot];
+
+    // Empty slot ends the probe sequence: no decoder for this key
+    if (entry.decode == nullptr) {
+      return false;
+    }
+
+    if (entry.decode != skip && matches(entry, field) && entry.decode(field, result)) {
+      return true;
+    }
+
+    slot = (slot + 1) & (BEACON_DISPATCH_SLOTS - 1);
+  }
+
+  return false;
+}
+
+bool BeaconDispatch::decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row) const {
+  uint8_t slot = slotFor(field.type, field.id);
+
+  for (uint8_t probe = 0; probe < BEACON_DISPATCH_SLOTS; probe++) {
+    const BeaconFormatEntry& entry = slots[slot];
+
+    if (entry.decode == nullptr) {
+      return false;
+    }
+
+    if (entry.columns != nullptr && matches(entry, field) && entry.columns(field, batch, row)) {
+      return true;
+    }
+
+    slot = (slot + 1) & (BEACON_DISPATCH_SLOTS - 1);
+  }
+
+  return false;
+}
+
+BeaconType BeaconDispatch::classify(const ADField& field) const {
+  uint8_t slot = slotFor(field.type, field.id);
+
+  for (uint8_t probe = 0; probe < BEACON_DISPATCH_SLOTS; probe++) {
+    const BeaconFormatEntry& entry = slots[slot];
+
+    if (entry.decode == nullptr) {
+      return BEACON_TYPE_UNKNOWN;
+    }
+
+    if (entry.classify != nullptr && matches(entry, field)) {
+      BeaconType type = entry.classify(field);
+      if (type != BEACON_TYPE_UNKNOWN) {
+        return type;
+      }
+    }
+
+    slot = (slot + 1) & (BEACON_DISPATCH_SLOTS - 1);
+  }
+
+  return BEACON_TYPE_UNKNOWN;
+}
+
+bool BeaconDispatch::contains(uint8_t ad_type, uint16_t id) const {
+  uint8_t slot = slotFor(ad_type, id);
+
+  for (uint8_t probe = 0; probe < BEACON_DISPATCH_SLOTS; probe++) {
+    const BeaconFormatEntry& entry = slots[slot];
+    if (entry.decode == nullptr) {
+      return false;
+    }
+    if (entry.ad_type == ad_type && entry.id == id) {
+      return true;
+    }
+    slot = (slot + 1) & (BEACON_DISPATCH_SLOTS - 1);
+  }
+
+  return false;
+}
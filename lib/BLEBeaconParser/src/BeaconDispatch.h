@@ -0,0 +1,165 @@
+#ifndef BEACON_DISPATCH_H
+#define BEACON_DISPATCH_H
+
+#include <stdint.h>
+#include "ADStructures.h"
+#include "BeaconBatch.h"
+#include "BeaconData.h"
+
+// Dispatch table size (power of two)
+#define BEACON_DISPATCH_BITS 4
+#define BEACON_DISPATCH_SLOTS (1 << BEACON_DISPATCH_BITS)
+
+// Longest prefix a custom format signature can match
+#define BEACON_SIGNATURE_MAX_PREFIX 4
+
+/**
+ * @brief Decoder for a single pre-located AD field
+ * @param field Manufacturer or service data field matching the decoder's key
+ * @param result BeaconData structure to fill with parsed data
+ * @return true if the field was decoded
+ */
+typedef bool (*BeaconDecodeFn)(const ADField& field, BeaconData& result);
+
+/**
+ * @brief Column decoder used by batch parsing
+ * @param field Manufacturer or service data field matching the decoder's key
+ * @param batch Batch whose columns receive the decoded fields
+ * @param row Row to write
+ * @return true if the field was decoded (the type column is set on success)
+ */
+typedef bool (*BeaconColumnsFn)(const ADField& field, BeaconBatch& batch, uint16_t row);
+
+/**
+ * @brief Classifier used by lazy views
+ * @param field Manufacturer or service data field matching the classifier's key
+ * @return Beacon type the field would decode as, or BEACON_TYPE_UNKNOWN
+ */
+typedef BeaconType (*BeaconClassifyFn)(const ADField& field);
+
+/**
+ * @brief Signature of a custom format
+ *
+ * A field matches when its AD type and ID equal ad_type and id and its
+ * payload (after the ID) starts with the prefix bytes.
+ */
+struct BeaconSignature {
+  uint8_t ad_type;                              // AD type (0xFF or 0x16)
+  uint16_t id;                                  // Company ID or service UUID
+  uint8_t prefix[BEACON_SIGNATURE_MAX_PREFIX];  // Leading payload bytes
+  uint8_t prefix_len;                           // Number of prefix bytes (0 to match any payload)
+};
+
+/**
+ * @brief Dispatch table entry
+ */
+struct BeaconFormatEntry {
+  BeaconDecodeFn decode;                        // nullptr marks an empty slot
+  BeaconColumnsFn columns;                      // Optional batch decoder
+  BeaconClassifyFn classify;                    // Optional classifier for BeaconView
+  uint16_t id;                                  // Company ID or service UUID
+  uint8_t ad_type;                              // AD type (0xFF or 0x16)
+  uint8_t prefix_len;                           // Signature prefix length (0 for built-ins)
+  uint8_t prefix[BEACON_SIGNATURE_MAX_PREFIX];  // Signature prefix bytes
+};
+
+/**
+ * @brief Constant-time format dispatch keyed on AD type and company ID / service UUID
+ *
+ * A small open-addressed hash table built from the registered format parsers.
+ * Each AD field is looked up once and handed straight to the decoder
+ * registered for its key, so the cost per field does not grow with the
+ * number of enabled formats.
+ *
+ * Several decoders may share a key; they are tried in registration order.
+ */
+class BeaconDispatch {
+ public:
+  BeaconDispatch();
+
+  /**
+   * @brief Register a decoder for an AD type and ID
+   * @param ad_type AD type (AD_TYPE_MANUFACTURER_SPECIFIC_DATA or AD_TYPE_SERVICE_DATA)
+   * @param id Company ID or 16-bit service UUID
+   * @param decode Decoder to run for matching fields
+   * @param columns Optional batch decoder for matching fields
+   * @param classify Optional classifier for matching fields
+   * @return true if registered, false if the table is full
+   */
+  bool add(uint8_t ad_type, uint16_t id, BeaconDecodeFn decode, BeaconColumnsFn columns = nullptr,
+           BeaconClassifyFn classify = nullptr);
+
+  /**
+   * @brief Register a decoder for a custom format signature
+   *
+   * The decoder only runs for fields whose payload starts with the
+   * signature prefix, after any decoders registered earlier for the same
+   * key have declined the field.
+   *
+   * @param signature AD type, ID and prefix bytes to match
+   * @param decode Decoder to run for matching fields
+   * @return true if registered, false if the table is full or the prefix is too long
+   */
+  bool add(const BeaconSignature& signature, BeaconDecodeFn decode);
+
+  /**
+   * @brief Register a format parser class
+   *
+   * The parser must provide AD_TYPE and AD_ID constants and static
+   * decode(const ADField&, BeaconData&),
+   * decodeColumns(const ADField&, BeaconBatch&, uint16_t) and
+   * classify(const ADField&) functions.
+   */
+  template <class Parser>
+  bool add() {
+    return add(Parser::AD_TYPE, Parser::AD_ID, &Parser::decode, &Parser::decodeColumns,
+               &Parser::classify);
+  }
+
+  /**
+   * @brief Decode a field with the decoder registered for its key
+   * @param field AD field located by ADTokenizer
+   * @param result BeaconData structure to fill with parsed data
+   * @param skip Decoder the caller has already run on the field, or nullptr
+   * @return true if a registered decoder parsed the field
+   */
+  bool decode(const ADField& field, BeaconData& result, BeaconDecodeFn skip = nullptr) const;
+
+  /**
+   * @brief Decode a field into one row of a batch
+   * @param field AD field located by ADTokenizer
+   * @param batch Batch whose columns receive the decoded fields
+   * @param row Row to write
+   * @return true if a registered column decoder parsed the field
+   */
+  bool decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row) const;
+
+  /**
+   * @brief Classify a field without decoding it
+   * @param field AD field located by ADTokenizer
+   * @return Beacon type reported by the first matching classifier, or BEACON_TYPE_UNKNOWN
+   */
+  BeaconType classify(const ADField& field) const;
+
+  /**
+   * @brief Check whether any decoder is registered for a key
+   */
+  bool contains(uint8_t ad_type, uint16_t id) const;
+
+  /**
+   * @brief Number of registered decoders
+   */
+  uint8_t size() const {
+    return count;
+  }
+
+ private:
+  static uint8_t slotFor(uint8_t ad_type, uint16_t id);
+  static bool matches(const BeaconFormatEntry& entry, const ADField& field);
+  BeaconFormatEntry* insert(uint8_t ad_type, uint16_t id, BeaconDecodeFn decode);
+
+  BeaconFormatEntry slots[BEACON_DISPATCH_SLOTS];
+  uint8_t count;
+};
+
+#endif  // BEACON_DISPATCH_H
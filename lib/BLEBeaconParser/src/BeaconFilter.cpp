@@ -0,0 +1,776 @@
+#include "BeaconFilter.h"
+#include <string.h>
+#include "BeaconPrefilter.h"
+
+// Evaluation cost classes; && and || operands run in this order
+#define FILTER_COST_METADATA 0   // Scan metadata only
+#define FILTER_COST_SIGNATURE 1  // Signature scan, then classification
+#define FILTER_COST_FIELD 2      // One field read from the classified packet
+#define FILTER_COST_IDENTITY 3   // Byte-string comparisons
+
+// Fields, indexing FILTER_FIELDS
+#define FILTER_FIELD_RSSI 0
+#define FILTER_FIELD_TYPE 1
+#define FILTER_FIELD_UUID 2
+#define FILTER_FIELD_NAMESPACE 3
+#define FILTER_FIELD_INSTANCE 4
+#define FILTER_FIELD_MAJOR 5
+#define FILTER_FIELD_MINOR 6
+#define FILTER_FIELD_TX_POWER 7
+#define FILTER_FIELD_TLM_BATTERY 8
+#define FILTER_FIELD_TLM_TEMPERATURE 9
+#define FILTER_FIELD_TLM_ADV_COUNT 10
+#define FILTER_FIELD_TLM_UPTIME 11
+
+// Predicate operators
+#define FILTER_OP_EQ 0
+#define FILTER_OP_NE 1
+#define FILTER_OP_LT 2
+#define FILTER_OP_LE 3
+#define FILTER_OP_GT 4
+#define FILTER_OP_GE 5
+#define FILTER_OP_IN 6
+
+// Instructions; the result register starts false
+#define FILTER_CODE_TEST 0        // result = predicates[arg]
+#define FILTER_CODE_NOT 1         // result = !result
+#define FILTER_CODE_JUMP_FALSE 2  // if (!result) goto arg
+#define FILTER_CODE_JUMP_TRUE 3   // if (result) goto arg
+
+// Jump target not yet known
+#define FILTER_UNPATCHED 0xFF
+
+// Expression tree built by the compiler
+#define FILTER_NODE_PREDICATE 0
+#define FILTER_NODE_AND 1
+#define FILTER_NODE_OR 2
+#define FILTER_NODE_NOT 3
+#define FILTER_NIL 0xFF
+#define FILTER_MAX_NODES (2 * BEACON_FILTER_MAX_PREDICATES + BEACON_FILTER_MAX_DEPTH)
+
+#define FILTER_TYPE_BIT(type) (1 << (type))
+
+// Beacon types carrying each family of fields
+#define FILTER_TYPES_ANY 0
+#define FILTER_TYPES_MAJOR_MINOR \
+  (FILTER_TYPE_BIT(BEACON_TYPE_IBEACON) | FILTER_TYPE_BIT(BEACON_TYPE_ALTBEACON))
+#define FILTER_TYPES_UUID (FILTER_TYPES_MAJOR_MINOR | FILTER_TYPE_BIT(BEACON_TYPE_EDDYSTONE_UID))
+#define FILTER_TYPES_TX_POWER (FILTER_TYPES_UUID | FILTER_TYPE_BIT(BEACON_TYPE_EDDYSTONE_URL))
+#define FILTER_TYPES_EDDYSTONE_UID FILTER_TYPE_BIT(BEACON_TYPE_EDDYSTONE_UID)
+#define FILTER_TYPES_TLM FILTER_TYPE_BIT(BEACON_TYPE_EDDYSTONE_TLM)
+
+struct FilterFieldInfo {
+  const char* name;
+  uint8_t cost;
+  uint8_t width;   // Identity bytes, 0 for numeric fields
+  uint8_t types;   // Beacon types carrying the field (FILTER_TYPES_ANY: every packet)
+  uint16_t scale;  // Packet units per expression unit
+};
+
+static const FilterFieldInfo FILTER_FIELDS[] = {
+  {"rssi", FILTER_COST_METADATA, 0, FILTER_TYPES_ANY, 1},
+  {"type", FILTER_COST_SIGNATURE, 0, FILTER_TYPES_ANY, 1},
+  {"uuid", FILTER_COST_IDENTITY, 16, FILTER_TYPES_UUID, 1},
+  {"namespace", FILTER_COST_IDENTITY, 10, FILTER_TYPES_EDDYSTONE_UID, 1},
+  {"instance", FILTER_COST_IDENTITY, 6, FILTER_TYPES_EDDYSTONE_UID, 1},
+  {"major", FILTER_COST_FIELD, 0, FILTER_TYPES_MAJOR_MINOR, 1},
+  {"minor", FILTER_COST_FIELD, 0, FILTER_TYPES_MAJOR_MINOR, 1},
+  {"tx_power", FILTER_COST_FIELD, 0, FILTER_TYPES_TX_POWER, 1},
+  {"tlm.battery", FILTER_COST_FIELD, 0, FILTER_TYPES_TLM, 1},
+  {"tlm.temperature", FILTER_COST_FIELD, 0, FILTER_TYPES_TLM, 256},  // 8.8 fixed point
+  {"tlm.adv_count", FILTER_COST_FIELD, 0, FILTER_TYPES_TLM, 1},
+  {"tlm.uptime", FILTER_COST_FIELD, 0, FILTER_TYPES_TLM, 10},  // Deciseconds
+};
+
+#define FILTER_FIELD_COUNT (sizeof(FILTER_FIELDS) / sizeof(FILTER_FIELDS[0]))
+
+struct FilterTypeName {
+  const char* name;
+  BeaconType type;
+};
+
+static const FilterTypeName FILTER_TYPE_NAMES[] = {
+  {"ibeacon", BEACON_TYPE_IBEACON},
+  {"altbeacon", BEACON_TYPE_ALTBEACON},
+  {"eddystone_uid", BEACON_TYPE_EDDYSTONE_UID},
+  {"eddystone_url", BEACON_TYPE_EDDYSTONE_URL},
+  {"eddystone_tlm", BEACON_TYPE_EDDYSTONE_TLM},
+};
+
+static bool isNameChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+         c == '.';
+}
+
+// Whether the text between start and end spells name
+static bool sameName(const char* name, const char* start, const char* end) {
+  size_t len = end - start;
+  return strlen(name) == len && strncmp(name, start, len) == 0;
+}
+
+static int8_t hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// Prefilter candidate bit a beacon type is found under
+static uint8_t typeCandidate(int32_t type) {
+  switch (type) {
+    case BEACON_TYPE_IBEACON:
+      return BEACON_CANDIDATE_IBEACON;
+    case BEACON_TYPE_ALTBEACON:
+      return BEACON_CANDIDATE_ALTBEACON;
+    case BEACON_TYPE_EDDYSTONE_UID:
+    case BEACON_TYPE_EDDYSTONE_URL:
+    case BEACON_TYPE_EDDYSTONE_TLM:
+      return BEACON_CANDIDATE_EDDYSTONE;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Recursive-descent parser, operand ordering and code generation
+ */
+struct BeaconFilter::Compiler {
+  struct Node {
+    uint8_t kind;
+    uint8_t cost;   // Highest cost class in the subtree
+    uint8_t arg;    // Predicate index
+    uint8_t child;  // First operand
+    uint8_t next;   // Next operand of the parent
+  };
+
+  BeaconFilter& filter;
+  const char* p;
+  Node nodes[FILTER_MAX_NODES];
+  uint8_t node_count;
+  uint8_t depth;
+
+  Compiler(BeaconFilter& target, const char* expression)
+      : filter(target), p(expression), node_count(0), depth(0) {}
+
+  void skipSpace() {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+      p++;
+    }
+  }
+
+  bool accept(const char* token) {
+    skipSpace();
+    size_t len = strlen(token);
+    if (strncmp(p, token, len) != 0 || (isNameChar(token[0]) && isNameChar(p[len]))) {
+      return false;
+    }
+    p += len;
+    return true;
+  }
+
+  uint8_t newNode(uint8_t kind, uint8_t arg, uint8_t cost) {
+    if (node_count >= FILTER_MAX_NODES) {
+      return FILTER_NIL;
+    }
+    Node& node = nodes[node_count];
+    node.kind = kind;
+    node.cost = cost;
+    node.arg = arg;
+    node.child = FILTER_NIL;
+    node.next = FILTER_NIL;
+    return node_count++;
+  }
+
+  void append(uint8_t parent, uint8_t child) {
+    // a && (b && c) becomes one operand list, so all three can be reordered
+    uint8_t first = nodes[child].kind == nodes[parent].kind ? nodes[child].child : child;
+
+    if (nodes[parent].child == FILTER_NIL) {
+      nodes[parent].child = first;
+      return;
+    }
+    uint8_t last = nodes[parent].child;
+    while (nodes[last].next != FILTER_NIL) {
+      last = nodes[last].next;
+    }
+    nodes[last].next = first;
+  }
+
+  // expression := list of && terms joined by ||; term := unary joined by &&
+  uint8_t parseList(uint8_t kind) {
+    const char* token = kind == FILTER_NODE_OR ? "||" : "&&";
+    uint8_t left = kind == FILTER_NODE_OR ? parseList(FILTER_NODE_AND) : parseUnary();
+    if (left == FILTER_NIL || !accept(token)) {
+      return left;
+    }
+
+    uint8_t node = newNode(kind, 0, 0);
+    if (node == FILTER_NIL) {
+      return FILTER_NIL;
+    }
+    append(node, left);
+
+    do {
+      uint8_t right = kind == FILTER_NODE_OR ? parseList(FILTER_NODE_AND) : parseUnary();
+      if (right == FILTER_NIL) {
+        return FILTER_NIL;
+      }
+      append(node, right);
+    } while (accept(token));
+
+    return node;
+  }
+
+  uint8_t parseUnary() {
+    if (accept("!")) {
+      if (++depth > BEACON_FILTER_MAX_DEPTH) {
+        return FILTER_NIL;
+      }
+      uint8_t child = parseUnary();
+      depth--;
+      uint8_t node = child == FILTER_NIL ? FILTER_NIL : newNode(FILTER_NODE_NOT, 0, 0);
+      if (node != FILTER_NIL) {
+        nodes[node].child = child;
+      }
+      return node;
+    }
+
+    if (accept("(")) {
+      if (++depth > BEACON_FILTER_MAX_DEPTH) {
+        return FILTER_NIL;
+      }
+      uint8_t inner = parseList(FILTER_NODE_OR);
+      depth--;
+      return inner != FILTER_NIL && accept(")") ? inner : FILTER_NIL;
+    }
+
+    return parsePredicate();
+  }
+
+  uint8_t parsePredicate() {
+    skipSpace();
+    const char* name = p;
+    while (isNameChar(*p)) {
+      p++;
+    }
+
+    uint8_t field = 0;
+    while (field < FILTER_FIELD_COUNT && !sameName(FILTER_FIELDS[field].name, name, p)) {
+      field++;
+    }
+    if (field == FILTER_FIELD_COUNT) {
+      p = name;
+      return FILTER_NIL;
+    }
+    const FilterFieldInfo& info = FILTER_FIELDS[field];
+
+    uint8_t op;
+    if (accept("==")) {
+      op = FILTER_OP_EQ;
+    } else if (accept("!=")) {
+      op = FILTER_OP_NE;
+    } else if (accept("<=")) {
+      op = FILTER_OP_LE;
+    } else if (accept(">=")) {
+      op = FILTER_OP_GE;
+    } else if (accept("<")) {
+      op = FILTER_OP_LT;
+    } else if (accept(">")) {
+      op = FILTER_OP_GT;
+    } else if (accept("in")) {
+      op = FILTER_OP_IN;
+    } else {
+      return FILTER_NIL;
+    }
+
+    // Identities and types are unordered
+    bool ordered = op != FILTER_OP_EQ && op != FILTER_OP_NE && op != FILTER_OP_IN;
+    if ((ordered && (info.width != 0 || field == FILTER_FIELD_TYPE)) ||
+        filter.predicate_count >= BEACON_FILTER_MAX_PREDICATES) {
+      return FILTER_NIL;
+    }
+
+    Predicate& predicate = filter.predicates[filter.predicate_count];
+    predicate.field = field;
+    predicate.op = op;
+    predicate.count = 0;
+    predicate.first = info.width != 0 ? filter.byte_count : filter.value_count;
+
+    if (op == FILTER_OP_IN) {
+      if (!accept("{")) {
+        return FILTER_NIL;
+      }
+      do {
+        if (!parseConstant(field, predicate)) {
+          return FILTER_NIL;
+        }
+      } while (accept(","));
+      if (!accept("}")) {
+        return FILTER_NIL;
+      }
+      sortSet(predicate);
+    } else if (!parseConstant(field, predicate)) {
+      return FILTER_NIL;
+    }
+
+    return newNode(FILTER_NODE_PREDICATE, filter.predicate_count++, info.cost);
+  }
+
+  bool parseConstant(uint8_t field, Predicate& predicate) {
+    skipSpace();
+    uint8_t width = FILTER_FIELDS[field].width;
+
+    if (width != 0) {
+      // Hex bytes, dashes anywhere between digit pairs
+      if (filter.byte_count + width > BEACON_FILTER_MAX_BYTES) {
+        return false;
+      }
+      uint8_t* out = &filter.bytes[filter.byte_count];
+      uint8_t len = 0;
+      while (hexValue(*p) >= 0 || *p == '-') {
+        if (*p == '-') {
+          p++;
+          continue;
+        }
+        if (hexValue(p[1]) < 0 || len == width) {
+          return false;
+        }
+        out[len++] = (hexValue(p[0]) << 4) | hexValue(p[1]);
+        p += 2;
+      }
+      if (len != width || isNameChar(*p)) {
+        return false;
+      }
+      filter.byte_count += width;
+      predicate.count++;
+      return true;
+    }
+
+    if (filter.value_count >= BEACON_FILTER_MAX_VALUES) {
+      return false;
+    }
+
+    int32_t value;
+    if (field == FILTER_FIELD_TYPE ? !parseTypeName(value) : !parseInteger(value)) {
+      return false;
+    }
+    filter.values[filter.value_count++] = value;
+    predicate.count++;
+    return true;
+  }
+
+  bool parseTypeName(int32_t& value) {
+    const char* name = p;
+    while (isNameChar(*p)) {
+      p++;
+    }
+    for (uint8_t i = 0; i < sizeof(FILTER_TYPE_NAMES) / sizeof(FILTER_TYPE_NAMES[0]); i++) {
+      if (sameName(FILTER_TYPE_NAMES[i].name, name, p)) {
+        value = FILTER_TYPE_NAMES[i].type;
+        return true;
+      }
+    }
+    p = name;
+    return false;
+  }
+
+  // Decimal or 0x hex, optionally negative, within int32_t
+  bool parseInteger(int32_t& value) {
+    bool negative = *p == '-';
+    if (negative) {
+      p++;
+    }
+
+    int64_t magnitude = 0;
+    uint8_t digits = 0;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+      p += 2;
+      for (; hexValue(*p) >= 0 && magnitude <= 0xFFFFFFFFLL; p++, digits++) {
+        magnitude = magnitude * 16 + hexValue(*p);
+      }
+    } else {
+      for (; *p >= '0' && *p <= '9' && magnitude <= 0xFFFFFFFFLL; p++, digits++) {
+        magnitude = magnitude * 10 + (*p - '0');
+      }
+    }
+
+    if (digits == 0 || isNameChar(*p)) {
+      return false;
+    }
+    int64_t result = negative ? -magnitude : magnitude;
+    if (result < -2147483648LL || result > 2147483647LL) {
+      return false;
+    }
+    value = (int32_t)result;
+    return true;
+  }
+
+  // Sorted sets are binary searched at match time
+  void sortSet(const Predicate& predicate) {
+    uint8_t width = FILTER_FIELDS[predicate.field].width;
+
+    for (uint8_t i = 1; i < predicate.count; i++) {
+      if (width == 0) {
+        int32_t* set = &filter.values[predicate.first];
+        int32_t value = set[i];
+        uint8_t j = i;
+        for (; j > 0 && set[j - 1] > value; j--) {
+          set[j] = set[j - 1];
+        }
+        set[j] = value;
+      } else {
+        uint8_t* set = &filter.bytes[predicate.first];
+        uint8_t value[16];
+        memcpy(value, &set[i * width], width);
+        uint8_t j = i;
+        for (; j > 0 && memcmp(&set[(j - 1) * width], value, width) > 0; j--) {
+          memcpy(&set[j * width], &set[(j - 1) * width], width);
+        }
+        memcpy(&set[j * width], value, width);
+      }
+    }
+  }
+
+  // Stable sort of each operand list by cost, innermost lists first
+  void order(uint8_t index) {
+    Node& node = nodes[index];
+    if (node.kind == FILTER_NODE_PREDICATE) {
+      return;
+    }
+    if (node.kind == FILTER_NODE_NOT) {
+      order(node.child);
+      node.cost = nodes[node.child].cost;
+      return;
+    }
+
+    uint8_t sorted = FILTER_NIL;
+    uint8_t operand = node.child;
+    node.cost = 0;
+    while (operand != FILTER_NIL) {
+      uint8_t next = nodes[operand].next;
+      order(operand);
+
+      uint8_t cost = nodes[operand].cost;
+      if (cost > node.cost) {
+        node.cost = cost;
+      }
+
+      if (sorted == FILTER_NIL || nodes[sorted].cost > cost) {
+        nodes[operand].next = sorted;
+        sorted = operand;
+      } else {
+        uint8_t at = sorted;
+        while (nodes[at].next != FILTER_NIL && nodes[nodes[at].next].cost <= cost) {
+          at = nodes[at].next;
+        }
+        nodes[operand].next = nodes[at].next;
+        nodes[at].next = operand;
+      }
+      operand = next;
+    }
+    node.child = sorted;
+  }
+
+  bool push(uint8_t op, uint8_t arg) {
+    if (filter.code_count >= BEACON_FILTER_MAX_CODE) {
+      return false;
+    }
+    filter.code[filter.code_count].op = op;
+    filter.code[filter.code_count].arg = arg;
+    filter.code_count++;
+    return true;
+  }
+
+  bool emit(uint8_t index) {
+    const Node& node = nodes[index];
+    switch (node.kind) {
+      case FILTER_NODE_PREDICATE:
+        return push(FILTER_CODE_TEST, node.arg);
+
+      case FILTER_NODE_NOT:
+        return emit(node.child) && push(FILTER_CODE_NOT, 0);
+
+      default: {
+        uint8_t first = filter.code_count;
+        uint8_t jump =
+          node.kind == FILTER_NODE_AND ? FILTER_CODE_JUMP_FALSE : FILTER_CODE_JUMP_TRUE;
+        for (uint8_t operand = node.child; operand != FILTER_NIL; operand = nodes[operand].next) {
+          if (!emit(operand) ||
+              (nodes[operand].next != FILTER_NIL && !push(jump, FILTER_UNPATCHED))) {
+            return false;
+          }
+        }
+
+        // Nested lists patched their own jumps; the rest exit this list
+        for (uint8_t i = first; i < filter.code_count; i++) {
+          if (filter.code[i].arg == FILTER_UNPATCHED && filter.code[i].op == jump) {
+            filter.code[i].arg = filter.code_count;
+          }
+        }
+        return true;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Packet under test, classified on first use
+ */
+struct BeaconFilter::Packet {
+  BLEBeaconParser& parser;
+  const uint8_t* data;
+  uint16_t len;
+  int8_t rssi;
+  BeaconView& view;
+  uint8_t candidates;
+  bool scanned;
+  bool classified;
+
+  Packet(BLEBeaconParser& packet_parser, const uint8_t* packet_data, uint16_t packet_len,
+         int8_t packet_rssi, BeaconView& packet_view)
+      : parser(packet_parser),
+        data(packet_data),
+        len(packet_len),
+        rssi(packet_rssi),
+        view(packet_view),
+        candidates(0),
+        scanned(false),
+        classified(false) {}
+
+  uint8_t scan() {
+    if (!scanned) {
+      candidates = BeaconPrefilter::scan(data, len);
+      scanned = true;
+    }
+    return candidates;
+  }
+
+  void classify() {
+    if (classified) {
+      return;
+    }
+    classified = true;
+
+    // No signature means no built-in format, so skip tokenizing
+    if (scan() == 0 || !parser.parseView(data, len, view)) {
+      view.clear();
+    }
+  }
+};
+
+BeaconFilter::BeaconFilter()
+    : byte_count(0),
+      error_offset(0),
+      predicate_count(0),
+      value_count(0),
+      code_count(0),
+      compiled(false) {}
+
+BeaconFilter::BeaconFilter(const char* expression) : BeaconFilter() {
+  compile(expression);
+}
+
+bool BeaconFilter::compile(const char* expression) {
+  compiled = false;
+  byte_count = 0;
+  error_offset = 0;
+  predicate_count = 0;
+  value_count = 0;
+  code_count = 0;
+
+  if (expression == nullptr) {
+    return false;
+  }
+
+  Compiler compiler(*this, expression);
+  uint8_t root = compiler.parseList(FILTER_NODE_OR);
+  compiler.skipSpace();
+  if (root == FILTER_NIL || *compiler.p != '\0') {
+    error_offset = compiler.p - expression;
+    return false;
+  }
+
+  compiler.order(root);
+  if (!compiler.emit(root)) {
+    error_offset = compiler.p - expression;
+    return false;
+  }
+
+  compiled = true;
+  return true;
+}
+
+bool BeaconFilter::match(BLEBeaconParser& parser, const uint8_t* data, uint16_t len, int8_t rssi,
+                         BeaconView& view) const {
+  if (!compiled) {
+    view.clear();
+    return false;
+  }
+
+  Packet packet(parser, data, len, rssi, view);
+  bool result = false;
+  uint8_t pc = 0;
+
+  while (pc < code_count) {
+    const Instruction& instruction = code[pc++];
+    switch (instruction.op) {
+      case FILTER_CODE_TEST:
+        result = test(predicates[instruction.arg], packet);
+        break;
+      case FILTER_CODE_NOT:
+        result = !result;
+        break;
+      case FILTER_CODE_JUMP_FALSE:
+        if (!result) {
+          pc = instruction.arg;
+        }
+        break;
+      case FILTER_CODE_JUMP_TRUE:
+        if (result) {
+          pc = instruction.arg;
+        }
+        break;
+    }
+  }
+
+  // Hand the caller a classified view to decode
+  if (result) {
+    packet.classify();
+  }
+  return result;
+}
+
+bool BeaconFilter::match(BLEBeaconParser& parser, const ScanObservation& observation,
+                         BeaconView& view) const {
+  return match(parser, observation.payload, observation.payload_len, observation.rssi, view);
+}
+
+bool BeaconFilter::test(const Predicate& predicate, Packet& packet) const {
+  const FilterFieldInfo& info = FILTER_FIELDS[predicate.field];
+  int64_t value;
+
+  switch (predicate.field) {
+    case FILTER_FIELD_RSSI:
+      if (packet.rssi == SCAN_OBSERVATION_UNAVAILABLE) {
+        return false;
+      }
+      value = packet.rssi;
+      break;
+
+    case FILTER_FIELD_TYPE:
+      if (predicate.op != FILTER_OP_NE) {
+        // Reject on the signature scan when no wanted type can be present
+        uint8_t wanted = 0;
+        for (uint8_t i = 0; i < predicate.count; i++) {
+          wanted |= typeCandidate(values[predicate.first + i]);
+        }
+        if ((packet.scan() & wanted) == 0) {
+          return false;
+        }
+      }
+      packet.classify();
+      value = packet.view.type();
+      break;
+
+    default: {
+      packet.classify();
+      const BeaconView& view = packet.view;
+      if ((info.types & FILTER_TYPE_BIT(view.type())) == 0) {
+        return false;
+      }
+
+      if (info.width != 0) {
+        const uint8_t* field = predicate.field == FILTER_FIELD_INSTANCE ? view.instanceId()
+                                                                         : view.uuidBytes();
+        const uint8_t* set = &bytes[predicate.first];
+        if (predicate.op != FILTER_OP_IN) {
+          bool equal = memcmp(field, set, info.width) == 0;
+          return predicate.op == FILTER_OP_EQ ? equal : !equal;
+        }
+
+        uint8_t low = 0;
+        uint8_t high = predicate.count;
+        while (low < high) {
+          uint8_t mid = (low + high) / 2;
+          int order = memcmp(field, &set[mid * info.width], info.width);
+          if (order == 0) {
+            return true;
+          }
+          if (order < 0) {
+            high = mid;
+          } else {
+            low = mid + 1;
+          }
+        }
+        return false;
+      }
+
+      switch (predicate.field) {
+        case FILTER_FIELD_MAJOR:
+          value = view.major();
+          break;
+        case FILTER_FIELD_MINOR:
+          value = view.minor();
+          break;
+        case FILTER_FIELD_TX_POWER:
+          value = view.txPower();
+          break;
+        case FILTER_FIELD_TLM_BATTERY:
+          value = view.tlmBatteryMv();
+          break;
+        case FILTER_FIELD_TLM_TEMPERATURE:
+          value = view.tlmTemperatureRaw();
+          break;
+        case FILTER_FIELD_TLM_ADV_COUNT:
+          value = view.tlmAdvCount();
+          break;
+        default:
+          value = view.tlmUptimeDeciseconds();
+          break;
+      }
+      break;
+    }
+  }
+
+  // Constants are scaled to packet units (e.g. degrees to 1/256 degrees)
+  const int32_t* set = &values[predicate.first];
+  int64_t constant = (int64_t)set[0] * info.scale;
+
+  switch (predicate.op) {
+    case FILTER_OP_EQ:
+      return value == constant;
+    case FILTER_OP_NE:
+      return value != constant;
+    case FILTER_OP_LT:
+      return value < constant;
+    case FILTER_OP_LE:
+      return value <= constant;
+    case FILTER_OP_GT:
+      return value > constant;
+    case FILTER_OP_GE:
+      return value >= constant;
+    default: {
+      uint8_t low = 0;
+      uint8_t high = predicate.count;
+      while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        int64_t member = (int64_t)set[mid] * info.scale;
+        if (value == member) {
+          return true;
+        }
+        if (value < member) {
+          high = mid;
+        } else {
+          low = mid + 1;
+        }
+      }
+      return false;
+    }
+  }
+}
@@ -0,0 +1,131 @@
+#ifndef BEACON_FILTER_H
+#define BEACON_FILTER_H
+
+#include <stdint.h>
+#include "BLEBeaconParser.h"
+#include "BeaconView.h"
+#include "ScanObservation.h"
+
+// Program limits
+#define BEACON_FILTER_MAX_PREDICATES 16
+#define BEACON_FILTER_MAX_VALUES 32  // Numeric constants, set members included
+#define BEACON_FILTER_MAX_BYTES 256  // Identity constants (sixteen 16-byte UUIDs)
+#define BEACON_FILTER_MAX_CODE 64    // Instructions
+#define BEACON_FILTER_MAX_DEPTH 8    // Nested parentheses and negations
+
+/**
+ * @brief Compiled packet filter evaluated before full decode
+ *
+ * Expressions combine predicates with &&, || and !, with parentheses:
+ * @code
+ * type == ibeacon && uuid in {5F2DD896-B886-4549-AE01-E41ACD7A354A, ...} && rssi > -75
+ * type == eddystone_tlm && tlm.battery < 2600
+ * @endcode
+ *
+ * Fields:
+ * - rssi: packet RSSI (false when unavailable)
+ * - type: ibeacon, altbeacon, eddystone_uid, eddystone_url, eddystone_tlm
+ * - uuid (16 bytes: iBeacon UUID, AltBeacon ID, Eddystone namespace +
+ *   instance), namespace (10 bytes), instance (6 bytes): hex, dashes optional
+ * - major, minor, tx_power
+ * - tlm.battery (mV), tlm.temperature (whole degrees C), tlm.adv_count,
+ *   tlm.uptime (seconds)
+ *
+ * Operators are == != < <= > >= and "in {a, b, ...}"; identity and type
+ * fields take == != and in. A predicate on a field the packet's beacon
+ * type does not carry is false.
+ *
+ * compile() turns the expression into short-circuit bytecode. Operands of
+ * each && / || are reordered cheapest first: RSSI checks need no packet
+ * bytes; type checks first run the BeaconPrefilter signature scan and only
+ * tokenize when it finds a candidate; field checks read single fields from
+ * a BeaconView; identity sets are binary searched last. The packet is
+ * never fully decoded by the filter, so only packets that pass pay for
+ * BeaconView::decode().
+ *
+ * @code
+ * BeaconFilter filter("type == ibeacon && major in {1, 2} && rssi > -75");
+ * BeaconView view;
+ * if (filter.match(parser, adv_data, adv_len, rssi, view)) {
+ *   view.decode(result);
+ * }
+ * @endcode
+ */
+class BeaconFilter {
+ public:
+  BeaconFilter();
+
+  /**
+   * @brief Construct and compile a filter (check valid() for errors)
+   */
+  explicit BeaconFilter(const char* expression);
+
+  /**
+   * @brief Compile a filter expression
+   * @return true if compiled, false on a syntax error or a program limit being exceeded
+   */
+  bool compile(const char* expression);
+
+  /**
+   * @brief Test a packet against the filter
+   * @param parser Parser used to classify the packet (only if a predicate needs it)
+   * @param data Raw advertisement data
+   * @param len Length of advertisement data
+   * @param rssi Received signal strength (SCAN_OBSERVATION_UNAVAILABLE if unknown)
+   * @param view Set to the classified packet on a match (invalid if no built-in format)
+   * @return true if the packet passes; false if it fails or the filter is not compiled
+   */
+  bool match(BLEBeaconParser& parser, const uint8_t* data, uint16_t len, int8_t rssi,
+             BeaconView& view) const;
+
+  /**
+   * @brief Test an observation's payload and RSSI against the filter
+   */
+  bool match(BLEBeaconParser& parser, const ScanObservation& observation, BeaconView& view) const;
+
+  bool valid() const {
+    return compiled;
+  }
+
+  /**
+   * @brief Offset in the expression where compilation failed
+   */
+  uint16_t errorOffset() const {
+    return error_offset;
+  }
+
+  uint8_t predicateCount() const {
+    return predicate_count;
+  }
+
+ private:
+  struct Predicate {
+    uint8_t field;
+    uint8_t op;
+    uint8_t count;   // Constants compared against (1 unless op is "in")
+    uint16_t first;  // Index of the first constant in values / bytes
+  };
+
+  struct Instruction {
+    uint8_t op;
+    uint8_t arg;
+  };
+
+  struct Compiler;
+  struct Packet;
+
+  bool test(const Predicate& predicate, Packet& packet) const;
+
+  Predicate predicates[BEACON_FILTER_MAX_PREDICATES];
+  int32_t values[BEACON_FILTER_MAX_VALUES];
+  uint8_t bytes[BEACON_FILTER_MAX_BYTES];
+  Instruction code[BEACON_FILTER_MAX_CODE];
+  uint16_t byte_count;
+  uint16_t error_offset;
+  uint8_t predicate_count;
+  uint8_t value_count;
+  uint8_t code_count;
+  bool compiled;
+};
+
+#endif  // BEACON_FILTER_H
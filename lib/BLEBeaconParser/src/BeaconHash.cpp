@@ -0,0 +1,183 @@
+#include "BeaconHash.h"
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BEACON_HASH_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__ARM_FEATURE_CRC32)
+#define BEACON_HASH_ARM 1
+#include <arm_acle.h>
+#endif
+
+// Lane seeds: distinct so identical words in the two lanes hash differently
+#define HASH_SEED_A 0xFFFFFFFFu
+#define HASH_SEED_B 0x9E3779B9u
+
+typedef uint32_t (*CrcFn)(uint32_t crc, const uint8_t* data, uint16_t len);
+typedef uint64_t (*Hash64Fn)(const uint8_t* data, uint16_t len, uint32_t seed);
+
+// CRC32C (reflected polynomial 0x82F63B78), one nibble at a time
+static const uint32_t CRC32C_NIBBLE_TABLE[16] = {
+  0x00000000, 0x105EC76F, 0x20BD8EDE, 0x30E349B1, 0x417B1DBC, 0x5125DAD3,
+  0x61C69362, 0x7198540D, 0x82F63B78, 0x92A8FC17, 0xA24BB5A6, 0xB21572C9,
+  0xC38D26C4, 0xD3D3E1AB, 0xE330A81A, 0xF36E6F75};
+
+static uint32_t crcScalar(uint32_t crc, const uint8_t* data, uint16_t len) {
+  for (uint16_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ CRC32C_NIBBLE_TABLE[crc & 0x0F];
+    crc = (crc >> 4) ^ CRC32C_NIBBLE_TABLE[crc & 0x0F];
+  }
+  return crc;
+}
+
+// Final 64-bit avalanche (MurmurHash3 fmix64)
+static uint64_t mix(uint32_t a, uint32_t b, uint16_t len) {
+  uint64_t h = ((uint64_t)a << 32) | b;
+  h ^= len;
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+uint64_t BeaconHash::hash64Scalar(const uint8_t* data, uint16_t len, uint32_t seed) {
+  uint32_t a = HASH_SEED_A ^ seed;
+  uint32_t b = HASH_SEED_B ^ seed;
+  uint16_t pos = 0;
+
+  // Lane A takes even 8-byte words, lane B odd ones; the tail goes to lane A
+  for (; pos + 16 <= len; pos += 16) {
+    a = crcScalar(a, &data[pos], 8);
+    b = crcScalar(b, &data[pos + 8], 8);
+  }
+  a = crcScalar(a, &data[pos], len - pos);
+
+  return mix(a, b, len);
+}
+
+#if defined(BEACON_HASH_X86)
+
+__attribute__((target("sse4.2"))) static uint32_t crcSSE42(uint32_t crc, const uint8_t* data,
+                                                           uint16_t len) {
+  uint16_t pos = 0;
+  for (; pos + 8 <= len; pos += 8) {
+    uint64_t word;
+    memcpy(&word, &data[pos], 8);
+    crc = (uint32_t)_mm_crc32_u64(crc, word);
+  }
+  for (; pos < len; pos++) {
+    crc = _mm_crc32_u8(crc, data[pos]);
+  }
+  return crc;
+}
+
+__attribute__((target("sse4.2"))) static uint64_t hash64SSE42(const uint8_t* data, uint16_t len,
+                                                             uint32_t seed) {
+  uint32_t a = HASH_SEED_A ^ seed;
+  uint32_t b = HASH_SEED_B ^ seed;
+  uint16_t pos = 0;
+
+  // Two independent crc32 chains overlap in the pipeline
+  for (; pos + 16 <= len; pos += 16) {
+    uint64_t word_a;
+    uint64_t word_b;
+    memcpy(&word_a, &data[pos], 8);
+    memcpy(&word_b, &data[pos + 8], 8);
+    a = (uint32_t)_mm_crc32_u64(a, word_a);
+    b = (uint32_t)_mm_crc32_u64(b, word_b);
+  }
+  a = crcSSE42(a, &data[pos], len - pos);
+
+  return mix(a, b, len);
+}
+
+#elif defined(BEACON_HASH_ARM)
+
+static uint32_t crcARM(uint32_t crc, const uint8_t* data, uint16_t len) {
+  uint16_t pos = 0;
+#if defined(__aarch64__)
+  for (; pos + 8 <= len; pos += 8) {
+    uint64_t word;
+    memcpy(&word, &data[pos], 8);
+    crc = __crc32cd(crc, word);
+  }
+#endif
+  for (; pos + 4 <= len; pos += 4) {
+    uint32_t word;
+    memcpy(&word, &data[pos], 4);
+    crc = __crc32cw(crc, word);
+  }
+  for (; pos < len; pos++) {
+    crc = __crc32cb(crc, data[pos]);
+  }
+  return crc;
+}
+
+static uint64_t hash64ARM(const uint8_t* data, uint16_t len, uint32_t seed) {
+  uint32_t a = HASH_SEED_A ^ seed;
+  uint32_t b = HASH_SEED_B ^ seed;
+  uint16_t pos = 0;
+
+  for (; pos + 16 <= len; pos += 16) {
+    a = crcARM(a, &data[pos], 8);
+    b = crcARM(b, &data[pos + 8], 8);
+  }
+  a = crcARM(a, &data[pos], len - pos);
+
+  return mix(a, b, len);
+}
+
+#endif
+
+struct HashImpl {
+  CrcFn crc;
+  Hash64Fn hash64;
+  const char* name;
+};
+
+static HashImpl selectImpl() {
+  HashImpl impl = {&crcScalar, &BeaconHash::hash64Scalar, "scalar"};
+
+#if defined(BEACON_HASH_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    impl.crc = &crcSSE42;
+    impl.hash64 = &hash64SSE42;
+    impl.name = "sse4.2";
+  }
+#elif defined(BEACON_HASH_ARM)
+  impl.crc = &crcARM;
+  impl.hash64 = &hash64ARM;
+  impl.name = "armv8-crc";
+#endif
+
+  return impl;
+}
+
+static const HashImpl& activeImpl() {
+  // Selected once, on first use
+  static const HashImpl impl = selectImpl();
+  return impl;
+}
+
+uint32_t BeaconHash::crc32c(const uint8_t* data, uint16_t len) {
+  if (data == nullptr) {
+    return 0;
+  }
+  return activeImpl().crc(0xFFFFFFFFu, data, len) ^ 0xFFFFFFFFu;
+}
+
+uint64_t BeaconHash::hash64(const uint8_t* data, uint16_t len, uint32_t seed) {
+  if (data == nullptr) {
+    len = 0;
+    data = (const uint8_t*)"";
+  }
+  return activeImpl().hash64(data, len, seed);
+}
+
+const char* BeaconHash::implementation() {
+  return activeImpl().name;
+}
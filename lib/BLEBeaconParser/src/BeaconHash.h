@@ -0,0 +1,46 @@
+#ifndef BEACON_HASH_H
+#define BEACON_HASH_H
+
+#include <stdint.h>
+
+/**
+ * @brief CRC32C-based hashing for beacon identities and raw payloads
+ *
+ * hash64() runs two independent CRC32C lanes over alternating 8-byte words
+ * and mixes the pair into a 64-bit value. CRC32C uses the SSE4.2 crc32
+ * instruction on x86-64 (selected at runtime) and the ARMv8 CRC extension
+ * when the compiler targets it; other targets, including MCUs, use a small
+ * table-driven software CRC. All implementations produce identical values.
+ */
+class BeaconHash {
+ public:
+  /**
+   * @brief Standard CRC32C (Castagnoli) checksum
+   * @param data Bytes to checksum
+   * @param len Number of bytes
+   * @return CRC32C of data (e.g. 0xE3069283 for "123456789")
+   */
+  static uint32_t crc32c(const uint8_t* data, uint16_t len);
+
+  /**
+   * @brief 64-bit hash of a byte string
+   * @param data Bytes to hash
+   * @param len Number of bytes
+   * @param seed Value mixed into both lanes (e.g. a format tag)
+   * @return 64-bit hash
+   */
+  static uint64_t hash64(const uint8_t* data, uint16_t len, uint32_t seed = 0);
+
+  /**
+   * @brief Portable software implementation of hash64()
+   */
+  static uint64_t hash64Scalar(const uint8_t* data, uint16_t len, uint32_t seed = 0);
+
+  /**
+   * @brief Name of the CRC32C implementation selected for this CPU
+   * @return "sse4.2", "armv8-crc" or "scalar"
+   */
+  static const char* implementation();
+};
+
+#endif  // BEACON_HASH_H
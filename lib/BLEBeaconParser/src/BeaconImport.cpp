@@ -0,0 +1,561 @@
+#include "BeaconImport.h"
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PCAP_MAGIC_MICROSECONDS 0xA1B2C3D4
+#define PCAP_MAGIC_NANOSECONDS 0xA1B23C4D
+#define PCAP_FILE_HEADER_SIZE 24
+#define PCAP_RECORD_HEADER_SIZE 16
+
+#define PCAPNG_SECTION_HEADER 0x0A0D0D0A
+#define PCAPNG_INTERFACE_DESCRIPTION 1
+#define PCAPNG_SIMPLE_PACKET 3
+#define PCAPNG_ENHANCED_PACKET 6
+#define PCAPNG_SECTION_HEADER_SIZE 28  // Smallest section header block
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_OPTION_TSRESOL 9
+
+#define BTSNOOP_FILE_HEADER_SIZE 16
+#define BTSNOOP_RECORD_HEADER_SIZE 24
+#define BTSNOOP_RECEIVED_EVENT 0x03  // Flags: received, command / event
+
+// btsnoop timestamps count microseconds from 0000-01-01
+#define BTSNOOP_UNIX_EPOCH 0x00DCDDB30F2F8000ULL
+
+#define LE_ADVERTISING_ACCESS_ADDRESS 0x8E89BED6
+#define LE_PDU_ADV_EXT_IND 7
+#define LE_PHDR_SIZE 10
+#define LE_PHDR_SIGNAL_VALID 0x0002
+
+// How a record's bytes are framed
+#define IMPORT_LINK_NONE 0
+#define IMPORT_LINK_LE_LL 1
+#define IMPORT_LINK_LE_LL_PHDR 2
+#define IMPORT_LINK_H4 3
+#define IMPORT_LINK_H4_PHDR 4
+#define IMPORT_LINK_HCI_EVENT 5  // Bare HCI event (btsnoop H1)
+
+static uint16_t le16(const uint8_t* data) {
+  return (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+}
+
+static uint32_t le32(const uint8_t* data) {
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+         ((uint32_t)data[3] << 24);
+}
+
+static uint32_t be32(const uint8_t* data) {
+  return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) |
+         (uint32_t)data[3];
+}
+
+uint16_t BeaconImportReader::read16(const uint8_t* data) const {
+  return big_endian ? (uint16_t)(((uint16_t)data[0] << 8) | data[1]) : le16(data);
+}
+
+uint32_t BeaconImportReader::read32(const uint8_t* data) const {
+  return big_endian ? be32(data) : le32(data);
+}
+
+// Timestamp in units of an if_tsresol value to microseconds
+static uint64_t toMicroseconds(uint64_t time, uint8_t resolution) {
+  if (resolution & 0x80) {
+    // Negative power of two
+    uint8_t shift = resolution & 0x7F;
+    if (shift > 32) {
+      time >>= shift - 32;
+      shift = 32;
+    }
+    uint64_t fraction = time & (((uint64_t)1 << shift) - 1);
+    return (time >> shift) * 1000000 + ((fraction * 1000000) >> shift);
+  }
+
+  // Negative power of ten
+  uint64_t scale = 1;
+  if (resolution <= 6) {
+    for (uint8_t digits = resolution; digits < 6; digits++) {
+      scale *= 10;
+    }
+    return time * scale;
+  }
+  if (resolution > 18) {
+    return 0;
+  }
+  for (uint8_t digits = 6; digits < resolution; digits++) {
+    scale *= 10;
+  }
+  return time / scale;
+}
+
+static uint8_t linkFor(uint32_t link_type) {
+  switch (link_type) {
+    case BEACON_IMPORT_LINKTYPE_HCI_H4:
+      return IMPORT_LINK_H4;
+    case BEACON_IMPORT_LINKTYPE_HCI_H4_WITH_PHDR:
+      return IMPORT_LINK_H4_PHDR;
+    case BEACON_IMPORT_LINKTYPE_LE_LL:
+      return IMPORT_LINK_LE_LL;
+    case BEACON_IMPORT_LINKTYPE_LE_LL_WITH_PHDR:
+      return IMPORT_LINK_LE_LL_PHDR;
+    default:
+      return IMPORT_LINK_NONE;
+  }
+}
+
+// RF channel (0-39, by frequency) to channel index
+static uint8_t channelIndex(uint8_t rf_channel) {
+  switch (rf_channel) {
+    case 0:
+      return 37;
+    case 12:
+      return 38;
+    case 39:
+      return 39;
+    default:
+      if (rf_channel < 12) {
+        return rf_channel - 1;
+      }
+      return rf_channel < 39 ? rf_channel - 2 : 0;
+  }
+}
+
+BeaconImportReader::BeaconImportReader() : base(nullptr), mapped(false) {
+  close();
+}
+
+BeaconImportReader::~BeaconImportReader() {
+  close();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+bool BeaconImportReader::open(const char* path) {
+  close();
+
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // The mapping keeps the file open
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  base = (const uint8_t*)mapping;
+  length = (size_t)info.st_size;
+  mapped = true;
+  if (!detect()) {
+    close();
+    return false;
+  }
+
+  posix_madvise(mapping, length, POSIX_MADV_SEQUENTIAL);
+  rewind();
+  return true;
+}
+
+#endif  // __unix__ || __APPLE__
+
+bool BeaconImportReader::open(const uint8_t* data, size_t len) {
+  close();
+
+  base = data;
+  length = len;
+  if (!detect()) {
+    close();
+    return false;
+  }
+
+  rewind();
+  return true;
+}
+
+bool BeaconImportReader::detect() {
+  if (length >= PCAP_FILE_HEADER_SIZE) {
+    uint32_t magic = le32(base);
+    big_endian = magic != PCAP_MAGIC_MICROSECONDS && magic != PCAP_MAGIC_NANOSECONDS;
+    magic = read32(base);
+    if (magic == PCAP_MAGIC_MICROSECONDS || magic == PCAP_MAGIC_NANOSECONDS) {
+      container = BEACON_IMPORT_PCAP;
+      nanoseconds = magic == PCAP_MAGIC_NANOSECONDS;
+      // The top bits of the link type field describe frame check sequences
+      link_type = read32(&base[20]) & 0x0FFFFFFF;
+      pcap_link = linkFor(link_type);
+      first_record = PCAP_FILE_HEADER_SIZE;
+      return true;
+    }
+  }
+
+  if (length >= PCAPNG_SECTION_HEADER_SIZE && le32(base) == PCAPNG_SECTION_HEADER) {
+    big_endian = le32(&base[8]) != PCAPNG_BYTE_ORDER_MAGIC;
+    if (read32(&base[8]) != PCAPNG_BYTE_ORDER_MAGIC) {
+      return false;
+    }
+    container = BEACON_IMPORT_PCAPNG;
+    first_record = 0;
+
+    // Report the first interface's link type if it follows the section header
+    uint32_t section_len = read32(&base[4]);
+    if (section_len <= length - 12 &&
+        read32(&base[section_len]) == PCAPNG_INTERFACE_DESCRIPTION) {
+      link_type = read16(&base[section_len + 8]);
+    }
+    return true;
+  }
+
+  if (length >= BTSNOOP_FILE_HEADER_SIZE && memcmp(base, "btsnoop\0", 8) == 0 &&
+      be32(&base[8]) == 1) {
+    link_type = be32(&base[12]);
+    if (link_type != BEACON_IMPORT_BTSNOOP_H1 && link_type != BEACON_IMPORT_BTSNOOP_H4) {
+      return false;
+    }
+    container = BEACON_IMPORT_BTSNOOP;
+    big_endian = true;
+    first_record = BTSNOOP_FILE_HEADER_SIZE;
+    return true;
+  }
+
+  return false;
+}
+
+bool BeaconImportReader::next(ScanObservation& observation) {
+  for (;;) {
+    if (reports.next(observation)) {
+      return true;
+    }
+
+    Frame frame;
+    if (!nextFrame(frame)) {
+      return false;
+    }
+    if (decodeFrame(frame, observation)) {
+      return true;
+    }
+  }
+}
+
+bool BeaconImportReader::nextFrame(Frame& frame) {
+  if (base == nullptr || offset >= length) {
+    return false;
+  }
+
+  bool found = false;
+  switch (container) {
+    case BEACON_IMPORT_PCAP:
+      found = nextPcap(frame);
+      break;
+    case BEACON_IMPORT_PCAPNG:
+      found = nextPcapng(frame);
+      break;
+    case BEACON_IMPORT_BTSNOOP:
+      found = nextBtsnoop(frame);
+      break;
+  }
+
+  if (found) {
+    frame_count++;
+  } else if (offset < length) {
+    // A record runs past the end of the capture
+    cut_short = true;
+    offset = length;
+  }
+  return found;
+}
+
+bool BeaconImportReader::nextPcap(Frame& frame) {
+  if (length - offset < PCAP_RECORD_HEADER_SIZE) {
+    return false;
+  }
+
+  // Seconds, fraction, captured length, original length
+  const uint8_t* record = &base[offset];
+  uint32_t captured = read32(&record[8]);
+  if (captured > length - offset - PCAP_RECORD_HEADER_SIZE) {
+    return false;
+  }
+
+  uint32_t fraction = read32(&record[4]);
+  frame.data = &record[PCAP_RECORD_HEADER_SIZE];
+  frame.len = captured;
+  frame.time_us = (uint64_t)read32(record) * 1000000 + (nanoseconds ? fraction / 1000 : fraction);
+  frame.link = pcap_link;
+  offset += PCAP_RECORD_HEADER_SIZE + captured;
+  return true;
+}
+
+bool BeaconImportReader::nextPcapng(Frame& frame) {
+  // Blocks: type, total length, body, total length again
+  while (offset < length) {
+    if (length - offset < 12) {
+      return false;
+    }
+
+    const uint8_t* block = &base[offset];
+    if (le32(block) == PCAPNG_SECTION_HEADER) {
+      // Each section sets its own byte order and interfaces
+      if (length - offset < PCAPNG_SECTION_HEADER_SIZE) {
+        return false;
+      }
+      big_endian = le32(&block[8]) != PCAPNG_BYTE_ORDER_MAGIC;
+      if (read32(&block[8]) != PCAPNG_BYTE_ORDER_MAGIC) {
+        return false;
+      }
+      interface_count = 0;
+    }
+
+    uint32_t type = read32(block);
+    uint32_t block_len = read32(&block[4]);
+    if (block_len < 12 || block_len % 4 != 0 || block_len > length - offset) {
+      return false;
+    }
+    offset += block_len;
+
+    if (type == PCAPNG_INTERFACE_DESCRIPTION) {
+      addInterface(block, block_len);
+    } else if (type == PCAPNG_ENHANCED_PACKET && block_len >= 32) {
+      // Interface, timestamp (high, low), captured length, original length
+      uint32_t source_id = read32(&block[8]);
+      uint32_t captured = read32(&block[20]);
+      if (source_id < interface_count && captured <= block_len - 32) {
+        const Interface& source = interfaces[source_id];
+        uint64_t time = ((uint64_t)read32(&block[12]) << 32) | read32(&block[16]);
+        frame.data = &block[28];
+        frame.len = captured;
+        frame.time_us = toMicroseconds(time, source.resolution);
+        frame.link = source.link;
+        return true;
+      }
+    } else if (type == PCAPNG_SIMPLE_PACKET && block_len >= 16 && interface_count > 0) {
+      // Original length only: the packet fills the block, minus padding
+      uint32_t captured = read32(&block[8]);
+      if (captured > block_len - 16) {
+        captured = block_len - 16;
+      }
+      frame.data = &block[12];
+      frame.len = captured;
+      frame.time_us = 0;
+      frame.link = interfaces[0].link;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BeaconImportReader::nextBtsnoop(Frame& frame) {
+  if (length - offset < BTSNOOP_RECORD_HEADER_SIZE) {
+    return false;
+  }
+
+  // Original length, included length, flags, drops, timestamp
+  const uint8_t* record = &base[offset];
+  uint32_t captured = be32(&record[4]);
+  if (captured > length - offset - BTSNOOP_RECORD_HEADER_SIZE) {
+    return false;
+  }
+
+  uint64_t time = ((uint64_t)be32(&record[16]) << 32) | be32(&record[20]);
+  frame.data = &record[BTSNOOP_RECORD_HEADER_SIZE];
+  frame.len = captured;
+  frame.time_us = time > BTSNOOP_UNIX_EPOCH ? time - BTSNOOP_UNIX_EPOCH : 0;
+  if (link_type == BEACON_IMPORT_BTSNOOP_H4) {
+    frame.link = IMPORT_LINK_H4;
+  } else {
+    // H1 records carry no packet type; the flags tell events apart
+    frame.link = (be32(&record[8]) & BTSNOOP_RECEIVED_EVENT) == BTSNOOP_RECEIVED_EVENT
+                   ? IMPORT_LINK_HCI_EVENT
+                   : IMPORT_LINK_NONE;
+  }
+  offset += BTSNOOP_RECORD_HEADER_SIZE + captured;
+  return true;
+}
+
+void BeaconImportReader::addInterface(const uint8_t* block, uint32_t block_len) {
+  if (interface_count == BEACON_IMPORT_MAX_INTERFACES || block_len < 20) {
+    return;
+  }
+
+  // Link type, reserved, snapshot length, then options
+  Interface& source = interfaces[interface_count++];
+  source.link = linkFor(read16(&block[8]));
+  source.resolution = 6;
+
+  uint32_t pos = 16;
+  while (pos + 4 <= block_len - 4) {
+    uint16_t code = read16(&block[pos]);
+    uint16_t option_len = read16(&block[pos + 2]);
+    if (code == 0 || pos + 4 + option_len > block_len - 4) {
+      break;
+    }
+    if (code == PCAPNG_OPTION_TSRESOL && option_len >= 1) {
+      source.resolution = block[pos + 4];
+    }
+    pos += 4 + ((option_len + 3) & ~3);
+  }
+}
+
+bool BeaconImportReader::decodeFrame(const Frame& frame, ScanObservation& observation) {
+  switch (frame.link) {
+    case IMPORT_LINK_LE_LL_PHDR: {
+      // RF channel, signal, noise, access address offenses, reference
+      // access address, flags
+      if (frame.len < LE_PHDR_SIZE ||
+          !decodeLinkLayer(&frame.data[LE_PHDR_SIZE], frame.len - LE_PHDR_SIZE, observation)) {
+        return false;
+      }
+      observation.channel = channelIndex(frame.data[0]);
+      if (le16(&frame.data[8]) & LE_PHDR_SIGNAL_VALID) {
+        observation.rssi = (int8_t)frame.data[1];
+      }
+      observation.timestamp_us = frame.time_us;
+      return true;
+    }
+
+    case IMPORT_LINK_LE_LL:
+      if (!decodeLinkLayer(frame.data, frame.len, observation)) {
+        return false;
+      }
+      observation.timestamp_us = frame.time_us;
+      return true;
+
+    case IMPORT_LINK_H4:
+    case IMPORT_LINK_H4_PHDR: {
+      // The pseudo-header is a 4-byte direction
+      uint32_t skip = frame.link == IMPORT_LINK_H4_PHDR ? 4 : 0;
+      if (frame.len <= skip || frame.data[skip] != HCI_H4_EVENT) {
+        return false;
+      }
+      return beginEvent(&frame.data[skip + 1], frame.len - skip - 1, frame.time_us) &&
+             reports.next(observation);
+    }
+
+    case IMPORT_LINK_HCI_EVENT:
+      return beginEvent(frame.data, frame.len, frame.time_us) && reports.next(observation);
+
+    default:
+      return false;
+  }
+}
+
+// ScanObservation flags per PDU type, as a controller reports them in an
+// extended report: ADV_IND, ADV_NONCONN_IND, SCAN_RSP and ADV_SCAN_IND.
+// ADV_DIRECT_IND, SCAN_REQ and CONNECT_IND carry no advertising data
+static const uint8_t LINK_LAYER_FLAGS[16] = {0x13, 0, 0x10, 0, 0x1A, 0, 0x12};
+
+// Common extended advertising header fields, in order of their flag bits:
+// AdvA, TargetA, CTEInfo, ADI, AuxPtr, SyncInfo, TxPower
+static const uint8_t EXTENDED_FIELD_SIZES[7] = {6, 6, 1, 2, 3, 18, 1};
+
+bool BeaconImportReader::decodeLinkLayer(const uint8_t* pdu, uint32_t len,
+                                         ScanObservation& observation) {
+  // Access address, PDU header (type and address flags, length), payload,
+  // then a CRC that captures may leave out
+  if (len < 6 || le32(pdu) != LE_ADVERTISING_ACCESS_ADDRESS || pdu[5] > len - 6) {
+    return false;
+  }
+
+  uint8_t type = pdu[4] & 0x0F;
+  const uint8_t* payload = &pdu[6];
+  uint8_t payload_len = pdu[5];
+
+  observation.clear();
+  observation.address_type = (pdu[4] >> 6) & 0x01;  // TxAdd
+
+  if (type != LE_PDU_ADV_EXT_IND) {
+    // AdvA, then AdvData
+    if (LINK_LAYER_FLAGS[type] == 0 || payload_len < 6) {
+      return false;
+    }
+    memcpy(observation.address, payload, 6);
+    observation.flags = LINK_LAYER_FLAGS[type];
+    observation.payload = &payload[6];
+    observation.payload_len = payload_len - 6;
+    return true;
+  }
+
+  // Extended header length and mode (connectable, scannable), flags,
+  // fields, then AdvData
+  if (payload_len == 0) {
+    return false;
+  }
+  uint8_t header_len = payload[0] & 0x3F;
+  if (1 + header_len > payload_len) {
+    return false;
+  }
+  observation.flags = payload[0] >> 6;
+
+  if (header_len > 0) {
+    const uint8_t* field = &payload[2];
+    const uint8_t* header_end = &payload[1 + header_len];
+    for (uint8_t bit = 0; bit < sizeof(EXTENDED_FIELD_SIZES); bit++) {
+      if (!(payload[1] & (1 << bit))) {
+        continue;
+      }
+      if (field + EXTENDED_FIELD_SIZES[bit] > header_end) {
+        return false;
+      }
+      if (bit == 0) {
+        memcpy(observation.address, field, 6);
+      } else if (bit == 1) {
+        observation.flags |= SCAN_OBSERVATION_DIRECTED;
+      } else if (bit == 6) {
+        observation.tx_power = (int8_t)*field;
+      }
+      field += EXTENDED_FIELD_SIZES[bit];
+    }
+  }
+
+  // ADV_EXT_IND on the primary channels usually only points at the
+  // auxiliary packet carrying the data
+  observation.payload = &payload[1 + header_len];
+  observation.payload_len = payload_len - 1 - header_len;
+  return observation.payload_len > 0;
+}
+
+bool BeaconImportReader::beginEvent(const uint8_t* event, uint32_t len, uint64_t time_us) {
+  // Events are at most 257 bytes; begin() rejects anything claiming more
+  return reports.begin(event, len > 0xFFFF ? 0xFFFF : (uint16_t)len, time_us);
+}
+
+void BeaconImportReader::rewind() {
+  offset = first_record;
+  reports = HCIReportReader();
+  interface_count = 0;
+  frame_count = 0;
+  cut_short = false;
+}
+
+void BeaconImportReader::close() {
+#if defined(__unix__) || defined(__APPLE__)
+  if (mapped) {
+    munmap((void*)base, length);
+  }
+#endif
+  base = nullptr;
+  length = 0;
+  offset = 0;
+  first_record = 0;
+  reports = HCIReportReader();
+  interface_count = 0;
+  frame_count = 0;
+  link_type = 0;
+  container = BEACON_IMPORT_NONE;
+  pcap_link = IMPORT_LINK_NONE;
+  big_endian = false;
+  nanoseconds = false;
+  mapped = false;
+  cut_short = false;
+}
@@ -0,0 +1,187 @@
+#ifndef BEACON_IMPORT_H
+#define BEACON_IMPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ScanObservation.h"
+#include "adapters/HCIAdapter.h"
+
+// pcap / pcapng link types carrying advertisements
+#define BEACON_IMPORT_LINKTYPE_HCI_H4 187
+#define BEACON_IMPORT_LINKTYPE_HCI_H4_WITH_PHDR 201
+#define BEACON_IMPORT_LINKTYPE_LE_LL 251
+#define BEACON_IMPORT_LINKTYPE_LE_LL_WITH_PHDR 256
+
+// btsnoop datalink types
+#define BEACON_IMPORT_BTSNOOP_H1 1001
+#define BEACON_IMPORT_BTSNOOP_H4 1002
+
+// pcapng interfaces tracked per section (packets on later ones are skipped)
+#define BEACON_IMPORT_MAX_INTERFACES 8
+
+/**
+ * @brief Container format detected by BeaconImportReader
+ */
+enum BeaconImportFormat {
+  BEACON_IMPORT_NONE = 0,
+  BEACON_IMPORT_PCAP = 1,
+  BEACON_IMPORT_PCAPNG = 2,
+  BEACON_IMPORT_BTSNOOP = 3
+};
+
+/**
+ * @brief Streaming reader for third-party sniffer and HCI log captures
+ *
+ * Walks pcap, pcapng and btsnoop files record by record and yields one
+ * ScanObservation per advertisement, with the payload pointing straight
+ * into the capture:
+ * - pcap / pcapng with LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR (nRF Sniffer's
+ *   pcap output) or LINKTYPE_BLUETOOTH_LE_LL: ADV_IND, ADV_NONCONN_IND,
+ *   ADV_SCAN_IND, SCAN_RSP and extended advertising PDUs (AdvA, TxPower
+ *   and AdvData from the common extended header)
+ * - pcap / pcapng with LINKTYPE_BLUETOOTH_HCI_H4(_WITH_PHDR), and btsnoop
+ *   (Android HCI logs, H1 or H4): every report in each LE Advertising
+ *   Report and LE Extended Advertising Report event (see HCIReportReader)
+ *
+ * Other packets (data channel PDUs, scan and connect requests, commands,
+ * other events) are skipped. Timestamps are microseconds since the Unix
+ * epoch; the RF channel and RSSI come from the pseudo-header where the
+ * link type has one.
+ *
+ * The reader is a fixed-size cursor: it never allocates or copies, so
+ * every payload stays valid until close(). open(path) maps the file
+ * (POSIX targets); open(data, len) reads a capture already in memory on
+ * any target.
+ *
+ * @code
+ * BeaconImportReader capture;
+ * ScanObservation observation;
+ * if (capture.open("btsnoop_hci.log")) {
+ *   while (capture.next(observation)) {
+ *     parser.parse(observation, result);
+ *   }
+ * }
+ * @endcode
+ */
+class BeaconImportReader {
+ public:
+  BeaconImportReader();
+  ~BeaconImportReader();
+
+  BeaconImportReader(const BeaconImportReader&) = delete;
+  BeaconImportReader& operator=(const BeaconImportReader&) = delete;
+
+#if defined(__unix__) || defined(__APPLE__)
+  /**
+   * @brief Map a capture file
+   * @return false if the file cannot be mapped or is not a supported capture
+   */
+  bool open(const char* path);
+#endif
+
+  /**
+   * @brief Read a capture held in memory (kept by the caller until close())
+   * @return false if the data is not a supported capture
+   */
+  bool open(const uint8_t* data, size_t len);
+
+  /**
+   * @brief Read the next advertisement
+   * @return false at the end of the capture
+   */
+  bool next(ScanObservation& observation);
+
+  /**
+   * @brief Go back to the first record
+   */
+  void rewind();
+
+  void close();
+
+  BeaconImportFormat format() const {
+    return (BeaconImportFormat)container;
+  }
+
+  /**
+   * @brief Link type of a pcap file or datalink type of a btsnoop file
+   *
+   * pcapng files record a link type per interface; this is the first one.
+   */
+  uint32_t linkType() const {
+    return link_type;
+  }
+
+  /**
+   * @brief Records read so far, including those holding no advertisement
+   */
+  uint64_t frames() const {
+    return frame_count;
+  }
+
+  /**
+   * @brief Whether the capture ended in an incomplete record
+   */
+  bool truncated() const {
+    return cut_short;
+  }
+
+  /**
+   * @brief Capture size in bytes
+   */
+  size_t size() const {
+    return length;
+  }
+
+  /**
+   * @brief Bytes consumed so far, headers included
+   */
+  size_t position() const {
+    return offset;
+  }
+
+ private:
+  struct Interface {
+    uint8_t link;        // How packets on the interface are framed
+    uint8_t resolution;  // pcapng if_tsresol
+  };
+
+  struct Frame {
+    const uint8_t* data;
+    uint32_t len;
+    uint64_t time_us;
+    uint8_t link;
+  };
+
+  bool detect();
+  bool nextFrame(Frame& frame);
+  bool nextPcap(Frame& frame);
+  bool nextPcapng(Frame& frame);
+  bool nextBtsnoop(Frame& frame);
+  void addInterface(const uint8_t* block, uint32_t block_len);
+  bool decodeFrame(const Frame& frame, ScanObservation& observation);
+  bool decodeLinkLayer(const uint8_t* pdu, uint32_t len, ScanObservation& observation);
+  bool beginEvent(const uint8_t* event, uint32_t len, uint64_t time_us);
+  uint16_t read16(const uint8_t* data) const;
+  uint32_t read32(const uint8_t* data) const;
+
+  const uint8_t* base;
+  size_t length;
+  size_t offset;
+  size_t first_record;
+
+  HCIReportReader reports;  // LE Advertising Report event being walked
+
+  Interface interfaces[BEACON_IMPORT_MAX_INTERFACES];
+  uint8_t interface_count;
+
+  uint64_t frame_count;
+  uint32_t link_type;
+  uint8_t container;
+  uint8_t pcap_link;
+  bool big_endian;
+  bool nanoseconds;
+  bool mapped;
+  bool cut_short;
+};
+
+#endif  // BEACON_IMPORT_H
@@ -0,0 +1,61 @@
+#include "BeaconKey.h"
+#include "BeaconHash.h"
+
+void BeaconKey::clear() {
+  memset(bytes, 0, BEACON_KEY_LENGTH);
+  type = BEACON_TYPE_UNKNOWN;
+  len = 0;
+  hash = 0;
+}
+
+void BeaconKey::set(BeaconType format, const uint8_t* identity, uint8_t identity_len) {
+  if (identity_len > BEACON_KEY_LENGTH) {
+    identity_len = BEACON_KEY_LENGTH;
+  }
+
+  memcpy(bytes, identity, identity_len);
+  memset(&bytes[identity_len], 0, BEACON_KEY_LENGTH - identity_len);
+  type = format;
+  len = identity_len;
+  hash = BeaconHash::hash64(bytes, BEACON_KEY_LENGTH, type);
+}
+
+BeaconKey BeaconKey::fromData(const BeaconData& data) {
+  BeaconKey key;
+  uint8_t identity[BEACON_KEY_LENGTH];
+
+  if (!data.valid) {
+    return key;
+  }
+
+  switch (data.type) {
+    case BEACON_TYPE_IBEACON:
+      memcpy(identity, data.ibeacon.uuid, 16);
+      identity[16] = data.ibeacon.major >> 8;
+      identity[17] = data.ibeacon.major & 0xFF;
+      identity[18] = data.ibeacon.minor >> 8;
+      identity[19] = data.ibeacon.minor & 0xFF;
+      key.set(data.type, identity, 20);
+      break;
+
+    case BEACON_TYPE_ALTBEACON:
+      memcpy(identity, data.altbeacon.id, 16);
+      identity[16] = data.altbeacon.major >> 8;
+      identity[17] = data.altbeacon.major & 0xFF;
+      identity[18] = data.altbeacon.minor >> 8;
+      identity[19] = data.altbeacon.minor & 0xFF;
+      key.set(data.type, identity, 20);
+      break;
+
+    case BEACON_TYPE_EDDYSTONE_UID:
+      memcpy(identity, data.eddystone_uid.namespace_id, 10);
+      memcpy(&identity[10], data.eddystone_uid.instance_id, 6);
+      key.set(data.type, identity, 16);
+      break;
+
+    default:
+      break;
+  }
+
+  return key;
+}
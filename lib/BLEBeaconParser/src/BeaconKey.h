@@ -0,0 +1,67 @@
+#ifndef BEACON_KEY_H
+#define BEACON_KEY_H
+
+#include <stdint.h>
+#include <string.h>
+#include "BeaconData.h"
+
+// Identity bytes in a BeaconKey
+#define BEACON_KEY_LENGTH 20
+
+/**
+ * @brief Canonical beacon identity with a precomputed hash
+ *
+ * Identity bytes per format (zero padded to BEACON_KEY_LENGTH):
+ * - iBeacon: UUID (16) + major (2, big-endian) + minor (2, big-endian)
+ * - AltBeacon: beacon ID (16) + major (2, big-endian) + minor (2, big-endian)
+ * - Eddystone-UID: namespace (10) + instance (6)
+ *
+ * Other types carry no identity fields; their keys are empty (valid() is
+ * false). The hash covers the identity bytes and the format tag, so maps,
+ * dedup sets and shard routers can use it directly.
+ */
+struct BeaconKey {
+  uint64_t hash;                     // BeaconHash::hash64 of bytes, seeded with type
+  uint8_t bytes[BEACON_KEY_LENGTH];  // Identity bytes
+  uint8_t type;                      // BeaconType format tag
+  uint8_t len;                       // Identity bytes in use (0 for an empty key)
+
+  BeaconKey() {
+    clear();
+  }
+
+  /**
+   * @brief Reset to the empty key
+   */
+  void clear();
+
+  /**
+   * @brief Set the identity and compute the hash
+   * @param format Beacon type
+   * @param identity Identity bytes
+   * @param identity_len Number of identity bytes (at most BEACON_KEY_LENGTH)
+   */
+  void set(BeaconType format, const uint8_t* identity, uint8_t identity_len);
+
+  /**
+   * @brief Build the key for a parsed beacon
+   * @param data Parsed beacon
+   * @return Key, empty if the beacon is invalid or has no identity fields
+   */
+  static BeaconKey fromData(const BeaconData& data);
+
+  bool valid() const {
+    return len != 0;
+  }
+
+  bool operator==(const BeaconKey& other) const {
+    return hash == other.hash && type == other.type && len == other.len &&
+           memcmp(bytes, other.bytes, BEACON_KEY_LENGTH) == 0;
+  }
+
+  bool operator!=(const BeaconKey& other) const {
+    return !(*this == other);
+  }
+};
+
+#endif  // BEACON_KEY_H
@@ -0,0 +1,261 @@
+#include "BeaconLayout.h"
+#include <string.h>
+
+// Layout offsets count the 2-byte company ID / service UUID
+#define BEACON_LAYOUT_ID_LENGTH 2
+
+static bool parseNumber(const char*& p, uint8_t& out) {
+  if (*p < '0' || *p > '9') {
+    return false;
+  }
+
+  uint16_t value = 0;
+  while (*p >= '0' && *p <= '9') {
+    value = value * 10 + (*p - '0');
+    if (value > 255) {
+      return false;
+    }
+    p++;
+  }
+
+  out = (uint8_t)value;
+  return true;
+}
+
+static int8_t hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+static uint32_t readValue(const uint8_t* bytes, uint8_t width, bool little_endian) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < width; i++) {
+    value = (value << 8) | bytes[little_endian ? width - 1 - i : i];
+  }
+  return value;
+}
+
+BeaconLayout::BeaconLayout()
+    : step_count(0),
+      match_offset(0),
+      match_len(0),
+      min_len(0),
+      ad_type(AD_TYPE_MANUFACTURER_SPECIFIC_DATA),
+      key_id(0),
+      compiled(false) {}
+
+BeaconLayout::BeaconLayout(const char* layout, uint16_t id) : BeaconLayout() {
+  compile(layout, id);
+}
+
+bool BeaconLayout::compile(const char* layout, uint16_t id) {
+  compiled = false;
+  step_count = 0;
+  match_len = 0;
+  match_offset = 0;
+  min_len = 0;
+  ad_type = AD_TYPE_MANUFACTURER_SPECIFIC_DATA;
+  key_id = id;
+
+  if (layout == nullptr) {
+    return false;
+  }
+
+  const char* p = layout;
+  uint8_t end_max = 0;
+
+  while (*p != '\0') {
+    // kind:start-end
+    char kind = *p++;
+    uint8_t start;
+    uint8_t end;
+    if (*p++ != ':' || !parseNumber(p, start) || *p++ != '-' || !parseNumber(p, end) ||
+        end < start) {
+      return false;
+    }
+
+    bool little_endian = false;
+    if (*p == 'l') {
+      little_endian = true;
+      p++;
+    }
+
+    // Optional =hex value (matchers only)
+    uint8_t value[BEACON_LAYOUT_MAX_MATCH];
+    uint8_t value_len = 0;
+    if (*p == '=') {
+      p++;
+      while (hexValue(p[0]) >= 0 && hexValue(p[1]) >= 0) {
+        if (value_len >= BEACON_LAYOUT_MAX_MATCH) {
+          return false;
+        }
+        value[value_len++] = (hexValue(p[0]) << 4) | hexValue(p[1]);
+        p += 2;
+      }
+    }
+
+    if (*p == ',') {
+      p++;
+    } else if (*p != '\0') {
+      return false;
+    }
+
+    uint8_t width = end - start + 1;
+
+    if (kind == 's') {
+      // Service UUID: written as the 16-bit UUID value (e.g. feaa)
+      if (start != 0 || end != 1 || value_len != 2) {
+        return false;
+      }
+      ad_type = AD_TYPE_SERVICE_DATA;
+      key_id = (value[0] << 8) | value[1];
+      continue;
+    }
+
+    // All other terms address the payload after the ID
+    if (start < BEACON_LAYOUT_ID_LENGTH || step_count >= BEACON_LAYOUT_MAX_STEPS) {
+      return false;
+    }
+
+    switch (kind) {
+      case BEACON_LAYOUT_MATCH:
+        if (match_len != 0 || value_len != width) {
+          return false;
+        }
+        memcpy(match, value, value_len);
+        match_len = value_len;
+        match_offset = start - BEACON_LAYOUT_ID_LENGTH;
+        break;
+
+      case BEACON_LAYOUT_IDENTIFIER:
+        break;
+
+      case BEACON_LAYOUT_POWER:
+        if (width != 1) {
+          return false;
+        }
+        break;
+
+      case BEACON_LAYOUT_DATA:
+        if (width > 4) {
+          return false;
+        }
+        break;
+
+      default:
+        return false;
+    }
+
+    if (end > end_max) {
+      end_max = end;
+    }
+
+    // The matcher is compared up front rather than run as a step
+    if (kind == BEACON_LAYOUT_MATCH) {
+      continue;
+    }
+
+    if (value_len != 0) {
+      return false;
+    }
+
+    Step& step = steps[step_count++];
+    step.kind = kind;
+    step.offset = start - BEACON_LAYOUT_ID_LENGTH;
+    step.width = width;
+    step.little_endian = little_endian;
+  }
+
+  if (step_count == 0) {
+    return false;
+  }
+
+  // Every term lies within the first min_len payload bytes, so one length
+  // check per packet covers them all
+  min_len = end_max + 1 - BEACON_LAYOUT_ID_LENGTH;
+
+  uint8_t identifiers = 0;
+  uint8_t data = 0;
+  for (uint8_t i = 0; i < step_count; i++) {
+    identifiers += steps[i].kind == BEACON_LAYOUT_IDENTIFIER;
+    data += steps[i].kind == BEACON_LAYOUT_DATA;
+  }
+  if (identifiers > BEACON_LAYOUT_MAX_IDENTIFIERS || data > BEACON_LAYOUT_MAX_DATA) {
+    return false;
+  }
+
+  compiled = true;
+  return true;
+}
+
+bool BeaconLayout::matches(const ADField& field) const {
+  if (!compiled || field.len < min_len) {
+    return false;
+  }
+
+  return memcmp(&field.data[match_offset], match, match_len) == 0;
+}
+
+bool BeaconLayout::extract(const ADField& field, BeaconLayoutValues& values) const {
+  values.identifier_count = 0;
+  values.data_count = 0;
+  values.power = 0;
+
+  if (!matches(field)) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < step_count; i++) {
+    const Step& step = steps[i];
+    const uint8_t* bytes = &field.data[step.offset];
+
+    switch (step.kind) {
+      case BEACON_LAYOUT_IDENTIFIER: {
+        BeaconLayoutValue& value = values.identifiers[values.identifier_count++];
+        value.bytes = bytes;
+        value.width = step.width;
+        value.value = step.width <= 4 ? readValue(bytes, step.width, step.little_endian) : 0;
+        break;
+      }
+
+      case BEACON_LAYOUT_DATA: {
+        BeaconLayoutValue& value = values.data[values.data_count++];
+        value.bytes = bytes;
+        value.width = step.width;
+        value.value = readValue(bytes, step.width, step.little_endian);
+        break;
+      }
+
+      case BEACON_LAYOUT_POWER:
+        values.power = (int8_t)bytes[0];
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
+
+BeaconSignature BeaconLayout::signature() const {
+  BeaconSignature signature;
+  signature.ad_type = ad_type;
+  signature.id = key_id;
+  signature.prefix_len = 0;
+
+  if (match_offset == 0 && match_len <= BEACON_SIGNATURE_MAX_PREFIX) {
+    memcpy(signature.prefix, match, match_len);
+    signature.prefix_len = match_len;
+  }
+
+  return signature;
+}
@@ -0,0 +1,140 @@
+#ifndef BEACON_LAYOUT_H
+#define BEACON_LAYOUT_H
+
+#include <stdint.h>
+#include "ADStructures.h"
+#include "BeaconDispatch.h"
+
+// Plan limits
+#define BEACON_LAYOUT_MAX_STEPS 10
+#define BEACON_LAYOUT_MAX_MATCH 4
+#define BEACON_LAYOUT_MAX_IDENTIFIERS 4
+#define BEACON_LAYOUT_MAX_DATA 4
+
+// Step kinds (the layout term letters)
+#define BEACON_LAYOUT_MATCH 'm'
+#define BEACON_LAYOUT_IDENTIFIER 'i'
+#define BEACON_LAYOUT_POWER 'p'
+#define BEACON_LAYOUT_DATA 'd'
+
+/**
+ * @brief One field extracted by a layout
+ */
+struct BeaconLayoutValue {
+  const uint8_t* bytes;  // Field bytes inside the packet
+  uint32_t value;        // Integer value for fields up to 4 bytes wide, 0 otherwise
+  uint8_t width;         // Field width in bytes
+};
+
+/**
+ * @brief Fields extracted by BeaconLayout::extract, in layout order per kind
+ */
+struct BeaconLayoutValues {
+  BeaconLayoutValue identifiers[BEACON_LAYOUT_MAX_IDENTIFIERS];
+  BeaconLayoutValue data[BEACON_LAYOUT_MAX_DATA];
+  uint8_t identifier_count;
+  uint8_t data_count;
+  int8_t power;  // Calibrated TX power / reference RSSI (0 without a p term)
+};
+
+/**
+ * @brief Compiled beacon layout expression
+ *
+ * Layouts use the notation of the AltBeacon reference library: comma
+ * separated terms "kind:start-end[l][=hex]" with byte offsets counted from
+ * the company ID (manufacturer data) or service UUID (service data).
+ * - m:2-3=beac  bytes that must match (manufacturer data)
+ * - s:0-1=feaa  16-bit service UUID (makes the layout service data)
+ * - i:4-19      identifier
+ * - p:24-24     calibrated power (signed byte)
+ * - d:25-25     data field
+ * An "l" after the range marks a little-endian field; big-endian is the default.
+ *
+ * compile() runs once and turns the string into a fixed plan of
+ * (kind, offset, width, endianness) steps plus the matcher bytes and the
+ * minimum payload length. extract() then checks the length once, compares
+ * the matcher and walks the steps; no per-field bounds checks remain.
+ *
+ * @code
+ * BeaconLayout ibeacon;
+ * ibeacon.compile("m:2-3=0215,i:4-19,i:20-21,i:22-23,p:24-24", 0x004C);
+ * @endcode
+ */
+class BeaconLayout {
+ public:
+  BeaconLayout();
+
+  /**
+   * @brief Construct and compile a layout (check valid() for errors)
+   */
+  BeaconLayout(const char* layout, uint16_t id = 0);
+
+  /**
+   * @brief Compile a layout expression into an extraction plan
+   * @param layout Layout expression
+   * @param id Company ID for manufacturer data layouts (ignored when the layout has an s term)
+   * @return true if compiled, false on a syntax error or a plan limit being exceeded
+   */
+  bool compile(const char* layout, uint16_t id = 0);
+
+  /**
+   * @brief Check a field's length and matcher bytes without extracting
+   * @param field Field matching adType() and id()
+   */
+  bool matches(const ADField& field) const;
+
+  /**
+   * @brief Run the plan over a field
+   * @param field Field matching adType() and id()
+   * @param values Extracted fields (pointing into the packet)
+   * @return true if the field matched the layout
+   */
+  bool extract(const ADField& field, BeaconLayoutValues& values) const;
+
+  /**
+   * @brief Dispatch signature for registering the layout with BLEBeaconParser::addFormat
+   *
+   * The prefix holds the matcher bytes when they start the payload and fit
+   * BEACON_SIGNATURE_MAX_PREFIX; otherwise the decoder must check them.
+   */
+  BeaconSignature signature() const;
+
+  bool valid() const {
+    return compiled;
+  }
+
+  uint8_t adType() const {
+    return ad_type;
+  }
+
+  uint16_t id() const {
+    return key_id;
+  }
+
+  /**
+   * @brief Payload bytes (after the ID) a matching field must have
+   */
+  uint8_t minLength() const {
+    return min_len;
+  }
+
+ private:
+  struct Step {
+    uint8_t kind;
+    uint8_t offset;  // Payload offset (after the ID)
+    uint8_t width;
+    uint8_t little_endian;
+  };
+
+  Step steps[BEACON_LAYOUT_MAX_STEPS];
+  uint8_t match[BEACON_LAYOUT_MAX_MATCH];
+  uint8_t step_count;
+  uint8_t match_offset;
+  uint8_t match_len;
+  uint8_t min_len;
+  uint8_t ad_type;
+  uint16_t key_id;
+  bool compiled;
+};
+
+#endif  // BEACON_LAYOUT_H
@@ -0,0 +1,81 @@
+#include "BeaconParseCache.h"
+#include <string.h>
+#include "BeaconHash.h"
+
+BeaconParseCache::BeaconParseCache(Entry* storage, uint16_t capacity)
+    : entries(storage), slot_mask(capacity - 1), hit_count(0), miss_count(0), eviction_count(0) {}
+
+void BeaconParseCache::clear() {
+  for (uint16_t i = 0; i <= slot_mask; i++) {
+    entries[i].len = 0;
+    entries[i].referenced = 0;
+    entries[i].hand = 0;
+  }
+  hit_count = 0;
+  miss_count = 0;
+  eviction_count = 0;
+}
+
+uint32_t BeaconParseCache::hashPacket(const uint8_t* data, uint16_t len) {
+  return (uint32_t)BeaconHash::hash64(data, len);
+}
+
+const BeaconParseCache::Entry* BeaconParseCache::lookup(const uint8_t* data, uint16_t len,
+                                                        uint32_t hash) {
+  uint16_t slot = hash & slot_mask;
+
+  // Entries can be evicted anywhere in the window, so always scan all of it
+  for (uint8_t probe = 0; probe < BEACON_PARSE_CACHE_PROBE; probe++) {
+    Entry& entry = entries[(slot + probe) & slot_mask];
+    if (entry.len == len && entry.hash == hash && memcmp(entry.packet, data, len) == 0) {
+      entry.referenced = 1;
+      hit_count++;
+      return &entry;
+    }
+  }
+
+  miss_count++;
+  return nullptr;
+}
+
+BeaconParseCache::Entry* BeaconParseCache::insert(const uint8_t* data, uint16_t len,
+                                                  uint32_t hash) {
+  if (len == 0 || len > BEACON_PARSE_CACHE_PACKET_SIZE) {
+    return nullptr;
+  }
+
+  uint16_t slot = hash & slot_mask;
+  Entry* victim = nullptr;
+
+  for (uint8_t probe = 0; probe < BEACON_PARSE_CACHE_PROBE; probe++) {
+    Entry& entry = entries[(slot + probe) & slot_mask];
+    if (entry.len == 0) {
+      victim = &entry;
+      break;
+    }
+  }
+
+  if (victim == nullptr) {
+    // CLOCK over the window: the hand resumes where the last eviction left
+    // it and clears reference bits until an unreferenced entry comes round
+    Entry& home = entries[slot];
+    uint8_t hand = home.hand;
+    for (uint8_t step = 0; step < 2 * BEACON_PARSE_CACHE_PROBE; step++) {
+      Entry& entry = entries[(slot + hand) & slot_mask];
+      hand = (hand + 1) % BEACON_PARSE_CACHE_PROBE;
+      if (!entry.referenced) {
+        victim = &entry;
+        break;
+      }
+      entry.referenced = 0;
+    }
+    home.hand = hand;
+    eviction_count++;
+  }
+
+  memcpy(victim->packet, data, len);
+  victim->len = len;
+  victim->hash = hash;
+  victim->referenced = 0;
+  return victim;
+}
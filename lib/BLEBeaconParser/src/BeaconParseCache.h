@@ -0,0 +1,138 @@
+#ifndef BEACON_PARSE_CACHE_H
+#define BEACON_PARSE_CACHE_H
+
+#include <stdint.h>
+#include "BeaconData.h"
+
+// Longest advertisement the cache stores (legacy advertising data)
+#define BEACON_PARSE_CACHE_PACKET_SIZE 31
+
+// Slots examined per lookup, starting at the packet's home slot
+#define BEACON_PARSE_CACHE_PROBE 4
+
+/**
+ * @brief Cache of parse results keyed on the raw advertisement bytes
+ *
+ * Fixed beacons repeat byte-identical advertisements many times per
+ * second. With a cache set on BLEBeaconParser, a repeated packet is found
+ * by a hash of its bytes plus a memcmp, and the stored BeaconData (or the
+ * stored position of its field, for parseView) is returned without
+ * tokenizing or decoding. Packets that did not parse are cached too.
+ *
+ * The table is open-addressed: a packet lives in one of
+ * BEACON_PARSE_CACHE_PROBE consecutive slots after its home slot. When all
+ * of them are taken, the window's CLOCK hand, kept in the home slot, sweeps
+ * on from where it last stopped: referenced entries lose their bit and are
+ * passed over, and the first unreferenced one is evicted.
+ *
+ * Storage is provided by BeaconParseCacheBuffer. Not thread-safe; use one
+ * cache per parser and thread.
+ */
+class BeaconParseCache {
+ public:
+  /**
+   * @brief Cached parse of one advertisement
+   */
+  struct Entry {
+    BeaconData result;                               // Result returned by parse()
+    uint32_t hash;                                   // Hash of the packet bytes
+    uint8_t packet[BEACON_PARSE_CACHE_PACKET_SIZE];  // Packet bytes
+    uint8_t len;                                     // Packet length (0 marks an empty slot)
+    uint8_t referenced;                              // CLOCK reference bit
+    uint8_t hand;                                    // CLOCK hand of the window homed here
+    uint8_t parsed;                                  // parse() return value
+    uint8_t view_type;                               // BeaconType reported by parseView()
+    uint8_t field_offset;                            // Matched field data offset in the packet
+    uint8_t field_len;                               // Matched field length
+    uint8_t field_type;                              // Matched field AD type
+    uint16_t field_id;                               // Matched field company ID / service UUID
+  };
+
+  /**
+   * @brief Hash used to key packets
+   */
+  static uint32_t hashPacket(const uint8_t* data, uint16_t len);
+
+  /**
+   * @brief Find a cached packet
+   * @param data Packet bytes
+   * @param len Packet length
+   * @param hash hashPacket(data, len)
+   * @return Entry for identical bytes, or nullptr (counts a hit or a miss)
+   */
+  const Entry* lookup(const uint8_t* data, uint16_t len, uint32_t hash);
+
+  /**
+   * @brief Claim a slot for a packet, evicting if necessary
+   *
+   * The packet bytes, length and hash are stored; the caller fills the
+   * parse result fields.
+   *
+   * @return Entry to fill, or nullptr if the packet is too long to cache
+   */
+  Entry* insert(const uint8_t* data, uint16_t len, uint32_t hash);
+
+  /**
+   * @brief Drop all entries and reset the counters
+   */
+  void clear();
+
+  uint32_t hits() const {
+    return hit_count;
+  }
+
+  uint32_t misses() const {
+    return miss_count;
+  }
+
+  uint32_t evictions() const {
+    return eviction_count;
+  }
+
+  uint16_t capacity() const {
+    return slot_mask + 1;
+  }
+
+ protected:
+  /**
+   * @param storage Array of capacity entries
+   * @param capacity Number of entries (power of two, at least BEACON_PARSE_CACHE_PROBE)
+   */
+  BeaconParseCache(Entry* storage, uint16_t capacity);
+
+  // Entries live in the derived storage, so the cache must not be copied
+  BeaconParseCache(const BeaconParseCache&) = delete;
+  BeaconParseCache& operator=(const BeaconParseCache&) = delete;
+
+ private:
+  Entry* entries;
+  uint16_t slot_mask;
+  uint32_t hit_count;
+  uint32_t miss_count;
+  uint32_t eviction_count;
+};
+
+/**
+ * @brief BeaconParseCache with inline storage for N entries
+ *
+ * @code
+ * static BeaconParseCacheBuffer<64> cache;
+ * parser.setCache(&cache);
+ * @endcode
+ */
+template <uint16_t N>
+class BeaconParseCacheBuffer : public BeaconParseCache {
+  static_assert(N >= BEACON_PARSE_CACHE_PROBE && (N & (N - 1)) == 0,
+                "Cache size must be a power of two of at least BEACON_PARSE_CACHE_PROBE");
+
+ public:
+  BeaconParseCacheBuffer() : BeaconParseCache(storage, N) {
+    // Storage is constructed after the base class, so empty it here
+    clear();
+  }
+
+ private:
+  Entry storage[N];
+};
+
+#endif  // BEACON_PARSE_CACHE_H
@@ -0,0 +1,410 @@
+#include "BeaconPipeline.h"
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <thread>
+#include "BLEBeaconParser.h"
+#include "BeaconHash.h"
+#include "BeaconParseCache.h"
+#include "BeaconView.h"
+
+// Keeps fields written by different threads on separate cache lines
+#define PIPELINE_CACHE_LINE 64
+
+// Empty passes a worker spins through before sleeping
+#define PIPELINE_IDLE_SPINS 64
+
+// Sleep between empty passes once spinning stops
+#define PIPELINE_IDLE_SLEEP_NS 50000
+
+/**
+ * @brief Queued scan report, sized for extended advertising data
+ *
+ * ScanRingSlot with room for a whole HCI extended report's data.
+ */
+struct PipelineReport {
+  uint64_t timestamp_us;
+  uint8_t data[BEACON_PIPELINE_DATA_SIZE];
+  uint16_t len;
+  int8_t rssi;
+  uint8_t address_type;
+  uint8_t address[6];
+  uint8_t channel;
+  int8_t tx_power;
+  uint8_t flags;
+
+  ScanObservation observation() const {
+    ScanObservation result;
+    result.payload = data;
+    result.payload_len = len;
+    result.timestamp_us = timestamp_us;
+    memcpy(result.address, address, sizeof(address));
+    result.address_type = address_type;
+    result.rssi = rssi;
+    result.channel = channel;
+    result.tx_power = tx_power;
+    result.flags = flags;
+    return result;
+  }
+};
+
+/**
+ * @brief Ingress queue slot (bounded MPSC queue with per-slot sequence numbers)
+ *
+ * sequence == position: free for the producer that claims position.
+ * sequence == position + 1: filled, ready for the consumer.
+ */
+struct PipelineSlot {
+  uint32_t sequence;
+  PipelineReport report;
+};
+
+struct BeaconPipelineShard {
+  PipelineSlot* slots;
+  BeaconTrackerBuffer<BEACON_PIPELINE_SHARD_BEACONS>* tracker;
+  uint32_t slot_mask;
+  uint8_t pad0[PIPELINE_CACHE_LINE];
+  uint32_t enqueue_pos;  // Claimed by producers with CAS
+  uint8_t pad1[PIPELINE_CACHE_LINE];
+  uint32_t claimed;      // Non-zero while a worker drains the shard
+  uint32_t dequeue_pos;  // Only touched by the claiming worker
+  uint64_t processed;    // Written by the claiming worker, read by stats
+  uint8_t pad2[PIPELINE_CACHE_LINE];
+};
+
+struct BeaconPipelineWorker {
+  std::thread thread;
+  BLEBeaconParser parser;
+  BeaconParseCacheBuffer<BEACON_PIPELINE_PARSE_CACHE> cache;
+  uint64_t steals;
+  uint16_t next_victim;
+};
+
+static uint16_t roundUpPow2(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value && result < 32768) {
+    result <<= 1;
+  }
+  return (uint16_t)result;
+}
+
+static uint32_t monotonicMs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+BeaconPipeline::BeaconPipeline(const BeaconPipelineConfig& config)
+    : settings(config), stopping(0), running(false), drop_count(0) {
+  // One worker per CPU, at most 255 so the count fits worker_count
+  uint32_t cpus = std::thread::hardware_concurrency();
+  if (cpus == 0) {
+    cpus = 1;
+  } else if (cpus > 255) {
+    cpus = 255;
+  }
+  worker_count = settings.workers != 0 ? settings.workers : (uint8_t)cpus;
+  if (settings.batch == 0) {
+    settings.batch = 1;
+  }
+
+  uint16_t shard_count = roundUpPow2(settings.shards > worker_count ? settings.shards
+                                                                     : worker_count);
+  uint16_t queue_slots = roundUpPow2(settings.queue_slots > 2 ? settings.queue_slots : 2);
+  shard_mask = shard_count - 1;
+
+  shards = new BeaconPipelineShard[shard_count];
+  for (uint16_t s = 0; s < shard_count; s++) {
+    BeaconPipelineShard& shard = shards[s];
+    shard.slots = new PipelineSlot[queue_slots];
+    shard.tracker = new BeaconTrackerBuffer<BEACON_PIPELINE_SHARD_BEACONS>();
+    shard.slot_mask = queue_slots - 1;
+    shard.enqueue_pos = 0;
+    shard.claimed = 0;
+    shard.dequeue_pos = 0;
+    shard.processed = 0;
+    for (uint32_t i = 0; i < queue_slots; i++) {
+      shard.slots[i].sequence = i;
+    }
+  }
+
+  workers = new BeaconPipelineWorker[worker_count];
+  for (uint8_t w = 0; w < worker_count; w++) {
+    workers[w].parser.setCache(&workers[w].cache);
+    workers[w].steals = 0;
+    workers[w].next_victim = w;
+  }
+}
+
+BeaconPipeline::~BeaconPipeline() {
+  stop();
+  for (uint16_t s = 0; s <= shard_mask; s++) {
+    delete[] shards[s].slots;
+    delete shards[s].tracker;
+  }
+  delete[] shards;
+  delete[] workers;
+}
+
+bool BeaconPipeline::start() {
+  if (running) {
+    return false;
+  }
+
+  __atomic_store_n(&stopping, 0, __ATOMIC_RELEASE);
+  for (uint8_t w = 0; w < worker_count; w++) {
+    workers[w].thread = std::thread(&BeaconPipeline::workerLoop, this, w);
+  }
+  running = true;
+  return true;
+}
+
+void BeaconPipeline::stop() {
+  if (!running) {
+    return;
+  }
+
+  __atomic_store_n(&stopping, 1, __ATOMIC_RELEASE);
+  for (uint8_t w = 0; w < worker_count; w++) {
+    workers[w].thread.join();
+  }
+  running = false;
+}
+
+uint16_t BeaconPipeline::shardFor(const uint8_t* data, uint16_t len,
+                                  const uint8_t* address) const {
+  uint64_t hash;
+
+  if (settings.routing == BEACON_ROUTE_IDENTITY) {
+    // Ingest threads are not pipeline workers, so each keeps its own parser
+    static thread_local BLEBeaconParser parser;
+    BeaconView view;
+    BeaconKey key;
+    if (parser.parseView(data, len, view)) {
+      key = view.key();
+    }
+    if (key.valid()) {
+      hash = key.hash;
+    } else if (address != nullptr) {
+      hash = BeaconHash::hash64(address, 6);
+    } else {
+      hash = BeaconHash::hash64(data, len);
+    }
+  } else {
+    hash = address != nullptr ? BeaconHash::hash64(address, 6) : BeaconHash::hash64(data, len);
+  }
+
+  // High bits: BeaconTracker uses the low bits of key hashes for its slots
+  return (uint16_t)(hash >> 32) & shard_mask;
+}
+
+bool BeaconPipeline::submit(const uint8_t* data, uint16_t len, int8_t rssi,
+                            const uint8_t* address, uint8_t address_type) {
+  ScanObservation observation;
+  observation.payload = data;
+  observation.payload_len = len;
+  observation.rssi = rssi;
+  observation.address_type = address_type;
+  if (address != nullptr) {
+    memcpy(observation.address, address, sizeof(observation.address));
+  }
+  return enqueue(observation, address != nullptr);
+}
+
+bool BeaconPipeline::submit(const ScanObservation& observation) {
+  return enqueue(observation, true);
+}
+
+bool BeaconPipeline::enqueue(const ScanObservation& observation, bool has_address) {
+  if (observation.payload == nullptr || observation.payload_len > BEACON_PIPELINE_DATA_SIZE) {
+    __atomic_fetch_add(&drop_count, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  uint16_t len = observation.payload_len;
+  const uint8_t* address = has_address ? observation.address : nullptr;
+  BeaconPipelineShard& shard = shards[shardFor(observation.payload, len, address)];
+  uint32_t pos = __atomic_load_n(&shard.enqueue_pos, __ATOMIC_RELAXED);
+  PipelineSlot* slot;
+
+  for (;;) {
+    slot = &shard.slots[pos & shard.slot_mask];
+    uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+    int32_t diff = (int32_t)(sequence - pos);
+
+    if (diff == 0) {
+      // Slot is free at this position: claim the position
+      if (__atomic_compare_exchange_n(&shard.enqueue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Consumer has not freed the slot yet: queue is full
+      __atomic_fetch_add(&drop_count, 1, __ATOMIC_RELAXED);
+      return false;
+    } else {
+      pos = __atomic_load_n(&shard.enqueue_pos, __ATOMIC_RELAXED);
+    }
+  }
+
+  PipelineReport& report = slot->report;
+  memcpy(report.data, observation.payload, len);
+  report.len = len;
+  report.timestamp_us = observation.timestamp_us;
+  report.rssi = observation.rssi;
+  report.address_type = observation.address_type;
+  memcpy(report.address, observation.address, sizeof(report.address));
+  report.channel = observation.channel;
+  report.tx_power = observation.tx_power;
+  report.flags = observation.flags;
+
+  __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+uint16_t BeaconPipeline::drainShard(uint16_t index, BeaconPipelineWorker& worker) {
+  BeaconPipelineShard& shard = shards[index];
+
+  // Cheap check before the CAS so busy shards are skipped without contention
+  if (__atomic_load_n(&shard.claimed, __ATOMIC_RELAXED) != 0) {
+    return 0;
+  }
+  uint32_t expected = 0;
+  if (!__atomic_compare_exchange_n(&shard.claimed, &expected, 1, false, __ATOMIC_ACQUIRE,
+                                   __ATOMIC_RELAXED)) {
+    return 0;
+  }
+
+  uint32_t pos = shard.dequeue_pos;
+  uint16_t count = 0;
+  uint32_t now = 0;
+  BeaconData result;
+
+  while (count < settings.batch) {
+    PipelineSlot& slot = shard.slots[pos & shard.slot_mask];
+    if (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != pos + 1) {
+      break;
+    }
+    if (count == 0) {
+      now = monotonicMs();
+    }
+
+    ScanObservation observation = slot.report.observation();
+    if (worker.parser.parse(observation, result)) {
+      shard.tracker->update(result, observation.rssi, now);
+      if (settings.handler != nullptr) {
+        settings.handler(observation, result, *shard.tracker, settings.context);
+      }
+    }
+
+    // Hand the slot back to producers one lap ahead
+    __atomic_store_n(&slot.sequence, pos + shard.slot_mask + 1, __ATOMIC_RELEASE);
+    pos++;
+    count++;
+  }
+
+  shard.dequeue_pos = pos;
+  if (count > 0) {
+    __atomic_store_n(&shard.processed, shard.processed + count, __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&shard.claimed, 0, __ATOMIC_RELEASE);
+  return count;
+}
+
+void BeaconPipeline::workerLoop(uint8_t index) {
+  BeaconPipelineWorker& worker = workers[index];
+  uint16_t shard_count = shard_mask + 1;
+  uint32_t idle = 0;
+
+  if (settings.pin_threads) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(index % cpus, &set);
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+  }
+
+  for (;;) {
+    // Read before the pass: an empty pass after stop() was requested means
+    // every report submitted before stop() has been processed
+    bool stop_requested = __atomic_load_n(&stopping, __ATOMIC_ACQUIRE) != 0;
+    uint32_t done = 0;
+
+    for (uint16_t s = index; s < shard_count; s += worker_count) {
+      done += drainShard(s, worker);
+    }
+
+    if (done == 0) {
+      // Own shards are empty: steal a whole shard from another worker
+      for (uint16_t i = 0; i < shard_count; i++) {
+        uint16_t s = (worker.next_victim + i) & shard_mask;
+        if (s % worker_count == index) {
+          continue;
+        }
+        uint16_t count = drainShard(s, worker);
+        if (count > 0) {
+          __atomic_store_n(&worker.steals, worker.steals + 1, __ATOMIC_RELAXED);
+          worker.next_victim = s;
+          done = count;
+          break;
+        }
+      }
+    }
+
+    if (done > 0) {
+      idle = 0;
+      continue;
+    }
+    if (stop_requested) {
+      break;
+    }
+
+    if (++idle < PIPELINE_IDLE_SPINS) {
+      cpuRelax();
+    } else {
+      struct timespec pause = {0, PIPELINE_IDLE_SLEEP_NS};
+      nanosleep(&pause, nullptr);
+    }
+  }
+}
+
+const BeaconTracker& BeaconPipeline::tracker(uint16_t shard) const {
+  return *shards[shard & shard_mask].tracker;
+}
+
+uint64_t BeaconPipeline::processed() const {
+  uint64_t total = 0;
+  for (uint16_t s = 0; s <= shard_mask; s++) {
+    total += __atomic_load_n(&shards[s].processed, __ATOMIC_RELAXED);
+  }
+  return total;
+}
+
+uint64_t BeaconPipeline::dropped() const {
+  return __atomic_load_n(&drop_count, __ATOMIC_RELAXED);
+}
+
+uint64_t BeaconPipeline::steals() const {
+  uint64_t total = 0;
+  for (uint8_t w = 0; w < worker_count; w++) {
+    total += __atomic_load_n(&workers[w].steals, __ATOMIC_RELAXED);
+  }
+  return total;
+}
+
+#endif  // __linux__
@@ -0,0 +1,196 @@
+#ifndef BEACON_PIPELINE_H
+#define BEACON_PIPELINE_H
+
+// Multi-threaded ingestion for Linux gateways; not built on microcontrollers
+#if defined(__linux__)
+
+#include <stdint.h>
+#include "BeaconData.h"
+#include "BeaconTracker.h"
+#include "ScanObservation.h"
+
+// Beacons tracked per shard
+#define BEACON_PIPELINE_SHARD_BEACONS 256
+
+// Parse cache entries per worker
+#define BEACON_PIPELINE_PARSE_CACHE 256
+
+// Longest advertisement a shard queue slot holds: the data of one HCI LE
+// Extended Advertising Report (255 parameter bytes less 26 bytes of headers)
+#define BEACON_PIPELINE_DATA_SIZE 229
+
+/**
+ * @brief How submitted reports are assigned to shards
+ */
+enum BeaconPipelineRouting {
+  BEACON_ROUTE_ADDRESS,  // Hash of the advertiser address (no parsing on ingest)
+  BEACON_ROUTE_IDENTITY  // Hash of the BeaconKey, falling back to the address
+};
+
+/**
+ * @brief Called on a worker thread for each report that parsed as a beacon
+ *
+ * The shard tracker has already been updated with the report. It belongs
+ * to the shard being drained and may be read without locking for the
+ * duration of the call.
+ *
+ * @param observation Submitted report (payload points into the shard queue)
+ * @param result Parsed beacon
+ * @param tracker Per-beacon state of the report's shard
+ * @param context BeaconPipelineConfig::context
+ */
+typedef void (*BeaconPipelineHandler)(const ScanObservation& observation,
+                                      const BeaconData& result, const BeaconTracker& tracker,
+                                      void* context);
+
+/**
+ * @brief BeaconPipeline settings
+ */
+struct BeaconPipelineConfig {
+  uint8_t workers;                // Worker threads (0 = one per online CPU, up to 255)
+  uint16_t shards;                // Virtual shards (power of two, at least workers)
+  uint16_t queue_slots;           // Ingress slots per shard (power of two)
+  uint16_t batch;                 // Reports drained per shard claim
+  BeaconPipelineRouting routing;  // Shard assignment
+  bool pin_threads;               // Pin worker i to CPU i (modulo CPU count)
+  BeaconPipelineHandler handler;  // Optional per-beacon callback
+  void* context;                  // Passed to handler
+
+  BeaconPipelineConfig()
+      : workers(0),
+        shards(64),
+        queue_slots(1024),
+        batch(64),
+        routing(BEACON_ROUTE_ADDRESS),
+        pin_threads(true),
+        handler(nullptr),
+        context(nullptr) {}
+};
+
+struct BeaconPipelineShard;
+struct BeaconPipelineWorker;
+
+/**
+ * @brief Sharded multi-core parsing runtime for Linux gateways
+ *
+ * Any number of ingest threads (HCI dongles, network scanners) call
+ * submit(). Each report is hashed to one of a fixed set of virtual shards
+ * by advertiser address or beacon identity and pushed onto that shard's
+ * bounded lock-free multi-producer queue.
+ *
+ * Worker threads claim whole shards with an atomic flag, drain a batch,
+ * and release the claim. A worker first visits the shards it owns
+ * (shard % workers == worker) and only steals other shards when those are
+ * empty, so load imbalance between shards is absorbed without moving
+ * per-beacon state. Because a shard is drained by one worker at a time,
+ * its BeaconTracker is updated without locks.
+ *
+ * Each worker has its own BLEBeaconParser and parse cache. Everything is
+ * allocated in the constructor. Queue slots hold up to 229 bytes of
+ * advertising data, so extended reports are queued whole; a shard queue
+ * takes about 256 bytes per slot.
+ *
+ * Usage:
+ * @code
+ * BeaconPipelineConfig config;
+ * config.workers = 8;
+ * config.handler = on_beacon;
+ * BeaconPipeline pipeline(config);
+ * pipeline.start();
+ *
+ * // From any ingest thread
+ * pipeline.submit(adv_data, adv_len, rssi, address);
+ *
+ * pipeline.stop();  // Drains queued reports, then joins the workers
+ * @endcode
+ */
+class BeaconPipeline {
+ public:
+  explicit BeaconPipeline(const BeaconPipelineConfig& config = BeaconPipelineConfig());
+  ~BeaconPipeline();
+
+  BeaconPipeline(const BeaconPipeline&) = delete;
+  BeaconPipeline& operator=(const BeaconPipeline&) = delete;
+
+  /**
+   * @brief Start the worker threads
+   * @return false if already running
+   */
+  bool start();
+
+  /**
+   * @brief Process every queued report, then stop the worker threads
+   *
+   * Call once submitting threads have stopped.
+   */
+  void stop();
+
+  /**
+   * @brief Queue a report for parsing (thread-safe, lock-free)
+   * @param data Raw advertisement data
+   * @param len Length of advertisement data (at most BEACON_PIPELINE_DATA_SIZE)
+   * @param rssi Received signal strength
+   * @param address 6-byte advertiser address, or nullptr
+   * @param address_type Advertiser address type
+   * @return true if queued, false if dropped (shard queue full or report too long)
+   */
+  bool submit(const uint8_t* data, uint16_t len, int8_t rssi, const uint8_t* address,
+              uint8_t address_type = 0);
+
+  /**
+   * @brief Queue a copy of an observation and its payload (thread-safe, lock-free)
+   * @return true if queued, false if dropped
+   */
+  bool submit(const ScanObservation& observation);
+
+  /**
+   * @brief Shard a report would be queued on
+   */
+  uint16_t shardFor(const uint8_t* data, uint16_t len, const uint8_t* address) const;
+
+  /**
+   * @brief Per-beacon state of a shard (read only while stopped)
+   */
+  const BeaconTracker& tracker(uint16_t shard) const;
+
+  uint16_t shardCount() const {
+    return shard_mask + 1;
+  }
+
+  uint8_t workerCount() const {
+    return worker_count;
+  }
+
+  /**
+   * @brief Reports taken off the shard queues
+   */
+  uint64_t processed() const;
+
+  /**
+   * @brief Reports rejected by submit()
+   */
+  uint64_t dropped() const;
+
+  /**
+   * @brief Shard claims made outside a worker's own shards
+   */
+  uint64_t steals() const;
+
+ private:
+  bool enqueue(const ScanObservation& observation, bool has_address);
+  void workerLoop(uint8_t worker);
+  uint16_t drainShard(uint16_t shard, BeaconPipelineWorker& worker);
+
+  BeaconPipelineConfig settings;
+  BeaconPipelineShard* shards;
+  BeaconPipelineWorker* workers;
+  uint16_t shard_mask;
+  uint8_t worker_count;
+  uint32_t stopping;
+  bool running;
+  uint64_t drop_count;
+};
+
+#endif  // __linux__
+
+#endif  // BEACON_PIPELINE_H
@@ -0,0 +1,290 @@
+#include "BeaconPrefilter.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BEACON_PREFILTER_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#define BEACON_PREFILTER_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Signature bytes
+#define SIG_MFG_TYPE 0xFF
+#define SIG_SERVICE_TYPE 0x16
+
+// Vector paths copy the packet into a zero-padded block so that loads at
+// offsets +0..+4 never read past the caller's buffer. Zero padding cannot
+// complete any signature (each one ends in non-zero bytes).
+#define PREFILTER_PADDING 40
+
+// Packets longer than one block (extended advertising data) are scanned in
+// blocks that overlap by 4 bytes, so every 5-byte signature lies wholly
+// inside some block
+#define PREFILTER_BLOCK 255
+#define PREFILTER_OVERLAP 4
+
+// Scans one block of at most PREFILTER_BLOCK bytes
+typedef uint8_t (*ScanFn)(const uint8_t* data, uint8_t len);
+
+uint8_t BeaconPrefilter::scanScalar(const uint8_t* data, uint16_t len) {
+  uint8_t mask = 0;
+
+  if (data == nullptr) {
+    return 0;
+  }
+
+  for (uint16_t i = 0; i + 3 <= len; i++) {
+    if (data[i] == SIG_SERVICE_TYPE) {
+      if (data[i + 1] == 0xAA && data[i + 2] == 0xFE) {
+        mask |= BEACON_CANDIDATE_EDDYSTONE;
+      }
+    } else if (data[i] == SIG_MFG_TYPE && i + 5 <= len) {
+      if (data[i + 1] == 0x4C && data[i + 2] == 0x00 && data[i + 3] == 0x02 &&
+          data[i + 4] == 0x15) {
+        mask |= BEACON_CANDIDATE_IBEACON;
+      } else if (data[i + 1] == 0x18 && data[i + 2] == 0x01 && data[i + 3] == 0xBE &&
+                 data[i + 4] == 0xAC) {
+        mask |= BEACON_CANDIDATE_ALTBEACON;
+      }
+    }
+  }
+
+  return mask;
+}
+
+#if defined(BEACON_PREFILTER_X86)
+
+__attribute__((target("sse2"))) static uint8_t scanSSE2(const uint8_t* data, uint8_t len) {
+  uint8_t block[PREFILTER_BLOCK + PREFILTER_PADDING];
+  memcpy(block, data, len);
+  memset(&block[len], 0, PREFILTER_PADDING);
+
+  const __m128i zero = _mm_setzero_si128();
+  __m128i ibeacon = zero;
+  __m128i altbeacon = zero;
+  __m128i eddystone = zero;
+
+  for (uint16_t i = 0; i < len; i += 16) {
+    __m128i b0 = _mm_loadu_si128((const __m128i*)&block[i]);
+    __m128i b1 = _mm_loadu_si128((const __m128i*)&block[i + 1]);
+    __m128i b2 = _mm_loadu_si128((const __m128i*)&block[i + 2]);
+    __m128i b3 = _mm_loadu_si128((const __m128i*)&block[i + 3]);
+    __m128i b4 = _mm_loadu_si128((const __m128i*)&block[i + 4]);
+
+    __m128i mfg = _mm_cmpeq_epi8(b0, _mm_set1_epi8((char)SIG_MFG_TYPE));
+
+    __m128i ib = _mm_and_si128(mfg, _mm_cmpeq_epi8(b1, _mm_set1_epi8(0x4C)));
+    ib = _mm_and_si128(ib, _mm_cmpeq_epi8(b2, zero));
+    ib = _mm_and_si128(ib, _mm_cmpeq_epi8(b3, _mm_set1_epi8(0x02)));
+    ib = _mm_and_si128(ib, _mm_cmpeq_epi8(b4, _mm_set1_epi8(0x15)));
+    ibeacon = _mm_or_si128(ibeacon, ib);
+
+    __m128i alt = _mm_and_si128(mfg, _mm_cmpeq_epi8(b1, _mm_set1_epi8(0x18)));
+    alt = _mm_and_si128(alt, _mm_cmpeq_epi8(b2, _mm_set1_epi8(0x01)));
+    alt = _mm_and_si128(alt, _mm_cmpeq_epi8(b3, _mm_set1_epi8((char)0xBE)));
+    alt = _mm_and_si128(alt, _mm_cmpeq_epi8(b4, _mm_set1_epi8((char)0xAC)));
+    altbeacon = _mm_or_si128(altbeacon, alt);
+
+    __m128i ed = _mm_cmpeq_epi8(b0, _mm_set1_epi8(SIG_SERVICE_TYPE));
+    ed = _mm_and_si128(ed, _mm_cmpeq_epi8(b1, _mm_set1_epi8((char)0xAA)));
+    ed = _mm_and_si128(ed, _mm_cmpeq_epi8(b2, _mm_set1_epi8((char)0xFE)));
+    eddystone = _mm_or_si128(eddystone, ed);
+  }
+
+  uint8_t mask = 0;
+  if (_mm_movemask_epi8(ibeacon) != 0) {
+    mask |= BEACON_CANDIDATE_IBEACON;
+  }
+  if (_mm_movemask_epi8(altbeacon) != 0) {
+    mask |= BEACON_CANDIDATE_ALTBEACON;
+  }
+  if (_mm_movemask_epi8(eddystone) != 0) {
+    mask |= BEACON_CANDIDATE_EDDYSTONE;
+  }
+  return mask;
+}
+
+__attribute__((target("avx2"))) static uint8_t scanAVX2(const uint8_t* data, uint8_t len) {
+  uint8_t block[PREFILTER_BLOCK + PREFILTER_PADDING];
+  memcpy(block, data, len);
+  memset(&block[len], 0, PREFILTER_PADDING);
+
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i ibeacon = zero;
+  __m256i altbeacon = zero;
+  __m256i eddystone = zero;
+
+  for (uint16_t i = 0; i < len; i += 32) {
+    __m256i b0 = _mm256_loadu_si256((const __m256i*)&block[i]);
+    __m256i b1 = _mm256_loadu_si256((const __m256i*)&block[i + 1]);
+    __m256i b2 = _mm256_loadu_si256((const __m256i*)&block[i + 2]);
+    __m256i b3 = _mm256_loadu_si256((const __m256i*)&block[i + 3]);
+    __m256i b4 = _mm256_loadu_si256((const __m256i*)&block[i + 4]);
+
+    __m256i mfg = _mm256_cmpeq_epi8(b0, _mm256_set1_epi8((char)SIG_MFG_TYPE));
+
+    __m256i ib = _mm256_and_si256(mfg, _mm256_cmpeq_epi8(b1, _mm256_set1_epi8(0x4C)));
+    ib = _mm256_and_si256(ib, _mm256_cmpeq_epi8(b2, zero));
+    ib = _mm256_and_si256(ib, _mm256_cmpeq_epi8(b3, _mm256_set1_epi8(0x02)));
+    ib = _mm256_and_si256(ib, _mm256_cmpeq_epi8(b4, _mm256_set1_epi8(0x15)));
+    ibeacon = _mm256_or_si256(ibeacon, ib);
+
+    __m256i alt = _mm256_and_si256(mfg, _mm256_cmpeq_epi8(b1, _mm256_set1_epi8(0x18)));
+    alt = _mm256_and_si256(alt, _mm256_cmpeq_epi8(b2, _mm256_set1_epi8(0x01)));
+    alt = _mm256_and_si256(alt, _mm256_cmpeq_epi8(b3, _mm256_set1_epi8((char)0xBE)));
+    alt = _mm256_and_si256(alt, _mm256_cmpeq_epi8(b4, _mm256_set1_epi8((char)0xAC)));
+    altbeacon = _mm256_or_si256(altbeacon, alt);
+
+    __m256i ed = _mm256_cmpeq_epi8(b0, _mm256_set1_epi8(SIG_SERVICE_TYPE));
+    ed = _mm256_and_si256(ed, _mm256_cmpeq_epi8(b1, _mm256_set1_epi8((char)0xAA)));
+    ed = _mm256_and_si256(ed, _mm256_cmpeq_epi8(b2, _mm256_set1_epi8((char)0xFE)));
+    eddystone = _mm256_or_si256(eddystone, ed);
+  }
+
+  uint8_t mask = 0;
+  if (_mm256_movemask_epi8(ibeacon) != 0) {
+    mask |= BEACON_CANDIDATE_IBEACON;
+  }
+  if (_mm256_movemask_epi8(altbeacon) != 0) {
+    mask |= BEACON_CANDIDATE_ALTBEACON;
+  }
+  if (_mm256_movemask_epi8(eddystone) != 0) {
+    mask |= BEACON_CANDIDATE_EDDYSTONE;
+  }
+  return mask;
+}
+
+#elif defined(BEACON_PREFILTER_NEON)
+
+static uint8_t scanNEON(const uint8_t* data, uint8_t len) {
+  uint8_t block[PREFILTER_BLOCK + PREFILTER_PADDING];
+  memcpy(block, data, len);
+  memset(&block[len], 0, PREFILTER_PADDING);
+
+  uint8x16_t ibeacon = vdupq_n_u8(0);
+  uint8x16_t altbeacon = vdupq_n_u8(0);
+  uint8x16_t eddystone = vdupq_n_u8(0);
+
+  for (uint16_t i = 0; i < len; i += 16) {
+    uint8x16_t b0 = vld1q_u8(&block[i]);
+    uint8x16_t b1 = vld1q_u8(&block[i + 1]);
+    uint8x16_t b2 = vld1q_u8(&block[i + 2]);
+    uint8x16_t b3 = vld1q_u8(&block[i + 3]);
+    uint8x16_t b4 = vld1q_u8(&block[i + 4]);
+
+    uint8x16_t mfg = vceqq_u8(b0, vdupq_n_u8(SIG_MFG_TYPE));
+
+    uint8x16_t ib = vandq_u8(mfg, vceqq_u8(b1, vdupq_n_u8(0x4C)));
+    ib = vandq_u8(ib, vceqq_u8(b2, vdupq_n_u8(0x00)));
+    ib = vandq_u8(ib, vceqq_u8(b3, vdupq_n_u8(0x02)));
+    ib = vandq_u8(ib, vceqq_u8(b4, vdupq_n_u8(0x15)));
+    ibeacon = vorrq_u8(ibeacon, ib);
+
+    uint8x16_t alt = vandq_u8(mfg, vceqq_u8(b1, vdupq_n_u8(0x18)));
+    alt = vandq_u8(alt, vceqq_u8(b2, vdupq_n_u8(0x01)));
+    alt = vandq_u8(alt, vceqq_u8(b3, vdupq_n_u8(0xBE)));
+    alt = vandq_u8(alt, vceqq_u8(b4, vdupq_n_u8(0xAC)));
+    altbeacon = vorrq_u8(altbeacon, alt);
+
+    uint8x16_t ed = vceqq_u8(b0, vdupq_n_u8(SIG_SERVICE_TYPE));
+    ed = vandq_u8(ed, vceqq_u8(b1, vdupq_n_u8(0xAA)));
+    ed = vandq_u8(ed, vceqq_u8(b2, vdupq_n_u8(0xFE)));
+    eddystone = vorrq_u8(eddystone, ed);
+  }
+
+  uint8_t mask = 0;
+  if (vmaxvq_u8(ibeacon) != 0) {
+    mask |= BEACON_CANDIDATE_IBEACON;
+  }
+  if (vmaxvq_u8(altbeacon) != 0) {
+    mask |= BEACON_CANDIDATE_ALTBEACON;
+  }
+  if (vmaxvq_u8(eddystone) != 0) {
+    mask |= BEACON_CANDIDATE_EDDYSTONE;
+  }
+  return mask;
+}
+
+#endif
+
+static uint8_t scanScalarBlock(const uint8_t* data, uint8_t len) {
+  return BeaconPrefilter::scanScalar(data, len);
+}
+
+struct PrefilterImpl {
+  ScanFn scan;
+  const char* name;
+};
+
+static PrefilterImpl selectImpl() {
+  PrefilterImpl impl = {&scanScalarBlock, "scalar"};
+
+#if defined(BEACON_PREFILTER_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    impl.scan = &scanAVX2;
+    impl.name = "avx2";
+  } else if (__builtin_cpu_supports("sse2")) {
+    impl.scan = &scanSSE2;
+    impl.name = "sse2";
+  }
+#elif defined(BEACON_PREFILTER_NEON)
+  impl.scan = &scanNEON;
+  impl.name = "neon";
+#endif
+
+  return impl;
+}
+
+static const PrefilterImpl& activeImpl() {
+  // Selected once, on first use
+  static const PrefilterImpl impl = selectImpl();
+  return impl;
+}
+
+static uint8_t scanBlocks(ScanFn scan_fn, const uint8_t* data, uint16_t len) {
+  uint8_t mask = 0;
+  uint16_t pos = 0;
+
+  while (len - pos > PREFILTER_BLOCK) {
+    mask |= scan_fn(&data[pos], PREFILTER_BLOCK);
+    pos += PREFILTER_BLOCK - PREFILTER_OVERLAP;
+  }
+  return mask | scan_fn(&data[pos], len - pos);
+}
+
+uint8_t BeaconPrefilter::scan(const uint8_t* data, uint16_t len) {
+  if (data == nullptr || len < 3) {
+    return 0;
+  }
+  return scanBlocks(activeImpl().scan, data, len);
+}
+
+uint16_t BeaconPrefilter::scanBatch(const AdvPacket* packets, uint16_t count, uint8_t* masks) {
+  if (packets == nullptr || masks == nullptr) {
+    return 0;
+  }
+
+  ScanFn scan_fn = activeImpl().scan;
+  uint16_t candidates = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    if (i + BEACON_BATCH_PREFETCH_DISTANCE < count) {
+      BEACON_PREFETCH(packets[i + BEACON_BATCH_PREFETCH_DISTANCE].data);
+    }
+
+    const AdvPacket& packet = packets[i];
+    bool scannable = packet.data != nullptr && packet.len >= 3;
+    masks[i] = scannable ? scanBlocks(scan_fn, packet.data, packet.len) : 0;
+    if (masks[i] != 0) {
+      candidates++;
+    }
+  }
+
+  return candidates;
+}
+
+const char* BeaconPrefilter::implementation() {
+  return activeImpl().name;
+}
@@ -0,0 +1,57 @@
+#ifndef BEACON_PREFILTER_H
+#define BEACON_PREFILTER_H
+
+#include <stdint.h>
+#include "BeaconBatch.h"
+
+// Candidate bits returned by BeaconPrefilter
+#define BEACON_CANDIDATE_IBEACON 0x01    // FF 4C 00 02 15
+#define BEACON_CANDIDATE_ALTBEACON 0x02  // FF 18 01 BE AC
+#define BEACON_CANDIDATE_EDDYSTONE 0x04  // 16 AA FE
+
+/**
+ * @brief Vectorized signature prefilter for raw advertisements
+ *
+ * Scans raw advertisement bytes for the AD type + ID + prefix signatures of
+ * the built-in formats and reports which formats a packet may contain. A
+ * zero mask means no built-in decoder can succeed, so the packet can be
+ * dropped without tokenizing it. A set bit is only a candidate; the
+ * decoder still performs full validation.
+ *
+ * The implementation is chosen once at runtime: AVX2 or SSE2 on x86, NEON on
+ * AArch64, and a portable scalar loop everywhere else (including MCUs).
+ * Extended advertising data longer than 255 bytes is scanned in overlapping
+ * 255-byte blocks.
+ */
+class BeaconPrefilter {
+ public:
+  /**
+   * @brief Scan one packet for beacon signatures
+   * @param data Raw advertisement data
+   * @param len Length of advertisement data
+   * @return Bitmask of BEACON_CANDIDATE_* flags
+   */
+  static uint8_t scan(const uint8_t* data, uint16_t len);
+
+  /**
+   * @brief Scan a batch of packets for beacon signatures
+   * @param packets Array of pointer/length pairs
+   * @param count Number of packets
+   * @param masks Output array of count BEACON_CANDIDATE_* bitmasks
+   * @return Number of packets with a non-zero mask
+   */
+  static uint16_t scanBatch(const AdvPacket* packets, uint16_t count, uint8_t* masks);
+
+  /**
+   * @brief Portable byte-at-a-time reference implementation of scan()
+   */
+  static uint8_t scanScalar(const uint8_t* data, uint16_t len);
+
+  /**
+   * @brief Name of the implementation selected for this CPU
+   * @return "avx2", "sse2", "neon" or "scalar"
+   */
+  static const char* implementation();
+};
+
+#endif  // BEACON_PREFILTER_H
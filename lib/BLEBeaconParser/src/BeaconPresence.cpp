@@ -0,0 +1,272 @@
+#include "BeaconPresence.h"
+#include <string.h>
+
+// End of a wheel list
+#define PRESENCE_NIL 0xFFFF
+
+#define PRESENCE_SLOT_MASK (BEACON_PRESENCE_WHEEL_SLOTS - 1)
+
+// Longest delay the wheel can hold, in ticks
+#define PRESENCE_MAX_TICKS \
+  ((1UL << (BEACON_PRESENCE_WHEEL_BITS * BEACON_PRESENCE_WHEEL_LEVELS)) - 1)
+
+BeaconPresence::BeaconPresence(Entry* entry_storage, uint16_t* free_storage,
+                               IndexEntry* index_storage, uint16_t capacity, uint32_t timeout,
+                               uint32_t tick)
+    : entries(entry_storage),
+      free_slots(free_storage),
+      index(index_storage),
+      handler(nullptr),
+      context(nullptr),
+      timeout_length(timeout > 0 ? timeout : 1),
+      tick_length(tick > 0 ? tick : 1),
+      current_tick(0),
+      tick_time(0),
+      overflow_count(0),
+      slot_count(capacity),
+      index_mask((uint16_t)(2 * capacity - 1)),
+      free_count(0),
+      enter_threshold(-128),
+      exit_threshold(-128),
+      started(false) {}
+
+void BeaconPresence::clear() {
+  memset(wheel, 0xFF, sizeof(wheel));
+  memset(index, 0, sizeof(IndexEntry) * (index_mask + 1));
+
+  // Hand out low slots first
+  for (uint16_t i = 0; i < slot_count; i++) {
+    free_slots[i] = slot_count - 1 - i;
+  }
+  free_count = slot_count;
+  overflow_count = 0;
+  started = false;
+}
+
+bool BeaconPresence::update(const BeaconKey& key, int8_t rssi, uint32_t now) {
+  if (!key.valid()) {
+    return false;
+  }
+
+  advance(now);
+
+  int32_t found = findSlot(key);
+  if (found < 0) {
+    if (rssi < enter_threshold) {
+      return false;
+    }
+    if (free_count == 0) {
+      overflow_count++;
+      return false;
+    }
+
+    uint16_t slot = free_slots[--free_count];
+    entries[slot].key = key;
+    entries[slot].rssi_x4 = rssi * 4;
+    indexInsert(slot);
+    refresh(slot, now);
+    emit(slot, BEACON_PRESENCE_ENTER, rssi, now);
+    return true;
+  }
+
+  uint16_t slot = (uint16_t)found;
+  Entry& entry = entries[slot];
+  entry.rssi_x4 = entry.rssi_x4 - entry.rssi_x4 / 4 + rssi;
+  unschedule(slot);
+
+  if (entry.rssi_x4 < exit_threshold * 4) {
+    emit(slot, BEACON_PRESENCE_EXIT_SIGNAL, (int8_t)(entry.rssi_x4 / 4), now);
+    release(slot);
+    return false;
+  }
+
+  refresh(slot, now);
+  return true;
+}
+
+void BeaconPresence::advance(uint32_t now) {
+  // First call: align ticks to multiples of the tick length
+  if (!started) {
+    current_tick = now / tick_length;
+    tick_time = now - now % tick_length;
+    started = true;
+    return;
+  }
+
+  // Ticks are counted from time deltas, so a wrap of now (e.g. millis())
+  // does not send the counter back; earlier timestamps change nothing
+  uint32_t elapsed = now - tick_time;
+  if ((int32_t)elapsed < 0) {
+    return;
+  }
+  uint32_t ticks = elapsed / tick_length;
+
+  // Nothing scheduled: jump straight to now
+  if (free_count == slot_count) {
+    current_tick += ticks;
+    tick_time += ticks * tick_length;
+    return;
+  }
+
+  for (; ticks > 0; ticks--) {
+    current_tick++;
+    tick_time += tick_length;
+
+    // Each time a level's slot boundary is crossed, redistribute the next
+    // slot of the level above into the finer levels
+    uint8_t level = 0;
+    while (level + 1 < BEACON_PRESENCE_WHEEL_LEVELS &&
+           (current_tick & ((1UL << (BEACON_PRESENCE_WHEEL_BITS * (level + 1))) - 1)) == 0) {
+      level++;
+    }
+    for (; level > 0; level--) {
+      cascade(level);
+    }
+
+    // Everything left in the level 0 slot is due now
+    uint16_t bucket = current_tick & PRESENCE_SLOT_MASK;
+    uint16_t slot = wheel[bucket];
+    wheel[bucket] = PRESENCE_NIL;
+    while (slot != PRESENCE_NIL) {
+      uint16_t next = entries[slot].next;
+      emit(slot, BEACON_PRESENCE_EXIT_TIMEOUT, (int8_t)(entries[slot].rssi_x4 / 4), tick_time);
+      release(slot);
+      slot = next;
+    }
+  }
+}
+
+void BeaconPresence::refresh(uint16_t slot, uint32_t now) {
+  // First tick at or after now + timeout, counted from the current tick;
+  // out-of-order timestamps must not land in a slot that already fired
+  int32_t until = (int32_t)(now + timeout_length - tick_time);
+  uint32_t ticks = until > 0 ? ((uint32_t)until + tick_length - 1) / tick_length : 1;
+  entries[slot].expires = current_tick + ticks;
+  schedule(slot);
+}
+
+void BeaconPresence::schedule(uint16_t slot) {
+  Entry& entry = entries[slot];
+  uint32_t delta = entry.expires - current_tick;
+  if ((int32_t)delta < 0) {
+    delta = 0;
+  } else if (delta > PRESENCE_MAX_TICKS) {
+    delta = PRESENCE_MAX_TICKS;
+  }
+  entry.expires = current_tick + delta;
+
+  // Finest level whose span covers the delay
+  uint8_t level = 0;
+  while (level + 1 < BEACON_PRESENCE_WHEEL_LEVELS &&
+         delta >= (1UL << (BEACON_PRESENCE_WHEEL_BITS * (level + 1)))) {
+    level++;
+  }
+
+  uint16_t bucket = level * BEACON_PRESENCE_WHEEL_SLOTS +
+                    ((entry.expires >> (BEACON_PRESENCE_WHEEL_BITS * level)) & PRESENCE_SLOT_MASK);
+  entry.bucket = bucket;
+  entry.prev = PRESENCE_NIL;
+  entry.next = wheel[bucket];
+  if (entry.next != PRESENCE_NIL) {
+    entries[entry.next].prev = slot;
+  }
+  wheel[bucket] = slot;
+}
+
+void BeaconPresence::unschedule(uint16_t slot) {
+  Entry& entry = entries[slot];
+  if (entry.prev != PRESENCE_NIL) {
+    entries[entry.prev].next = entry.next;
+  } else {
+    wheel[entry.bucket] = entry.next;
+  }
+  if (entry.next != PRESENCE_NIL) {
+    entries[entry.next].prev = entry.prev;
+  }
+}
+
+void BeaconPresence::cascade(uint8_t level) {
+  uint16_t bucket = level * BEACON_PRESENCE_WHEEL_SLOTS +
+                    ((current_tick >> (BEACON_PRESENCE_WHEEL_BITS * level)) & PRESENCE_SLOT_MASK);
+  uint16_t slot = wheel[bucket];
+  wheel[bucket] = PRESENCE_NIL;
+
+  while (slot != PRESENCE_NIL) {
+    uint16_t next = entries[slot].next;
+    schedule(slot);
+    slot = next;
+  }
+}
+
+void BeaconPresence::release(uint16_t slot) {
+  indexRemove(slot);
+  free_slots[free_count++] = slot;
+}
+
+void BeaconPresence::emit(uint16_t slot, BeaconPresenceEventType type, int8_t rssi,
+                          uint32_t time) {
+  if (handler == nullptr) {
+    return;
+  }
+
+  BeaconPresenceEvent event;
+  event.key = entries[slot].key;
+  event.time = time;
+  event.rssi = rssi;
+  event.type = type;
+  handler(event, context);
+}
+
+int32_t BeaconPresence::findSlot(const BeaconKey& key) const {
+  if (!key.valid()) {
+    return -1;
+  }
+
+  uint16_t tag = (uint16_t)(key.hash >> 48);
+  uint16_t pos = (uint16_t)key.hash & index_mask;
+
+  while (index[pos].slot != 0) {
+    uint16_t slot = index[pos].slot - 1;
+    if (index[pos].tag == tag && entries[slot].key == key) {
+      return slot;
+    }
+    pos = (pos + 1) & index_mask;
+  }
+  return -1;
+}
+
+void BeaconPresence::indexInsert(uint16_t slot) {
+  uint64_t hash = entries[slot].key.hash;
+  uint16_t pos = (uint16_t)hash & index_mask;
+
+  // At most half full, so an empty entry is always found
+  while (index[pos].slot != 0) {
+    pos = (pos + 1) & index_mask;
+  }
+  index[pos].slot = slot + 1;
+  index[pos].tag = (uint16_t)(hash >> 48);
+}
+
+void BeaconPresence::indexRemove(uint16_t slot) {
+  uint16_t hole = (uint16_t)entries[slot].key.hash & index_mask;
+  while (index[hole].slot != slot + 1) {
+    hole = (hole + 1) & index_mask;
+  }
+
+  // Backward-shift deletion: pull later entries of the run into the hole
+  // unless that would move them before their home position
+  uint16_t next = (hole + 1) & index_mask;
+  while (index[next].slot != 0) {
+    uint16_t home = (uint16_t)entries[index[next].slot - 1].key.hash & index_mask;
+    uint16_t displacement = (next - home) & index_mask;
+    uint16_t gap = (next - hole) & index_mask;
+
+    if (displacement >= gap) {
+      index[hole] = index[next];
+      hole = next;
+    }
+    next = (next + 1) & index_mask;
+  }
+
+  index[hole].slot = 0;
+}
@@ -0,0 +1,233 @@
+#ifndef BEACON_PRESENCE_H
+#define BEACON_PRESENCE_H
+
+#include <stdint.h>
+#include "BeaconData.h"
+#include "BeaconKey.h"
+#include "ScanObservation.h"
+
+// Timer wheel geometry: BEACON_PRESENCE_WHEEL_LEVELS levels of
+// 2^BEACON_PRESENCE_WHEEL_BITS slots; timeouts up to 2^24 ticks
+#define BEACON_PRESENCE_WHEEL_BITS 6
+#define BEACON_PRESENCE_WHEEL_LEVELS 4
+#define BEACON_PRESENCE_WHEEL_SLOTS (1 << BEACON_PRESENCE_WHEEL_BITS)
+
+/**
+ * @brief Presence transitions
+ */
+enum BeaconPresenceEventType {
+  BEACON_PRESENCE_ENTER,         // First packet at or above the enter threshold
+  BEACON_PRESENCE_EXIT_TIMEOUT,  // No packet within the timeout
+  BEACON_PRESENCE_EXIT_SIGNAL    // Smoothed RSSI fell below the exit threshold
+};
+
+/**
+ * @brief One enter or exit transition
+ */
+struct BeaconPresenceEvent {
+  BeaconKey key;
+  uint32_t time;                 // Packet time, or the tick the timeout fired on
+  int8_t rssi;                   // Packet RSSI (enter) or smoothed RSSI (exit)
+  BeaconPresenceEventType type;
+};
+
+/**
+ * @brief Called for each presence transition
+ *
+ * Runs inside update() / advance(); it must not call back into the engine.
+ */
+typedef void (*BeaconPresenceHandler)(const BeaconPresenceEvent& event, void* context);
+
+/**
+ * @brief Enter / exit event engine for beacons
+ *
+ * A beacon enters when a packet arrives at or above the enter RSSI
+ * threshold, and exits when no packet has arrived within the timeout or
+ * its smoothed RSSI (exponential average, weight 1/4) drops below the exit
+ * threshold. Setting the exit threshold below the enter threshold gives
+ * hysteresis, so a beacon hovering at the edge does not flap.
+ *
+ * Timeouts live in a hierarchical timer wheel (4 levels of 64 slots, with
+ * intrusive lists): refreshing a timeout on every packet and expiring it
+ * are O(1) whatever the population, and advance() only visits the slots
+ * whose time has come instead of scanning every beacon.
+ *
+ * Times are in milliseconds (or any unit, consistently), quantised to the
+ * tick given at construction; wrap-around of the time the caller passes
+ * (typically millis()) is handled. Storage is provided by BeaconPresenceBuffer.
+ *
+ * Usage:
+ * @code
+ * static BeaconPresenceBuffer<1024> presence(10000);  // Exit after 10 s of silence
+ *
+ * void on_presence(const BeaconPresenceEvent& event, void* context) {
+ *   // event.type, event.key
+ * }
+ *
+ * presence.setHandler(on_presence, nullptr);
+ * presence.setThresholds(-75, -85);
+ * presence.update(result, rssi, millis());
+ * presence.advance(millis());  // Fires timeouts when no packets arrive
+ * @endcode
+ */
+class BeaconPresence {
+ public:
+  /**
+   * @brief Per-beacon state and wheel links
+   */
+  struct Entry {
+    BeaconKey key;
+    uint32_t expires;  // Tick the timeout fires on
+    uint16_t prev;     // Wheel list links (0xFFFF at the ends)
+    uint16_t next;
+    uint16_t bucket;   // Wheel list holding the entry (level * slots + slot)
+    int16_t rssi_x4;   // Smoothed RSSI, times 4
+  };
+
+  /**
+   * @brief Hash index entry (slot + 1, 0 for empty)
+   */
+  struct IndexEntry {
+    uint16_t slot;
+    uint16_t tag;
+  };
+
+  void setHandler(BeaconPresenceHandler presence_handler, void* presence_context) {
+    handler = presence_handler;
+    context = presence_context;
+  }
+
+  /**
+   * @brief Set the RSSI hysteresis band
+   * @param enter_rssi Packets below this do not make an absent beacon present
+   * @param exit_rssi A present beacon exits when its smoothed RSSI drops below this
+   */
+  void setThresholds(int8_t enter_rssi, int8_t exit_rssi) {
+    enter_threshold = enter_rssi;
+    exit_threshold = exit_rssi;
+  }
+
+  /**
+   * @brief Record a packet, firing any due timeouts first
+   * @return true if the beacon is present after the packet
+   */
+  bool update(const BeaconKey& key, int8_t rssi, uint32_t now);
+
+  /**
+   * @brief Record a packet keyed on the beacon's own identity
+   */
+  bool update(const BeaconData& data, int8_t rssi, uint32_t now) {
+    return update(BeaconKey::fromData(data), rssi, now);
+  }
+
+  /**
+   * @brief Record a packet using the observation's RSSI and time (in milliseconds)
+   */
+  bool update(const BeaconKey& key, const ScanObservation& observation) {
+    return update(key, observation.rssi, observation.timestampMs());
+  }
+
+  /**
+   * @brief Fire every timeout due at or before now
+   */
+  void advance(uint32_t now);
+
+  /**
+   * @brief Whether a beacon is currently present
+   */
+  bool present(const BeaconKey& key) const {
+    return findSlot(key) >= 0;
+  }
+
+  /**
+   * @brief Forget all beacons without firing events
+   */
+  void clear();
+
+  uint16_t size() const {
+    return slot_count - free_count;
+  }
+
+  uint16_t capacity() const {
+    return slot_count;
+  }
+
+  /**
+   * @brief Enter transitions dropped because the table was full
+   */
+  uint32_t overflows() const {
+    return overflow_count;
+  }
+
+ protected:
+  /**
+   * @param entry_storage Array of capacity entries
+   * @param free_storage Array of capacity slot numbers
+   * @param index_storage Array of 2 * capacity index entries
+   * @param capacity Number of beacons (power of two, at most 32768)
+   * @param timeout Time without packets before a beacon exits
+   * @param tick Timer resolution (timeouts fire up to one tick late)
+   */
+  BeaconPresence(Entry* entry_storage, uint16_t* free_storage, IndexEntry* index_storage,
+                 uint16_t capacity, uint32_t timeout, uint32_t tick);
+
+  // Entries live in the derived storage, so the engine must not be copied
+  BeaconPresence(const BeaconPresence&) = delete;
+  BeaconPresence& operator=(const BeaconPresence&) = delete;
+
+ private:
+  int32_t findSlot(const BeaconKey& key) const;
+  void indexInsert(uint16_t slot);
+  void indexRemove(uint16_t slot);
+  void refresh(uint16_t slot, uint32_t now);
+  void schedule(uint16_t slot);
+  void unschedule(uint16_t slot);
+  void cascade(uint8_t level);
+  void release(uint16_t slot);
+  void emit(uint16_t slot, BeaconPresenceEventType type, int8_t rssi, uint32_t time);
+
+  Entry* entries;
+  uint16_t* free_slots;
+  IndexEntry* index;
+  BeaconPresenceHandler handler;
+  void* context;
+  uint16_t wheel[BEACON_PRESENCE_WHEEL_LEVELS * BEACON_PRESENCE_WHEEL_SLOTS];
+  uint32_t timeout_length;
+  uint32_t tick_length;
+  uint32_t current_tick;  // Free-running tick counter
+  uint32_t tick_time;     // Time the current tick began
+  uint32_t overflow_count;
+  uint16_t slot_count;
+  uint16_t index_mask;
+  uint16_t free_count;
+  int8_t enter_threshold;
+  int8_t exit_threshold;
+  bool started;
+};
+
+/**
+ * @brief BeaconPresence with inline storage for N beacons
+ */
+template <uint16_t N>
+class BeaconPresenceBuffer : public BeaconPresence {
+  static_assert(N >= 2 && N <= 32768 && (N & (N - 1)) == 0,
+                "Presence capacity must be a power of two between 2 and 32768");
+
+ public:
+  /**
+   * @param timeout Time without packets before a beacon exits
+   * @param tick Timer resolution
+   */
+  explicit BeaconPresenceBuffer(uint32_t timeout, uint32_t tick = 100)
+      : BeaconPresence(entry_storage, free_storage, index_storage, N, timeout, tick) {
+    // Storage is constructed after the base class, so empty it here
+    clear();
+  }
+
+ private:
+  Entry entry_storage[N];
+  uint16_t free_storage[N];
+  IndexEntry index_storage[2 * N];
+};
+
+#endif  // BEACON_PRESENCE_H
@@ -0,0 +1,356 @@
+#include "BeaconRegionIndex.h"
+#include <string.h>
+#include "BeaconHash.h"
+
+void BeaconRegion::set(uint32_t region_id, BeaconType format, const uint8_t* identity,
+                       uint8_t identity_len) {
+  if (identity_len > BEACON_REGION_ID_LENGTH) {
+    identity_len = BEACON_REGION_ID_LENGTH;
+  }
+
+  memcpy(bytes, identity, identity_len);
+  memset(&bytes[identity_len], 0, BEACON_REGION_ID_LENGTH - identity_len);
+  id = region_id;
+  type = format;
+  len = identity_len;
+  major_min = 0;
+  major_max = 0xFFFF;
+  minor_min = 0;
+  minor_max = 0xFFFF;
+}
+
+static uint64_t hashPrefix(uint8_t type, const uint8_t* bytes, uint8_t len) {
+  return BeaconHash::hash64(bytes, len, ((uint32_t)type << 8) | len);
+}
+
+static bool samePrefix(const BeaconRegion& a, const BeaconRegion& b) {
+  return a.type == b.type && a.len == b.len && memcmp(a.bytes, b.bytes, a.len) == 0;
+}
+
+// Orders by prefix (so groups are contiguous), then by major range (so
+// bands are contiguous and sorted by major_min), then by minor_min
+static bool regionLess(const BeaconRegion& a, const BeaconRegion& b) {
+  if (a.type != b.type) {
+    return a.type < b.type;
+  }
+  if (a.len != b.len) {
+    return a.len < b.len;
+  }
+  int order = memcmp(a.bytes, b.bytes, a.len);
+  if (order != 0) {
+    return order < 0;
+  }
+  if (a.major_min != b.major_min) {
+    return a.major_min < b.major_min;
+  }
+  if (a.major_max != b.major_max) {
+    return a.major_max < b.major_max;
+  }
+  return a.minor_min < b.minor_min;
+}
+
+// Implicit interval trees: a range [lo, hi) of intervals sorted by their
+// low end is a balanced tree rooted at its midpoint, and each node holds
+// the highest high end in its subtree. Depth is at most 32.
+
+// A group's bands, by major range
+struct BandTree {
+  BeaconRegionIndex::Band* bands;
+
+  uint16_t low(uint32_t i) const {
+    return bands[i].major_min;
+  }
+  uint16_t high(uint32_t i) const {
+    return bands[i].major_max;
+  }
+  uint16_t& reach(uint32_t i) const {
+    return bands[i].reach;
+  }
+};
+
+// A band's regions, by minor range
+struct MinorTree {
+  BeaconRegion* regions;
+  uint16_t* maxima;
+
+  uint16_t low(uint32_t i) const {
+    return regions[i].minor_min;
+  }
+  uint16_t high(uint32_t i) const {
+    return regions[i].minor_max;
+  }
+  uint16_t& reach(uint32_t i) const {
+    return maxima[i];
+  }
+};
+
+template <class Tree>
+static uint16_t buildTree(const Tree& tree, uint32_t lo, uint32_t hi) {
+  if (lo >= hi) {
+    return 0;
+  }
+
+  uint32_t mid = lo + (hi - lo) / 2;
+  uint16_t highest = tree.high(mid);
+  uint16_t left = buildTree(tree, lo, mid);
+  uint16_t right = buildTree(tree, mid + 1, hi);
+  if (left > highest) {
+    highest = left;
+  }
+  if (right > highest) {
+    highest = right;
+  }
+  tree.reach(mid) = highest;
+  return highest;
+}
+
+// Calls visit(i) for every interval holding point; stops early (returning
+// false) when visit does
+template <class Tree, class Visit>
+static bool stabTree(const Tree& tree, uint32_t lo, uint32_t hi, uint16_t point, Visit& visit) {
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+
+    // Nothing below this node reaches point
+    if (tree.reach(mid) < point) {
+      return true;
+    }
+    if (!stabTree(tree, lo, mid, point, visit)) {
+      return false;
+    }
+
+    // This node and its right subtree start after point
+    if (tree.low(mid) > point) {
+      return true;
+    }
+    if (tree.high(mid) >= point && !visit(mid)) {
+      return false;
+    }
+    lo = mid + 1;
+  }
+  return true;
+}
+
+BeaconRegionIndex::BeaconRegionIndex(BeaconRegion* region_storage, uint16_t* reach_storage,
+                                     Band* band_storage, Group* group_storage, uint32_t capacity)
+    : regions(region_storage),
+      reach(reach_storage),
+      bands(band_storage),
+      groups(group_storage),
+      region_capacity(capacity),
+      region_count(0),
+      group_mask(2 * capacity - 1),
+      group_count(0),
+      built(false) {}
+
+void BeaconRegionIndex::clear() {
+  memset(groups, 0, sizeof(Group) * (group_mask + 1));
+  region_count = 0;
+  group_count = 0;
+  built = true;
+}
+
+bool BeaconRegionIndex::add(const BeaconRegion& region) {
+  if (region_count >= region_capacity || region.major_min > region.major_max ||
+      region.minor_min > region.minor_max) {
+    return false;
+  }
+
+  switch (region.type) {
+    case BEACON_TYPE_IBEACON:
+    case BEACON_TYPE_ALTBEACON:
+      if (region.len != BEACON_REGION_ID_LENGTH) {
+        return false;
+      }
+      break;
+
+    case BEACON_TYPE_EDDYSTONE_UID:
+      if (region.len != BEACON_REGION_ID_LENGTH && region.len != BEACON_REGION_NAMESPACE_LENGTH) {
+        return false;
+      }
+      break;
+
+    default:
+      return false;
+  }
+
+  BeaconRegion& stored = regions[region_count++];
+  stored = region;
+  if (stored.type == BEACON_TYPE_EDDYSTONE_UID) {
+    // No major / minor fields to match on
+    stored.setMajor(0, 0xFFFF);
+    stored.setMinor(0, 0xFFFF);
+  }
+  built = false;
+  return true;
+}
+
+void BeaconRegionIndex::build() {
+  sortRegions();
+  memset(groups, 0, sizeof(Group) * (group_mask + 1));
+  group_count = 0;
+
+  BandTree band_tree = {bands};
+  MinorTree minor_tree = {regions, reach};
+  uint32_t band_total = 0;
+
+  uint32_t start = 0;
+  while (start < region_count) {
+    uint32_t end = start + 1;
+    while (end < region_count && samePrefix(regions[start], regions[end])) {
+      end++;
+    }
+
+    // Split the group into bands of equal major range, each with its minor tree
+    uint32_t band_start = band_total;
+    for (uint32_t i = start; i < end;) {
+      Band& band = bands[band_total++];
+      band.start = i;
+      band.major_min = regions[i].major_min;
+      band.major_max = regions[i].major_max;
+      while (i < end && regions[i].major_min == band.major_min &&
+             regions[i].major_max == band.major_max) {
+        i++;
+      }
+      band.count = i - band.start;
+      buildTree(minor_tree, band.start, i);
+    }
+    buildTree(band_tree, band_start, band_total);
+
+    const BeaconRegion& first = regions[start];
+    uint64_t hash = hashPrefix(first.type, first.bytes, first.len);
+    uint32_t pos = (uint32_t)hash & group_mask;
+
+    // At most half full, so an empty entry is always found
+    while (groups[pos].count != 0) {
+      pos = (pos + 1) & group_mask;
+    }
+    groups[pos].start = start;
+    groups[pos].count = end - start;
+    groups[pos].band_start = band_start;
+    groups[pos].band_count = band_total - band_start;
+    groups[pos].tag = (uint32_t)(hash >> 32);
+    group_count++;
+
+    start = end;
+  }
+
+  built = true;
+}
+
+uint16_t BeaconRegionIndex::match(const BeaconData& data, uint32_t* ids, uint16_t max_ids) const {
+  if (!built || !data.valid) {
+    return 0;
+  }
+
+  const Group* group;
+  uint16_t found = 0;
+
+  switch (data.type) {
+    case BEACON_TYPE_IBEACON:
+      group = findGroup(data.type, data.ibeacon.uuid, BEACON_REGION_ID_LENGTH);
+      if (group != nullptr) {
+        found = stab(*group, data.ibeacon.major, data.ibeacon.minor, ids, max_ids, found);
+      }
+      break;
+
+    case BEACON_TYPE_ALTBEACON:
+      group = findGroup(data.type, data.altbeacon.id, BEACON_REGION_ID_LENGTH);
+      if (group != nullptr) {
+        found = stab(*group, data.altbeacon.major, data.altbeacon.minor, ids, max_ids, found);
+      }
+      break;
+
+    case BEACON_TYPE_EDDYSTONE_UID: {
+      // Namespace-wide regions, then namespace + instance regions
+      uint8_t identity[BEACON_REGION_ID_LENGTH];
+      memcpy(identity, data.eddystone_uid.namespace_id, BEACON_REGION_NAMESPACE_LENGTH);
+      memcpy(&identity[BEACON_REGION_NAMESPACE_LENGTH], data.eddystone_uid.instance_id,
+             BEACON_REGION_ID_LENGTH - BEACON_REGION_NAMESPACE_LENGTH);
+
+      group = findGroup(data.type, identity, BEACON_REGION_NAMESPACE_LENGTH);
+      if (group != nullptr) {
+        found = stab(*group, 0, 0, ids, max_ids, found);
+      }
+      group = findGroup(data.type, identity, BEACON_REGION_ID_LENGTH);
+      if (group != nullptr) {
+        found = stab(*group, 0, 0, ids, max_ids, found);
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  return found;
+}
+
+const BeaconRegionIndex::Group* BeaconRegionIndex::findGroup(uint8_t type, const uint8_t* bytes,
+                                                             uint8_t len) const {
+  uint64_t hash = hashPrefix(type, bytes, len);
+  uint32_t tag = (uint32_t)(hash >> 32);
+  uint32_t pos = (uint32_t)hash & group_mask;
+
+  while (groups[pos].count != 0) {
+    const Group& group = groups[pos];
+    const BeaconRegion& first = regions[group.start];
+    if (group.tag == tag && first.type == type && first.len == len &&
+        memcmp(first.bytes, bytes, len) == 0) {
+      return &group;
+    }
+    pos = (pos + 1) & group_mask;
+  }
+  return nullptr;
+}
+
+uint16_t BeaconRegionIndex::stab(const Group& group, uint16_t major, uint16_t minor,
+                                 uint32_t* ids, uint16_t max_ids, uint16_t found) const {
+  MinorTree minor_tree = {regions, reach};
+  BandTree band_tree = {bands};
+
+  auto add_region = [&](uint32_t i) {
+    if (found == max_ids) {
+      return false;
+    }
+    ids[found++] = regions[i].id;
+    return true;
+  };
+
+  // Bands holding major, then their regions holding minor
+  auto search_band = [&](uint32_t i) {
+    return stabTree(minor_tree, bands[i].start, bands[i].start + bands[i].count, minor, add_region);
+  };
+
+  stabTree(band_tree, group.band_start, group.band_start + group.band_count, major, search_band);
+  return found;
+}
+
+void BeaconRegionIndex::sortRegions() {
+  // Heapsort: in place, no recursion, O(n log n) worst case
+  for (uint32_t root = region_count / 2; root > 0; root--) {
+    siftDown(root - 1, region_count);
+  }
+  for (uint32_t end = region_count; end > 1; end--) {
+    BeaconRegion top = regions[0];
+    regions[0] = regions[end - 1];
+    regions[end - 1] = top;
+    siftDown(0, end - 1);
+  }
+}
+
+void BeaconRegionIndex::siftDown(uint32_t root, uint32_t end) {
+  while (2 * root + 1 < end) {
+    uint32_t child = 2 * root + 1;
+    if (child + 1 < end && regionLess(regions[child], regions[child + 1])) {
+      child++;
+    }
+    if (!regionLess(regions[root], regions[child])) {
+      return;
+    }
+    BeaconRegion swap = regions[root];
+    regions[root] = regions[child];
+    regions[child] = swap;
+    root = child;
+  }
+}
@@ -0,0 +1,208 @@
+#ifndef BEACON_REGION_INDEX_H
+#define BEACON_REGION_INDEX_H
+
+#include <stdint.h>
+#include "BeaconData.h"
+
+// Identity bytes of a region: iBeacon UUID, AltBeacon ID or Eddystone namespace + instance
+#define BEACON_REGION_ID_LENGTH 16
+
+// Prefix length of an Eddystone-UID region covering a whole namespace
+#define BEACON_REGION_NAMESPACE_LENGTH 10
+
+/**
+ * @brief One configured region
+ *
+ * - iBeacon / AltBeacon: 16-byte UUID or beacon ID, with inclusive major
+ *   and minor ranges (the full range when not restricted)
+ * - Eddystone-UID: 10-byte namespace (any instance) or 16-byte namespace +
+ *   instance; major and minor ranges are ignored
+ */
+struct BeaconRegion {
+  uint8_t bytes[BEACON_REGION_ID_LENGTH];  // Identity prefix (zero padded)
+  uint32_t id;                             // Caller's region ID, reported on match
+  uint16_t major_min;
+  uint16_t major_max;
+  uint16_t minor_min;
+  uint16_t minor_max;
+  uint8_t type;                            // BeaconType format tag
+  uint8_t len;                             // Identity bytes in use
+
+  /**
+   * @brief Set the identity prefix, matching every major and minor
+   * @param region_id ID reported for packets in the region
+   * @param format BEACON_TYPE_IBEACON, BEACON_TYPE_ALTBEACON or BEACON_TYPE_EDDYSTONE_UID
+   * @param identity Identity bytes
+   * @param identity_len 16, or BEACON_REGION_NAMESPACE_LENGTH for an Eddystone namespace
+   */
+  void set(uint32_t region_id, BeaconType format, const uint8_t* identity, uint8_t identity_len);
+
+  /**
+   * @brief Restrict the region to majors in [low, high]
+   */
+  void setMajor(uint16_t low, uint16_t high) {
+    major_min = low;
+    major_max = high;
+  }
+
+  /**
+   * @brief Restrict the region to minors in [low, high]
+   */
+  void setMinor(uint16_t low, uint16_t high) {
+    minor_min = low;
+    minor_max = high;
+  }
+};
+
+/**
+ * @brief Region lookup table for large region sets
+ *
+ * Regions sharing a format and identity prefix form a group. Groups are
+ * found by hashing the packet's identity bytes, so UUIDs are compared as
+ * bytes once per lookup rather than per region.
+ *
+ * Within a group, regions with the same major range form a band. The
+ * group's bands are an implicit interval tree on major: sorted by
+ * major_min, with each node holding the highest major_max beneath it.
+ * Each band's regions are a second tree of the same kind on minor. A
+ * lookup costs one hash, one probe and O((1 + b + m) log n), where b is
+ * the number of bands whose major range holds the packet's major and m
+ * the number of matches. Thousands of regions sharing one UUID and major
+ * are therefore searched by minor rather than one by one.
+ *
+ * Regions are added, then build() sorts them and fills the group table.
+ * Storage is provided by BeaconRegionIndexBuffer; nothing is allocated.
+ *
+ * Usage:
+ * @code
+ * static BeaconRegionIndexBuffer<16384> regions;
+ *
+ * BeaconRegion region;
+ * region.set(42, BEACON_TYPE_IBEACON, uuid, 16);
+ * region.setMajor(100, 199);
+ * regions.add(region);
+ * regions.build();
+ *
+ * uint32_t ids[8];
+ * uint16_t found = regions.match(result, ids, 8);
+ * @endcode
+ */
+class BeaconRegionIndex {
+ public:
+  /**
+   * @brief Group table entry (count 0 for empty)
+   */
+  struct Group {
+    uint32_t start;       // First region of the group
+    uint32_t count;       // Regions in the group
+    uint32_t band_start;  // First band of the group
+    uint32_t band_count;  // Bands in the group
+    uint32_t tag;         // High half of the identity hash
+  };
+
+  /**
+   * @brief Regions of a group sharing one major range
+   */
+  struct Band {
+    uint32_t start;      // First region of the band
+    uint32_t count;      // Regions in the band
+    uint16_t major_min;
+    uint16_t major_max;
+    uint16_t reach;      // Highest major_max in this node's subtree
+  };
+
+  /**
+   * @brief Add a region (call build() before matching)
+   * @return false if the region is malformed or the index is full
+   */
+  bool add(const BeaconRegion& region);
+
+  /**
+   * @brief Sort the regions and build the group table
+   */
+  void build();
+
+  /**
+   * @brief Find the regions containing a parsed beacon
+   * @param data Parsed beacon
+   * @param ids Output array of region IDs, in no particular order
+   * @param max_ids Size of ids
+   * @return Number of IDs written (0 if the index has not been built since the last add)
+   */
+  uint16_t match(const BeaconData& data, uint32_t* ids, uint16_t max_ids) const;
+
+  /**
+   * @brief Remove all regions
+   */
+  void clear();
+
+  uint32_t size() const {
+    return region_count;
+  }
+
+  uint32_t capacity() const {
+    return region_capacity;
+  }
+
+  /**
+   * @brief Number of distinct identity prefixes (after build())
+   */
+  uint32_t groupCount() const {
+    return group_count;
+  }
+
+ protected:
+  /**
+   * @param region_storage Array of capacity regions
+   * @param reach_storage Array of capacity minor tree maxima
+   * @param band_storage Array of capacity bands
+   * @param group_storage Array of 2 * capacity group entries
+   * @param capacity Number of regions (power of two)
+   */
+  BeaconRegionIndex(BeaconRegion* region_storage, uint16_t* reach_storage, Band* band_storage,
+                    Group* group_storage, uint32_t capacity);
+
+  // Regions live in the derived storage, so the index must not be copied
+  BeaconRegionIndex(const BeaconRegionIndex&) = delete;
+  BeaconRegionIndex& operator=(const BeaconRegionIndex&) = delete;
+
+ private:
+  const Group* findGroup(uint8_t type, const uint8_t* bytes, uint8_t len) const;
+  uint16_t stab(const Group& group, uint16_t major, uint16_t minor, uint32_t* ids,
+                uint16_t max_ids, uint16_t found) const;
+  void sortRegions();
+  void siftDown(uint32_t root, uint32_t end);
+
+  BeaconRegion* regions;
+  uint16_t* reach;
+  Band* bands;
+  Group* groups;
+  uint32_t region_capacity;
+  uint32_t region_count;
+  uint32_t group_mask;
+  uint32_t group_count;
+  bool built;
+};
+
+/**
+ * @brief BeaconRegionIndex with inline storage for N regions
+ */
+template <uint32_t N>
+class BeaconRegionIndexBuffer : public BeaconRegionIndex {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "Region capacity must be a power of two");
+
+ public:
+  BeaconRegionIndexBuffer()
+      : BeaconRegionIndex(region_storage, reach_storage, band_storage, group_storage, N) {
+    // Storage is constructed after the base class, so empty it here
+    clear();
+  }
+
+ private:
+  BeaconRegion region_storage[N];
+  uint16_t reach_storage[N];
+  Band band_storage[N];
+  Group group_storage[2 * N];
+};
+
+#endif  // BEACON_REGION_INDEX_H
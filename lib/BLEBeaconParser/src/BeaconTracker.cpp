@@ -0,0 +1,210 @@
+#include "BeaconTracker.h"
+
+#define TRACK_OCCUPIED 0x01
+#define TRACK_HAS_TLM 0x02
+
+static_assert(sizeof(BeaconTrackerHot) == 16, "Hot tracker entries must stay 16 bytes");
+
+BeaconTracker::BeaconTracker(BeaconTrackerHot* hot_storage, BeaconTrackerCold* cold_storage,
+                             uint16_t capacity)
+    : hot(hot_storage),
+      cold(cold_storage),
+      slot_mask(capacity - 1),
+      count(0),
+      eviction_count(0) {}
+
+void BeaconTracker::clear() {
+  for (uint16_t i = 0; i <= slot_mask; i++) {
+    hot[i].flags = 0;
+  }
+  count = 0;
+  eviction_count = 0;
+}
+
+bool BeaconTracker::update(const BeaconData& data, int8_t rssi, uint32_t now) {
+  return update(BeaconKey::fromData(data), data, rssi, now);
+}
+
+bool BeaconTracker::update(const BeaconKey& key, const BeaconData& data, int8_t rssi,
+                           uint32_t now) {
+  if (!key.valid()) {
+    return false;
+  }
+
+  int32_t found = findSlot(key);
+  uint16_t slot;
+
+  if (found >= 0) {
+    slot = (uint16_t)found;
+  } else {
+    uint32_t tag = (uint32_t)key.hash;
+
+    // Keep at least a quarter of the slots empty so probe runs stay short
+    if (count >= capacity() - capacity() / 4) {
+      evictNear(tag, now);
+    }
+
+    slot = insertSlot(tag);
+    hot[slot].packet_count = 0;
+    cold[slot].key = key;
+    cold[slot].first_seen = now;
+  }
+
+  BeaconTrackerHot& entry = hot[slot];
+  entry.last_seen = now;
+  entry.last_rssi = rssi;
+  entry.packet_count++;
+
+  if (data.valid && data.type == BEACON_TYPE_EDDYSTONE_TLM) {
+    cold[slot].tlm = data.eddystone_tlm;
+    cold[slot].tlm_seen = now;
+    entry.flags |= TRACK_HAS_TLM;
+  }
+
+  return true;
+}
+
+bool BeaconTracker::find(const BeaconKey& key, BeaconTrackInfo& info) const {
+  int32_t slot = findSlot(key);
+  if (slot < 0) {
+    return false;
+  }
+  fillInfo((uint16_t)slot, info);
+  return true;
+}
+
+bool BeaconTracker::remove(const BeaconKey& key) {
+  int32_t slot = findSlot(key);
+  if (slot < 0) {
+    return false;
+  }
+  removeSlot((uint16_t)slot);
+  return true;
+}
+
+uint16_t BeaconTracker::expire(uint32_t now, uint32_t max_age) {
+  uint16_t removed = 0;
+  uint16_t i = 0;
+
+  while (i <= slot_mask) {
+    const BeaconTrackerHot& entry = hot[i];
+    if ((entry.flags & TRACK_OCCUPIED) && (uint32_t)(now - entry.last_seen) > max_age) {
+      // Backward shift may move a later entry into this slot, so re-check it
+      removeSlot(i);
+      removed++;
+    } else {
+      i++;
+    }
+  }
+
+  return removed;
+}
+
+bool BeaconTracker::entryAt(uint16_t index, BeaconTrackInfo& info) const {
+  if (index > slot_mask || !(hot[index].flags & TRACK_OCCUPIED)) {
+    return false;
+  }
+  fillInfo(index, info);
+  return true;
+}
+
+int32_t BeaconTracker::findSlot(const BeaconKey& key) const {
+  if (!key.valid()) {
+    return -1;
+  }
+
+  uint32_t tag = (uint32_t)key.hash;
+  uint16_t slot = tag & slot_mask;
+
+  // The table is never full, so the run always ends at an empty slot
+  while (hot[slot].flags & TRACK_OCCUPIED) {
+    if (hot[slot].tag == tag && cold[slot].key == key) {
+      return slot;
+    }
+    slot = (slot + 1) & slot_mask;
+  }
+
+  return -1;
+}
+
+uint16_t BeaconTracker::insertSlot(uint32_t tag) {
+  uint16_t slot = tag & slot_mask;
+  while (hot[slot].flags & TRACK_OCCUPIED) {
+    slot = (slot + 1) & slot_mask;
+  }
+
+  hot[slot].tag = tag;
+  hot[slot].flags = TRACK_OCCUPIED;
+  hot[slot].reserved = 0;
+  count++;
+  return slot;
+}
+
+void BeaconTracker::removeSlot(uint16_t slot) {
+  uint16_t hole = slot;
+  uint16_t next = (hole + 1) & slot_mask;
+
+  // Backward-shift deletion: pull later entries of the run into the hole
+  // unless that would move them before their home slot
+  while (hot[next].flags & TRACK_OCCUPIED) {
+    uint16_t home = hot[next].tag & slot_mask;
+    uint16_t displacement = (next - home) & slot_mask;
+    uint16_t gap = (next - hole) & slot_mask;
+
+    if (displacement >= gap) {
+      hot[hole] = hot[next];
+      cold[hole] = cold[next];
+      hole = next;
+    }
+    next = (next + 1) & slot_mask;
+  }
+
+  hot[hole].flags = 0;
+  count--;
+}
+
+void BeaconTracker::evictNear(uint32_t tag, uint32_t now) {
+  uint16_t slot = tag & slot_mask;
+  uint16_t victim = slot;
+  uint32_t oldest_age = 0;
+  uint8_t sampled = 0;
+
+  // Sampled LRU: the least recently seen of the first few occupied slots
+  // from the new beacon's home slot
+  for (uint16_t step = 0; step <= slot_mask && sampled < BEACON_TRACKER_EVICT_SAMPLE; step++) {
+    const BeaconTrackerHot& entry = hot[slot];
+    if (entry.flags & TRACK_OCCUPIED) {
+      uint32_t age = now - entry.last_seen;
+      if (sampled == 0 || age > oldest_age) {
+        oldest_age = age;
+        victim = slot;
+      }
+      sampled++;
+    }
+    slot = (slot + 1) & slot_mask;
+  }
+
+  removeSlot(victim);
+  eviction_count++;
+}
+
+void BeaconTracker::fillInfo(uint16_t slot, BeaconTrackInfo& info) const {
+  const BeaconTrackerHot& entry = hot[slot];
+  const BeaconTrackerCold& state = cold[slot];
+
+  info.key = state.key;
+  info.first_seen = state.first_seen;
+  info.last_seen = entry.last_seen;
+  info.packet_count = entry.packet_count;
+  info.last_rssi = entry.last_rssi;
+  info.has_tlm = (entry.flags & TRACK_HAS_TLM) != 0;
+  info.tlm_seen = info.has_tlm ? state.tlm_seen : 0;
+  if (info.has_tlm) {
+    info.tlm = state.tlm;
+  } else {
+    info.tlm.battery_voltage = 0;
+    info.tlm.temperature = 0;
+    info.tlm.adv_count = 0;
+    info.tlm.uptime = 0;
+  }
+}
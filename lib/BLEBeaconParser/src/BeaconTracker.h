@@ -0,0 +1,197 @@
+#ifndef BEACON_TRACKER_H
+#define BEACON_TRACKER_H
+
+#include <stdint.h>
+#include "BeaconData.h"
+#include "BeaconKey.h"
+#include "ScanObservation.h"
+
+// Occupied slots examined when choosing an entry to evict
+#define BEACON_TRACKER_EVICT_SAMPLE 8
+
+/**
+ * @brief Hot per-beacon state, touched on every observation
+ *
+ * 16 bytes, so four entries share a 64-byte cache line and probing never
+ * leaves the hot array.
+ */
+struct BeaconTrackerHot {
+  uint32_t tag;           // Low 32 bits of the key hash (low bits select the home slot)
+  uint32_t last_seen;     // Time of the last observation (caller's clock, e.g. millis())
+  uint32_t packet_count;  // Observations since the beacon was first tracked
+  int8_t last_rssi;       // RSSI of the last observation
+  uint8_t flags;          // Occupied / TLM-present bits
+  uint16_t reserved;
+};
+
+/**
+ * @brief Cold per-beacon state, touched on insert, key confirmation and reads
+ */
+struct BeaconTrackerCold {
+  BeaconKey key;         // Full identity
+  EddystoneTLMData tlm;  // Latest telemetry snapshot
+  uint32_t first_seen;   // Time of the first observation
+  uint32_t tlm_seen;     // Time of the latest telemetry snapshot
+};
+
+/**
+ * @brief Copy of one tracked beacon's state
+ */
+struct BeaconTrackInfo {
+  BeaconKey key;
+  uint32_t first_seen;
+  uint32_t last_seen;
+  uint32_t packet_count;
+  int8_t last_rssi;
+  bool has_tlm;
+  uint32_t tlm_seen;
+  EddystoneTLMData tlm;
+};
+
+/**
+ * @brief Fixed-capacity table of per-beacon state
+ *
+ * Entries are keyed on BeaconKey and stored in a flat, preallocated
+ * open-addressing table (linear probing, backward-shift deletion, at most
+ * 3/4 full). State is split into a hot array probed on every update and a
+ * cold array holding the key and telemetry snapshot.
+ *
+ * When the table is at its load limit, inserting a new beacon evicts the
+ * least recently seen of the first BEACON_TRACKER_EVICT_SAMPLE entries
+ * around its home slot (sampled LRU). expire() ages out beacons that have
+ * not been seen for a given time. Nothing is allocated after construction.
+ *
+ * Storage is provided by BeaconTrackerBuffer. Times are in whatever unit
+ * the caller passes (typically millis()); wrap-around is handled.
+ *
+ * Usage:
+ * @code
+ * static BeaconTrackerBuffer<1024> tracker;
+ *
+ * BeaconKey key;
+ * if (parser.parse(data, len, result, key)) {
+ *   tracker.update(key, result, rssi, millis());
+ * }
+ * tracker.expire(millis(), 30000);
+ * @endcode
+ */
+class BeaconTracker {
+ public:
+  /**
+   * @brief Record an observation of a beacon
+   *
+   * Eddystone-TLM frames carry no identity; pass the key of the beacon they
+   * belong to (e.g. the UID key last seen from the same device address) to
+   * attach the telemetry snapshot.
+   *
+   * @param key Beacon identity
+   * @param data Parsed advertisement (TLM frames update the snapshot)
+   * @param rssi Received signal strength
+   * @param now Current time
+   * @return true if tracked, false if the key is empty
+   */
+  bool update(const BeaconKey& key, const BeaconData& data, int8_t rssi, uint32_t now);
+
+  /**
+   * @brief Record an observation keyed on the beacon's own identity
+   * @return true if tracked, false if the beacon has no identity fields
+   */
+  bool update(const BeaconData& data, int8_t rssi, uint32_t now);
+
+  /**
+   * @brief Record an observation using its RSSI and timestamp (in milliseconds)
+   * @return true if tracked, false if the key is empty
+   */
+  bool update(const BeaconKey& key, const BeaconData& data, const ScanObservation& observation) {
+    return update(key, data, observation.rssi, observation.timestampMs());
+  }
+
+  /**
+   * @brief Look up a tracked beacon
+   * @param key Beacon identity
+   * @param info Copy of the beacon's state
+   * @return true if the beacon is tracked
+   */
+  bool find(const BeaconKey& key, BeaconTrackInfo& info) const;
+
+  /**
+   * @brief Stop tracking a beacon
+   * @return true if the beacon was tracked
+   */
+  bool remove(const BeaconKey& key);
+
+  /**
+   * @brief Remove beacons not seen within max_age of now
+   * @return Number of beacons removed
+   */
+  uint16_t expire(uint32_t now, uint32_t max_age);
+
+  /**
+   * @brief Read the slot at index (0 to capacity() - 1) for iteration
+   * @return true if the slot holds a beacon
+   */
+  bool entryAt(uint16_t index, BeaconTrackInfo& info) const;
+
+  /**
+   * @brief Remove all beacons and reset the eviction counter
+   */
+  void clear();
+
+  uint16_t size() const {
+    return count;
+  }
+
+  uint16_t capacity() const {
+    return slot_mask + 1;
+  }
+
+  uint32_t evictions() const {
+    return eviction_count;
+  }
+
+ protected:
+  /**
+   * @param hot_storage Array of capacity hot entries
+   * @param cold_storage Array of capacity cold entries
+   * @param capacity Number of entries (power of two)
+   */
+  BeaconTracker(BeaconTrackerHot* hot_storage, BeaconTrackerCold* cold_storage,
+                uint16_t capacity);
+
+  // Entries live in the derived storage, so the tracker must not be copied
+  BeaconTracker(const BeaconTracker&) = delete;
+  BeaconTracker& operator=(const BeaconTracker&) = delete;
+
+ private:
+  int32_t findSlot(const BeaconKey& key) const;
+  uint16_t insertSlot(uint32_t tag);
+  void removeSlot(uint16_t slot);
+  void evictNear(uint32_t tag, uint32_t now);
+  void fillInfo(uint16_t slot, BeaconTrackInfo& info) const;
+
+  BeaconTrackerHot* hot;
+  BeaconTrackerCold* cold;
+  uint16_t slot_mask;
+  uint16_t count;
+  uint32_t eviction_count;
+};
+
+/**
+ * @brief BeaconTracker with inline storage for N beacons
+ */
+template <uint16_t N>
+class BeaconTrackerBuffer : public BeaconTracker {
+  static_assert(N >= 4 && (N & (N - 1)) == 0, "Tracker capacity must be a power of two");
+
+ public:
+  BeaconTrackerBuffer() : BeaconTracker(hot_storage, cold_storage, N) {
+    // Storage is constructed after the base class, so empty it here
+    clear();
+  }
+
+ private:
+  BeaconTrackerHot hot_storage[N];
+  BeaconTrackerCold cold_storage[N];
+};
+
+#endif  // BEACON_TRACKER_H
@@ -0,0 +1,64 @@
+#include "BeaconView.h"
+#include <string.h>
+#include "parsers/AltBeaconParser.h"
+#include "parsers/EddystoneParser.h"
+#include "parsers/EddystoneURL.h"
+#include "parsers/iBeaconParser.h"
+
+uint8_t BeaconView::urlToChars(char* out) const {
+  if (beacon_type != BEACON_TYPE_EDDYSTONE_URL) {
+    out[0] = '\0';
+    return 0;
+  }
+
+  // [Frame Type][TX Power][Scheme][Encoded URL...]
+  return EddystoneURLDecoder::expand(&field.data[2], field.len - 2, out);
+}
+
+BeaconKey BeaconView::key() const {
+  BeaconKey key;
+  uint8_t identity[BEACON_KEY_LENGTH];
+
+  switch (beacon_type) {
+    case BEACON_TYPE_IBEACON:
+      // UUID, major and minor are contiguous in the packet
+      key.set(beacon_type, &field.data[2], 20);
+      break;
+
+    case BEACON_TYPE_ALTBEACON:
+      memcpy(identity, &field.data[2], 16);
+      memcpy(&identity[16], &field.data[20], 4);  // Major, minor
+      key.set(beacon_type, identity, 20);
+      break;
+
+    case BEACON_TYPE_EDDYSTONE_UID:
+      // Namespace and instance are contiguous in the packet
+      key.set(beacon_type, &field.data[2], 16);
+      break;
+
+    default:
+      break;
+  }
+
+  return key;
+}
+
+bool BeaconView::decode(BeaconData& result) const {
+  switch (beacon_type) {
+    case BEACON_TYPE_IBEACON:
+      return iBeaconParser::decode(field, result);
+
+    case BEACON_TYPE_ALTBEACON:
+      return AltBeaconParser::decode(field, result);
+
+    case BEACON_TYPE_EDDYSTONE_UID:
+    case BEACON_TYPE_EDDYSTONE_URL:
+    case BEACON_TYPE_EDDYSTONE_TLM:
+      return EddystoneParser::decode(field, result);
+
+    default:
+      result.type = BEACON_TYPE_UNKNOWN;
+      result.valid = false;
+      return false;
+  }
+}
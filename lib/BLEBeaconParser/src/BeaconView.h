@@ -0,0 +1,219 @@
+#ifndef BEACON_VIEW_H
+#define BEACON_VIEW_H
+
+#include <stdint.h>
+#include "ADStructures.h"
+#include "BeaconData.h"
+#include "BeaconKey.h"
+
+/**
+ * @brief Lazy, zero-copy view of a beacon inside the caller's advertisement buffer
+ *
+ * BLEBeaconParser::parseView() only classifies the packet: the view records
+ * the beacon type and a pointer to the matching manufacturer / service data
+ * field. Each accessor decodes its big-endian field from the packet bytes
+ * when called, so filtering on type or identity costs nothing for the
+ * fields that are never read.
+ *
+ * The view borrows the advertisement buffer and is only valid while that
+ * buffer is. Accessors for fields the beacon type does not carry return 0
+ * (or nullptr for byte arrays).
+ *
+ * Usage:
+ * @code
+ * BeaconView view;
+ * if (parser.parseView(adv_data, adv_len, view) && view.type() == BEACON_TYPE_IBEACON &&
+ *     memcmp(view.uuidBytes(), wanted_uuid, 16) == 0) {
+ *   Serial.println(view.major());
+ * }
+ * @endcode
+ */
+class BeaconView {
+ public:
+  BeaconView() : beacon_type(BEACON_TYPE_UNKNOWN) {
+    field.type = 0;
+    field.id = 0;
+    field.data = nullptr;
+    field.len = 0;
+  }
+
+  /**
+   * @brief Point the view at a classified field
+   * @param type Beacon type the field classified as
+   * @param source Field inside the advertisement buffer
+   */
+  void set(BeaconType type, const ADField& source) {
+    beacon_type = type;
+    field = source;
+  }
+
+  /**
+   * @brief Reset to the unknown/invalid state
+   */
+  void clear() {
+    beacon_type = BEACON_TYPE_UNKNOWN;
+    field.data = nullptr;
+    field.len = 0;
+  }
+
+  BeaconType type() const {
+    return beacon_type;
+  }
+
+  bool valid() const {
+    return beacon_type != BEACON_TYPE_UNKNOWN;
+  }
+
+  /**
+   * @brief Field the view points at (payload after company ID / service UUID)
+   */
+  const ADField& rawField() const {
+    return field;
+  }
+
+  /**
+   * @brief 16 identity bytes inside the packet
+   *
+   * iBeacon UUID, AltBeacon beacon ID, or Eddystone-UID namespace (10 bytes)
+   * followed by instance (6 bytes); nullptr for other types.
+   */
+  const uint8_t* uuidBytes() const {
+    switch (beacon_type) {
+      case BEACON_TYPE_IBEACON:
+      case BEACON_TYPE_ALTBEACON:
+      case BEACON_TYPE_EDDYSTONE_UID:
+        return &field.data[2];
+      default:
+        return nullptr;
+    }
+  }
+
+  /**
+   * @brief Major (iBeacon, AltBeacon)
+   */
+  uint16_t major() const {
+    switch (beacon_type) {
+      case BEACON_TYPE_IBEACON:
+        return readU16(18);
+      case BEACON_TYPE_ALTBEACON:
+        return readU16(20);
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * @brief Minor (iBeacon, AltBeacon)
+   */
+  uint16_t minor() const {
+    switch (beacon_type) {
+      case BEACON_TYPE_IBEACON:
+        return readU16(20);
+      case BEACON_TYPE_ALTBEACON:
+        return readU16(22);
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * @brief TX power (iBeacon, Eddystone-UID/URL) or reference RSSI (AltBeacon)
+   */
+  int8_t txPower() const {
+    switch (beacon_type) {
+      case BEACON_TYPE_IBEACON:
+        return (int8_t)field.data[22];
+      case BEACON_TYPE_ALTBEACON:
+        return (int8_t)field.data[18];
+      case BEACON_TYPE_EDDYSTONE_UID:
+      case BEACON_TYPE_EDDYSTONE_URL:
+        return (int8_t)field.data[1];
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   * @brief Eddystone-UID namespace ID (10 bytes inside the packet)
+   */
+  const uint8_t* namespaceId() const {
+    return beacon_type == BEACON_TYPE_EDDYSTONE_UID ? &field.data[2] : nullptr;
+  }
+
+  /**
+   * @brief Eddystone-UID instance ID (6 bytes inside the packet)
+   */
+  const uint8_t* instanceId() const {
+    return beacon_type == BEACON_TYPE_EDDYSTONE_UID ? &field.data[12] : nullptr;
+  }
+
+  /**
+   * @brief Eddystone-TLM battery voltage in millivolts
+   */
+  uint16_t tlmBatteryMv() const {
+    return beacon_type == BEACON_TYPE_EDDYSTONE_TLM ? readU16(2) : 0;
+  }
+
+  /**
+   * @brief Eddystone-TLM temperature in 1/256 degrees Celsius (8.8 fixed point)
+   */
+  int16_t tlmTemperatureRaw() const {
+    return beacon_type == BEACON_TYPE_EDDYSTONE_TLM ? (int16_t)readU16(4) : 0;
+  }
+
+  /**
+   * @brief Eddystone-TLM advertisement count
+   */
+  uint32_t tlmAdvCount() const {
+    return beacon_type == BEACON_TYPE_EDDYSTONE_TLM ? readU32(6) : 0;
+  }
+
+  /**
+   * @brief Eddystone-TLM time since boot in 0.1 second units
+   */
+  uint32_t tlmUptimeDeciseconds() const {
+    return beacon_type == BEACON_TYPE_EDDYSTONE_TLM ? readU32(10) : 0;
+  }
+
+  /**
+   * @brief AltBeacon manufacturer reserved byte
+   */
+  uint8_t mfgReserved() const {
+    return beacon_type == BEACON_TYPE_ALTBEACON ? field.data[19] : 0;
+  }
+
+  /**
+   * @brief Expand the Eddystone-URL into a caller buffer
+   * @param out Buffer of at least EDDYSTONE_URL_MAX_LENGTH + 1 bytes (NUL-terminated)
+   * @return Length of the URL, or 0 if the view is not an Eddystone-URL
+   */
+  uint8_t urlToChars(char* out) const;
+
+  /**
+   * @brief Canonical identity key of the viewed beacon (see BeaconKey)
+   * @return Key, empty for types without identity fields
+   */
+  BeaconKey key() const;
+
+  /**
+   * @brief Fully decode the viewed beacon
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if the beacon was decoded
+   */
+  bool decode(BeaconData& result) const;
+
+ private:
+  uint16_t readU16(uint8_t offset) const {
+    return ((uint16_t)field.data[offset] << 8) | field.data[offset + 1];
+  }
+
+  uint32_t readU32(uint8_t offset) const {
+    return ((uint32_t)field.data[offset] << 24) | ((uint32_t)field.data[offset + 1] << 16) |
+           ((uint32_t)field.data[offset + 2] << 8) | (uint32_t)field.data[offset + 3];
+  }
+
+  ADField field;
+  BeaconType beacon_type;
+};
+
+#endif  // BEACON_VIEW_H
@@ -0,0 +1,82 @@
+#ifndef SCAN_OBSERVATION_H
+#define SCAN_OBSERVATION_H
+
+#include <stdint.h>
+
+// ScanObservation::rssi / tx_power value when the stack does not report one
+#define SCAN_OBSERVATION_UNAVAILABLE 127
+
+// ScanObservation::flags (same bit positions as the HCI LE Extended
+// Advertising Report event type)
+#define SCAN_OBSERVATION_CONNECTABLE 0x01
+#define SCAN_OBSERVATION_SCANNABLE 0x02
+#define SCAN_OBSERVATION_DIRECTED 0x04
+#define SCAN_OBSERVATION_SCAN_RESPONSE 0x08
+#define SCAN_OBSERVATION_LEGACY 0x10
+#define SCAN_OBSERVATION_INCOMPLETE 0x20  // Data_Status 01: more data follows in a later report
+#define SCAN_OBSERVATION_TRUNCATED 0x40   // Data_Status 10: the rest of the data was not received
+
+/**
+ * @brief One received advertisement with its radio metadata
+ *
+ * Carries who sent a payload, how strongly and when, next to a reference
+ * to the payload bytes, so the stages after the radio (parser, tracker,
+ * aggregation, uplink) pass a single 32-byte record around instead of
+ * keeping parallel structures.
+ *
+ * The payload is borrowed: it points into the caller's (or the scan
+ * stack's) buffer and is only valid while that buffer is.
+ */
+struct ScanObservation {
+  const uint8_t* payload;  // Advertisement data (borrowed)
+  uint64_t timestamp_us;   // Receive time in microseconds (caller's clock, 0 if unknown)
+  uint16_t payload_len;    // Length of advertisement data
+  uint8_t address[6];      // Advertiser address, as reported by the stack
+  uint8_t address_type;    // Advertiser address type (0 public, 1 random, ...)
+  int8_t rssi;             // Received signal strength in dBm
+  uint8_t channel;         // Channel the report was received on (0 if unknown)
+  int8_t tx_power;         // Advertised TX power in dBm (extended reports only)
+  uint8_t flags;           // SCAN_OBSERVATION_* event properties
+  uint8_t reserved;
+
+  ScanObservation() {
+    clear();
+  }
+
+  /**
+   * @brief Reset to an empty observation with no metadata
+   */
+  void clear() {
+    payload = nullptr;
+    timestamp_us = 0;
+    payload_len = 0;
+    for (uint8_t i = 0; i < sizeof(address); i++) {
+      address[i] = 0;
+    }
+    address_type = 0;
+    rssi = SCAN_OBSERVATION_UNAVAILABLE;
+    channel = 0;
+    tx_power = SCAN_OBSERVATION_UNAVAILABLE;
+    flags = 0;
+    reserved = 0;
+  }
+
+  /**
+   * @brief Whether the payload holds all of the advertising data
+   *
+   * False for a fragment of a chained extended advertisement, whose
+   * fields may continue in the next report or be cut off.
+   */
+  bool complete() const {
+    return (flags & (SCAN_OBSERVATION_INCOMPLETE | SCAN_OBSERVATION_TRUNCATED)) == 0;
+  }
+
+  /**
+   * @brief Receive time in milliseconds (the unit BeaconTracker uses)
+   */
+  uint32_t timestampMs() const {
+    return (uint32_t)(timestamp_us / 1000);
+  }
+};
+
+#endif  // SCAN_OBSERVATION_H
@@ -0,0 +1,77 @@
+#include "ScanRing.h"
+#include <string.h>
+
+ScanRing::ScanRing(ScanRingSlot* storage, uint16_t capacity)
+    : slots(storage),
+      slot_mask(capacity - 1),
+      head(0),
+      tail(0),
+      overflow_count(0),
+      oversize_count(0) {}
+
+bool ScanRing::push(const uint8_t* data, uint16_t len, int8_t rssi, const uint8_t* address,
+                    uint8_t address_type) {
+  ScanObservation observation;
+  observation.payload = data;
+  observation.payload_len = len;
+  observation.rssi = rssi;
+  observation.address_type = address_type;
+  if (address != nullptr) {
+    memcpy(observation.address, address, sizeof(observation.address));
+  }
+  return push(observation);
+}
+
+bool ScanRing::push(const ScanObservation& observation) {
+  // Counters have a single writer (the producer), so a plain
+  // load/store pair is enough; the atomics keep reads untorn
+  if (observation.payload == nullptr || observation.payload_len > SCAN_RING_DATA_SIZE) {
+    __atomic_store_n(&oversize_count, oversize_count + 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  uint16_t write = head;
+  uint16_t read = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+  if ((uint16_t)(write - read) > slot_mask) {
+    __atomic_store_n(&overflow_count, overflow_count + 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  ScanRingSlot& slot = slots[write & slot_mask];
+  memcpy(slot.data, observation.payload, observation.payload_len);
+  slot.len = (uint8_t)observation.payload_len;
+  slot.timestamp_us = observation.timestamp_us;
+  slot.rssi = observation.rssi;
+  slot.address_type = observation.address_type;
+  memcpy(slot.address, observation.address, sizeof(slot.address));
+  slot.channel = observation.channel;
+  slot.tx_power = observation.tx_power;
+  slot.flags = observation.flags;
+
+  // Publish the slot contents before the new head
+  __atomic_store_n(&head, (uint16_t)(write + 1), __ATOMIC_RELEASE);
+  return true;
+}
+
+uint16_t ScanRing::readable() const {
+  return (uint16_t)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) - tail);
+}
+
+void ScanRing::release(uint16_t count) {
+  uint16_t available = readable();
+  if (count > available) {
+    count = available;
+  }
+
+  // Finish reading the slots before handing them back to the producer
+  __atomic_store_n(&tail, (uint16_t)(tail + count), __ATOMIC_RELEASE);
+}
+
+bool ScanRing::pop(ScanRingSlot& out) {
+  if (readable() == 0) {
+    return false;
+  }
+  out = slot(0);
+  release(1);
+  return true;
+}
@@ -0,0 +1,163 @@
+#ifndef SCAN_RING_H
+#define SCAN_RING_H
+
+#include <stdint.h>
+#include "ScanObservation.h"
+
+// Longest advertisement a slot holds (legacy advertising data)
+#define SCAN_RING_DATA_SIZE 31
+
+/**
+ * @brief One queued scan report
+ */
+struct ScanRingSlot {
+  uint64_t timestamp_us;              // Receive time in microseconds (0 if unknown)
+  uint8_t data[SCAN_RING_DATA_SIZE];  // Raw advertisement data
+  uint8_t len;                        // Length of advertisement data
+  int8_t rssi;                        // Received signal strength
+  uint8_t address_type;               // Advertiser address type
+  uint8_t address[6];                 // Advertiser address, as reported by the stack
+  uint8_t channel;                    // Channel received on (0 if unknown)
+  int8_t tx_power;                    // Advertised TX power (SCAN_OBSERVATION_UNAVAILABLE if none)
+  uint8_t flags;                      // SCAN_OBSERVATION_* event properties
+
+  /**
+   * @brief Observation record for this slot (payload points into the slot)
+   */
+  ScanObservation observation() const {
+    ScanObservation result;
+    result.payload = data;
+    result.payload_len = len;
+    result.timestamp_us = timestamp_us;
+    for (uint8_t i = 0; i < sizeof(address); i++) {
+      result.address[i] = address[i];
+    }
+    result.address_type = address_type;
+    result.rssi = rssi;
+    result.channel = channel;
+    result.tx_power = tx_power;
+    result.flags = flags;
+    return result;
+  }
+};
+
+/**
+ * @brief Wait-free single-producer / single-consumer queue of scan reports
+ *
+ * Lets a radio callback hand reports to the main loop without parsing in
+ * the callback: push() copies the report into the next free slot and
+ * returns, and the consumer drains slots in batches with readable(),
+ * slot() and release().
+ *
+ * The producer only writes the head index and the consumer only writes
+ * the tail index, each published with a release store (__atomic builtins),
+ * so neither side ever waits or locks. Exactly one thread (or interrupt
+ * context) may push and exactly one may consume.
+ *
+ * Reports arriving while the ring is full are counted by overflows() and
+ * dropped; reports longer than a slot are counted by oversized() and
+ * dropped.
+ *
+ * Storage is provided by ScanRingBuffer.
+ */
+class ScanRing {
+ public:
+  /**
+   * @brief Queue a report (producer side)
+   * @param data Raw advertisement data
+   * @param len Length of advertisement data (at most SCAN_RING_DATA_SIZE)
+   * @param rssi Received signal strength
+   * @param address 6-byte advertiser address, or nullptr
+   * @param address_type Advertiser address type
+   * @return true if queued, false if dropped
+   */
+  bool push(const uint8_t* data, uint16_t len, int8_t rssi, const uint8_t* address = nullptr,
+            uint8_t address_type = 0);
+
+  /**
+   * @brief Queue a copy of an observation and its payload (producer side)
+   * @return true if queued, false if dropped
+   */
+  bool push(const ScanObservation& observation);
+
+  /**
+   * @brief Number of queued reports (consumer side)
+   */
+  uint16_t readable() const;
+
+  /**
+   * @brief Queued report i, counting from the oldest (i < readable())
+   */
+  const ScanRingSlot& slot(uint16_t i) const {
+    return slots[(uint16_t)(tail + i) & slot_mask];
+  }
+
+  /**
+   * @brief Return the oldest count slots to the producer (consumer side)
+   */
+  void release(uint16_t count);
+
+  /**
+   * @brief Copy out and release the oldest report (consumer side)
+   * @return true if a report was available
+   */
+  bool pop(ScanRingSlot& out);
+
+  /**
+   * @brief Reports dropped because the ring was full
+   */
+  uint32_t overflows() const {
+    return __atomic_load_n(&overflow_count, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Reports dropped because they were longer than a slot
+   */
+  uint32_t oversized() const {
+    return __atomic_load_n(&oversize_count, __ATOMIC_RELAXED);
+  }
+
+  uint16_t capacity() const {
+    return slot_mask + 1;
+  }
+
+ protected:
+  /**
+   * @param storage Array of capacity slots
+   * @param capacity Number of slots (power of two, at most 32768)
+   */
+  ScanRing(ScanRingSlot* storage, uint16_t capacity);
+
+  // Slots live in the derived storage, so the ring must not be copied
+  ScanRing(const ScanRing&) = delete;
+  ScanRing& operator=(const ScanRing&) = delete;
+
+ private:
+  ScanRingSlot* slots;
+  uint16_t slot_mask;
+  uint16_t head;  // Next slot to write; written by the producer only
+  uint16_t tail;  // Next slot to read; written by the consumer only
+  uint32_t overflow_count;
+  uint32_t oversize_count;
+};
+
+/**
+ * @brief ScanRing with inline storage for N reports
+ *
+ * @code
+ * static ScanRingBuffer<32> ring;
+ * @endcode
+ */
+template <uint16_t N>
+class ScanRingBuffer : public ScanRing {
+  static_assert(N >= 2 && N <= 32768 && (N & (N - 1)) == 0,
+                "Ring size must be a power of two between 2 and 32768");
+
+ public:
+  ScanRingBuffer() : ScanRing(storage, N) {}
+
+ private:
+  ScanRingSlot storage[N];
+};
+
+#endif  // SCAN_RING_H
@@ -1,4 +1,5 @@
 #include "BluefruitAdapter.h"
+#include <string.h>
 
 // Include Bluefruit headers - this is the only file that needs them
 // Users must include bluefruit.h before including this adapter header
@@ -10,9 +11,17 @@
 // For non-nRF52 platforms or when Bluefruit isn't available,
 // define a minimal structure to allow compilation
 // Note: This adapter is primarily intended for nRF52/Bluefruit
+struct ble_gap_addr_t {
+  uint8_t addr_id_peer : 1;
+  uint8_t addr_type : 7;
+  uint8_t addr[6];
+};
+
 struct ble_gap_evt_adv_report_t {
+  ble_gap_addr_t peer_addr;
   uint8_t* data;
   uint8_t dlen;
+  uint8_t scan_rsp : 1;
   int8_t rssi;
   // ... other fields not needed for parsing
 };
@@ -31,3 +40,64 @@ bool BluefruitBeaconParser::parse(ble_gap_evt_adv_report_t* report, BeaconData&
   // Call core parser
   return parser.parse(adv_data, adv_len, result);
 }
+
+bool BluefruitBeaconParser::parse(ble_gap_evt_adv_report_t* report, BeaconData& result,
+                                  ScanObservation& observation) {
+  if (report == nullptr) {
+    observation.clear();
+    result.valid = false;
+    return false;
+  }
+
+  observe(report, observation);
+  return parser.parse(observation, result);
+}
+
+void BluefruitBeaconParser::observe(ble_gap_evt_adv_report_t* report,
+                                    ScanObservation& observation) {
+  observation.clear();
+  observation.payload = report->data;
+  observation.payload_len = report->dlen;
+  observation.rssi = report->rssi;
+  observation.address_type = report->peer_addr.addr_type;
+  memcpy(observation.address, report->peer_addr.addr, sizeof(observation.address));
+  observation.flags = SCAN_OBSERVATION_LEGACY;
+  if (report->scan_rsp) {
+    observation.flags |= SCAN_OBSERVATION_SCAN_RESPONSE;
+  }
+#ifndef NATIVE_BUILD
+  observation.timestamp_us = micros();
+#endif
+}
+
+bool BluefruitBeaconParser::enqueue(ble_gap_evt_adv_report_t* report) {
+  if (report == nullptr || queue == nullptr) {
+    return false;
+  }
+
+  ScanObservation observation;
+  observe(report, observation);
+  return queue->push(observation);
+}
+
+uint16_t BluefruitBeaconParser::drain(BluefruitBeaconHandler handler, uint16_t max_reports) {
+  if (queue == nullptr) {
+    return 0;
+  }
+
+  uint16_t count = queue->readable();
+  if (count > max_reports) {
+    count = max_reports;
+  }
+
+  BeaconData result;
+  for (uint16_t i = 0; i < count; i++) {
+    ScanObservation observation = queue->slot(i).observation();
+    if (parser.parse(observation, result) && handler != nullptr) {
+      handler(result, observation);
+    }
+  }
+
+  queue->release(count);
+  return count;
+}
@@ -3,11 +3,24 @@
 
 #include "../BLEBeaconParser.h"
 #include "../BeaconData.h"
+#include "../ScanObservation.h"
+#include "../ScanRing.h"
+
+// Reports drain() parses per call by default
+#define BLUEFRUIT_DRAIN_BATCH 16
 
 // Forward declaration to avoid requiring Bluefruit headers in adapter header
 // Users must include bluefruit.h before this header
 struct ble_gap_evt_adv_report_t;
 
+/**
+ * @brief Called by BluefruitBeaconParser::drain() for each queued beacon
+ * @param result Parsed beacon
+ * @param observation Queued report (payload, RSSI, address, receive time)
+ */
+typedef void (*BluefruitBeaconHandler)(const BeaconData& result,
+                                       const ScanObservation& observation);
+
 /**
  * @brief Adapter for Bluefruit library integration
  *
@@ -29,12 +42,37 @@ struct ble_gap_evt_adv_report_t;
  *   }
  * }
  * @endcode
+ *
+ * Queued mode keeps parsing out of the SoftDevice scan callback: the
+ * callback only copies the report into a ScanRing and resumes scanning,
+ * and loop() parses queued reports in batches.
+ *
+ * @code
+ * static ScanRingBuffer<32> ring;
+ *
+ * void scan_callback(ble_gap_evt_adv_report_t* report) {
+ *   parser.enqueue(report);
+ *   Bluefruit.Scanner.resume();
+ * }
+ *
+ * void setup() {
+ *   parser.setQueue(&ring);
+ *   // ... start scanning
+ * }
+ *
+ * void loop() {
+ *   parser.drain(on_beacon);
+ * }
+ * @endcode
  */
 class BluefruitBeaconParser {
  private:
   BLEBeaconParser parser;
+  ScanRing* queue;
 
  public:
+  BluefruitBeaconParser() : queue(nullptr) {}
+
   /**
    * @brief Parse beacon from Bluefruit scan report
    *
@@ -46,6 +84,52 @@ class BluefruitBeaconParser {
    * @return true if a beacon format was successfully parsed, false otherwise
    */
   bool parse(ble_gap_evt_adv_report_t* report, BeaconData& result);
+
+  /**
+   * @brief Parse a scan report and keep its metadata
+   *
+   * @param report Bluefruit advertisement report structure
+   * @param result BeaconData structure to fill with parsed data
+   * @param observation Filled with the report's address, RSSI, receive time
+   *        (micros()) and a reference to its payload
+   * @return true if a beacon format was successfully parsed, false otherwise
+   */
+  bool parse(ble_gap_evt_adv_report_t* report, BeaconData& result, ScanObservation& observation);
+
+  /**
+   * @brief Describe a scan report as a ScanObservation (payload borrowed from the report)
+   */
+  static void observe(ble_gap_evt_adv_report_t* report, ScanObservation& observation);
+
+  /**
+   * @brief Set the ring used by enqueue() and drain()
+   * @param ring Ring owned by the caller (e.g. a static ScanRingBuffer)
+   */
+  void setQueue(ScanRing* ring) {
+    queue = ring;
+  }
+
+  /**
+   * @brief Copy a scan report into the queue without parsing it
+   *
+   * Safe to call from the scan callback while drain() runs in loop().
+   *
+   * @param report Bluefruit advertisement report structure
+   * @return true if queued, false if no queue is set or the report was
+   *         dropped (see ScanRing::overflows() / oversized())
+   */
+  bool enqueue(ble_gap_evt_adv_report_t* report);
+
+  /**
+   * @brief Parse queued reports and hand beacons to a handler
+   *
+   * Slots are returned to the ring once per batch rather than per report.
+   *
+   * @param handler Called for each report that parsed as a beacon
+   * @param max_reports Most reports to process in this call
+   * @return Number of reports processed
+   */
+  uint16_t drain(BluefruitBeaconHandler handler, uint16_t max_reports = BLUEFRUIT_DRAIN_BATCH);
 };
 
 #endif  // BLUEFRUIT_ADAPTER_H
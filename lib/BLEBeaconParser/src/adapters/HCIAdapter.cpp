@@ -0,0 +1,252 @@
+#include "HCIAdapter.h"
+#include <string.h>
+
+// Fixed fields of each report type
+#define HCI_LEGACY_REPORT_SIZE 10    // Around the data
+#define HCI_EXTENDED_REPORT_SIZE 24  // Before the data
+
+// ScanObservation flags per legacy report event type (ADV_IND,
+// ADV_DIRECT_IND, ADV_SCAN_IND, ADV_NONCONN_IND, SCAN_RSP), as the
+// controller would report them in an extended report
+static const uint8_t LEGACY_REPORT_FLAGS[5] = {0x13, 0x15, 0x12, 0x10, 0x1A};
+
+bool HCIReportReader::begin(const uint8_t* event, uint16_t len, uint64_t timestamp_us) {
+  left = 0;
+
+  // Event code, parameter length, subevent, report count, reports
+  if (len < 4 || event[0] != HCI_EVENT_LE_META || event[1] < 2 || event[1] + 2 > len) {
+    return false;
+  }
+  if (event[2] != HCI_SUBEVENT_ADVERTISING_REPORT &&
+      event[2] != HCI_SUBEVENT_EXTENDED_ADVERTISING_REPORT) {
+    return false;
+  }
+
+  report = &event[4];
+  report_end = &event[2 + event[1]];
+  timestamp = timestamp_us;
+  subevent = event[2];
+  left = event[3];
+  return true;
+}
+
+bool HCIReportReader::next(ScanObservation& observation) {
+  if (left == 0) {
+    return false;
+  }
+  left--;
+
+  uint16_t available = report_end - report;
+  observation.clear();
+  observation.timestamp_us = timestamp;
+
+  if (subevent == HCI_SUBEVENT_ADVERTISING_REPORT) {
+    // Event type, address type, address, data length, data, RSSI
+    if (available < HCI_LEGACY_REPORT_SIZE || report[8] + HCI_LEGACY_REPORT_SIZE > available) {
+      left = 0;
+      return false;
+    }
+    observation.flags = report[0] < sizeof(LEGACY_REPORT_FLAGS) ? LEGACY_REPORT_FLAGS[report[0]]
+                                                                 : SCAN_OBSERVATION_LEGACY;
+    observation.address_type = report[1];
+    memcpy(observation.address, &report[2], 6);
+    observation.payload = &report[9];
+    observation.payload_len = report[8];
+    observation.rssi = (int8_t)report[9 + report[8]];
+    report += HCI_LEGACY_REPORT_SIZE + report[8];
+    return true;
+  }
+
+  // Event type, address type, address, primary and secondary PHY, SID, TX
+  // power, RSSI, periodic interval, direct address type and address, data
+  // length, data
+  if (available < HCI_EXTENDED_REPORT_SIZE || report[23] + HCI_EXTENDED_REPORT_SIZE > available) {
+    left = 0;
+    return false;
+  }
+  observation.flags = report[0] & 0x7F;  // Event properties and Data_Status
+  observation.address_type = report[2];
+  memcpy(observation.address, &report[3], 6);
+  observation.tx_power = (int8_t)report[12];
+  observation.rssi = (int8_t)report[13];
+  observation.payload = &report[HCI_EXTENDED_REPORT_SIZE];
+  observation.payload_len = report[23];
+  report += HCI_EXTENDED_REPORT_SIZE + report[23];
+  return true;
+}
+
+uint8_t HCIBeaconParser::parse(const uint8_t* event, uint16_t len, HCIBeaconHandler handler,
+                               uint64_t timestamp_us) {
+  HCIReportReader reports;
+  if (!reports.begin(event, len, timestamp_us)) {
+    return 0;
+  }
+
+  uint8_t count = 0;
+  ScanObservation observation;
+  BeaconData result;
+  while (reports.next(observation)) {
+    count++;
+    if (observation.complete() && parser.parse(observation, result) && handler != nullptr) {
+      handler(result, observation);
+    }
+  }
+  return count;
+}
+
+uint16_t HCIBeaconParser::parseBatch(const uint8_t* event, uint16_t len, BeaconBatch& batch,
+                                     ScanObservation* observations) {
+  HCIReportReader reports;
+  if (!reports.begin(event, len)) {
+    batch.count = 0;
+    return 0;
+  }
+
+  // Pointers into the event; nothing is copied
+  AdvPacket packets[HCI_MAX_REPORTS];
+  uint16_t count = 0;
+  ScanObservation observation;
+  while (count < batch.capacity && count < HCI_MAX_REPORTS && reports.next(observation)) {
+    // Fragments get an empty row, which parses as no beacon
+    packets[count].data = observation.payload;
+    packets[count].len = observation.complete() ? observation.payload_len : 0;
+    if (observations != nullptr) {
+      observations[count] = observation;
+    }
+    count++;
+  }
+
+  return parser.parseBatch(packets, count, batch);
+}
+
+// H4StreamDecoder states
+#define H4_STATE_TYPE 0    // Expecting a packet type byte
+#define H4_STATE_HEADER 1  // Collecting the packet header into event[]
+#define H4_STATE_COPY 2    // Copying the body of an LE Meta event split across chunks
+#define H4_STATE_SKIP 3    // Skipping the body of any other packet
+
+// Header bytes per H4 packet type (0 for unknown types)
+static uint8_t h4HeaderSize(uint8_t packet_type) {
+  switch (packet_type) {
+    case HCI_H4_COMMAND:
+    case HCI_H4_SCO:
+      return 3;
+    case HCI_H4_ACL:
+    case HCI_H4_ISO:
+      return 4;
+    case HCI_H4_EVENT:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+H4StreamDecoder::H4StreamDecoder(HCIBeaconParser& hci)
+    : parser(hci), event_count(0), copy_count(0), resync_count(0) {
+  reset();
+}
+
+void H4StreamDecoder::reset() {
+  filled = 0;
+  body_left = 0;
+  header_size = 0;
+  packet_type = 0;
+  state = H4_STATE_TYPE;
+}
+
+uint16_t H4StreamDecoder::feed(const uint8_t* data, size_t len, HCIBeaconHandler handler,
+                               uint64_t timestamp_us) {
+  uint16_t reports = 0;
+  size_t pos = 0;
+
+  while (pos < len) {
+    switch (state) {
+      case H4_STATE_TYPE:
+        packet_type = data[pos++];
+        header_size = h4HeaderSize(packet_type);
+        if (header_size == 0) {
+          resync_count++;
+          break;
+        }
+        filled = 0;
+        state = H4_STATE_HEADER;
+        break;
+
+      case H4_STATE_HEADER: {
+        // An event that starts and ends in this chunk is parsed where it lies
+        size_t rest = len - pos;
+        if (filled == 0 && packet_type == HCI_H4_EVENT && rest >= 2 &&
+            rest >= 2 + (size_t)data[pos + 1]) {
+          uint16_t size = 2 + data[pos + 1];
+          if (data[pos] == HCI_EVENT_LE_META) {
+            reports += deliver(&data[pos], size, handler, timestamp_us);
+          }
+          pos += size;
+          state = H4_STATE_TYPE;
+          break;
+        }
+
+        event[filled++] = data[pos++];
+        if (filled < header_size) {
+          break;
+        }
+
+        body_left = bodyLength();
+        bool keep = packet_type == HCI_H4_EVENT && event[0] == HCI_EVENT_LE_META;
+        state = keep ? H4_STATE_COPY : H4_STATE_SKIP;
+        if (body_left == 0) {
+          if (keep) {
+            reports += deliver(event, filled, handler, timestamp_us);
+          }
+          state = H4_STATE_TYPE;
+        }
+        break;
+      }
+
+      case H4_STATE_COPY: {
+        size_t count = len - pos < body_left ? len - pos : body_left;
+        memcpy(&event[filled], &data[pos], count);
+        filled += count;
+        pos += count;
+        body_left -= count;
+        if (body_left == 0) {
+          copy_count++;
+          reports += deliver(event, filled, handler, timestamp_us);
+          state = H4_STATE_TYPE;
+        }
+        break;
+      }
+
+      default: {
+        size_t count = len - pos < body_left ? len - pos : body_left;
+        pos += count;
+        body_left -= count;
+        if (body_left == 0) {
+          state = H4_STATE_TYPE;
+        }
+        break;
+      }
+    }
+  }
+
+  return reports;
+}
+
+uint16_t H4StreamDecoder::bodyLength() const {
+  switch (packet_type) {
+    case HCI_H4_EVENT:
+      return event[1];
+    case HCI_H4_ACL:
+      return event[2] | (event[3] << 8);
+    case HCI_H4_ISO:
+      return (event[2] | (event[3] << 8)) & 0x3FFF;
+    default:
+      return event[2];
+  }
+}
+
+uint16_t H4StreamDecoder::deliver(const uint8_t* packet, uint16_t len, HCIBeaconHandler handler,
+                                  uint64_t timestamp_us) {
+  event_count++;
+  return parser.parse(packet, len, handler, timestamp_us);
+}
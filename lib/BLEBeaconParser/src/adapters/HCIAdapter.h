@@ -0,0 +1,233 @@
+#ifndef HCI_ADAPTER_H
+#define HCI_ADAPTER_H
+
+#include <stddef.h>
+#include "../BLEBeaconParser.h"
+#include "../BeaconBatch.h"
+#include "../BeaconData.h"
+#include "../ScanObservation.h"
+
+// H4 packet types
+#define HCI_H4_COMMAND 0x01
+#define HCI_H4_ACL 0x02
+#define HCI_H4_SCO 0x03
+#define HCI_H4_EVENT 0x04
+#define HCI_H4_ISO 0x05
+
+// Event code, parameter length and up to 255 parameter bytes
+#define HCI_MAX_EVENT_SIZE 257
+
+// HCI event codes
+#define HCI_EVENT_LE_META 0x3E
+#define HCI_SUBEVENT_ADVERTISING_REPORT 0x02
+#define HCI_SUBEVENT_EXTENDED_ADVERTISING_REPORT 0x0D
+
+// Most reports one event can hold (255 parameter bytes of 10-byte legacy reports)
+#define HCI_MAX_REPORTS 25
+
+/**
+ * @brief Cursor over the reports in one HCI LE Advertising Report event
+ *
+ * Walks an LE Meta event buffer (event code first, no H4 packet type) in
+ * place. Both the legacy LE Advertising Report (subevent 0x02) and the LE
+ * Extended Advertising Report (0x0D) are supported; each report becomes a
+ * ScanObservation whose payload points into the event buffer.
+ *
+ * Legacy reports are read one after another (event type, address type,
+ * address, data length, data, RSSI), the layout controllers send and host
+ * stacks expect. Extended report event types, Data_Status included, map
+ * straight onto the SCAN_OBSERVATION_* flags; legacy event types are
+ * translated to the same bits. A report running past the end of the event
+ * ends the walk.
+ */
+class HCIReportReader {
+ public:
+  HCIReportReader() : report(nullptr), report_end(nullptr), timestamp(0), left(0), subevent(0) {}
+
+  /**
+   * @brief Start walking an event
+   * @param event HCI event buffer, starting with the event code
+   * @param len Length of the buffer
+   * @param timestamp_us Receive time stamped on every report
+   * @return true if the event is an LE Advertising Report or LE Extended
+   *         Advertising Report event
+   */
+  bool begin(const uint8_t* event, uint16_t len, uint64_t timestamp_us = 0);
+
+  /**
+   * @brief Read the next report
+   * @return false when the event has no more (well-formed) reports
+   */
+  bool next(ScanObservation& observation);
+
+  /**
+   * @brief Reports the event claims that next() has not returned yet
+   */
+  uint8_t remaining() const {
+    return left;
+  }
+
+ private:
+  const uint8_t* report;
+  const uint8_t* report_end;
+  uint64_t timestamp;
+  uint8_t left;
+  uint8_t subevent;
+};
+
+/**
+ * @brief Called by HCIBeaconParser::parse() for each report that parsed as a beacon
+ */
+typedef void (*HCIBeaconHandler)(const BeaconData& result, const ScanObservation& observation);
+
+/**
+ * @brief Adapter for raw HCI LE Advertising Report events
+ *
+ * Feeds every report of an event to the parser without splitting or
+ * copying the event first, e.g. on a Linux gateway reading an HCI
+ * socket or USB dongle:
+ *
+ * @code
+ * HCIBeaconParser parser;
+ *
+ * void on_beacon(const BeaconData& result, const ScanObservation& observation) {
+ *   // Handle parsed beacon
+ * }
+ *
+ * ssize_t len = read(hci_socket, buffer, sizeof(buffer));
+ * parser.parse(&buffer[1], len - 1, on_beacon);  // Skip the H4 packet type
+ * @endcode
+ *
+ * parseBatch() decodes all reports of an event in one BLEBeaconParser::parseBatch() call.
+ *
+ * Extended reports whose Data_Status marks them incomplete or truncated
+ * hold only part of the advertising data and are not parsed. Callers that
+ * reassemble chains can read the fragments with HCIReportReader, copy
+ * them, and pass them to BLEBeaconParser::parseChain().
+ */
+class HCIBeaconParser {
+ private:
+  BLEBeaconParser parser;
+
+ public:
+  /**
+   * @brief Parse every report in an event
+   * @param event HCI event buffer, starting with the event code
+   * @param len Length of the buffer
+   * @param handler Called for each complete report that parsed as a beacon
+   * @param timestamp_us Receive time stamped on the observations
+   * @return Number of reports in the event, fragments included (0 if it is not
+   *         an advertising report event)
+   */
+  uint8_t parse(const uint8_t* event, uint16_t len, HCIBeaconHandler handler,
+                uint64_t timestamp_us = 0);
+
+  /**
+   * @brief Decode every report in an event into structure-of-arrays columns
+   * @param event HCI event buffer, starting with the event code
+   * @param len Length of the buffer
+   * @param batch Caller-owned output columns, one row per report (fragments are
+   *        left invalid)
+   * @param observations Optional array of batch.capacity entries, filled with
+   *        each row's address, RSSI and payload
+   * @return Number of reports that parsed as beacons
+   */
+  uint16_t parseBatch(const uint8_t* event, uint16_t len, BeaconBatch& batch,
+                      ScanObservation* observations = nullptr);
+
+  /**
+   * @brief The wrapped parser (to register custom formats or set a cache)
+   */
+  BLEBeaconParser& core() {
+    return parser;
+  }
+};
+
+/**
+ * @brief Push decoder for an H4 (UART) HCI byte stream
+ *
+ * Accepts whatever read() returns, split anywhere, and hands each LE
+ * Advertising Report event to an HCIBeaconParser as soon as its last byte
+ * arrives. A small state machine carries the packet type, header and
+ * remaining length across calls:
+ * - events that lie wholly inside one chunk are parsed in place
+ * - only LE Meta events that straddle a chunk boundary are copied, into a
+ *   257-byte event buffer
+ * - ACL, SCO, ISO, command and other event packets are skipped by length
+ *   without being copied
+ *
+ * An unknown packet type byte means the stream is out of step; it is
+ * skipped and counted by resyncs() until a known type byte comes along.
+ *
+ * One decoder per stream; decoders may share a parser.
+ *
+ * @code
+ * HCIBeaconParser parser;
+ * H4StreamDecoder dongle(parser);
+ *
+ * uint8_t chunk[512];
+ * ssize_t got;
+ * while ((got = read(uart_fd, chunk, sizeof(chunk))) > 0) {
+ *   dongle.feed(chunk, got, on_beacon);
+ * }
+ * @endcode
+ */
+class H4StreamDecoder {
+ public:
+  explicit H4StreamDecoder(HCIBeaconParser& parser);
+
+  /**
+   * @brief Decode the next chunk of the stream
+   * @param data Bytes read from the stream
+   * @param len Number of bytes
+   * @param handler Called for each report that parsed as a beacon
+   * @param timestamp_us Receive time stamped on reports completed by this chunk
+   * @return Number of advertising reports completed by this chunk
+   */
+  uint16_t feed(const uint8_t* data, size_t len, HCIBeaconHandler handler,
+                uint64_t timestamp_us = 0);
+
+  /**
+   * @brief Forget any partial packet (e.g. after reopening the port)
+   */
+  void reset();
+
+  /**
+   * @brief LE Meta events handed to the parser
+   */
+  uint32_t events() const {
+    return event_count;
+  }
+
+  /**
+   * @brief Events that straddled a chunk boundary and had to be copied
+   */
+  uint32_t copies() const {
+    return copy_count;
+  }
+
+  /**
+   * @brief Unknown packet type bytes skipped
+   */
+  uint32_t resyncs() const {
+    return resync_count;
+  }
+
+ private:
+  uint16_t deliver(const uint8_t* packet, uint16_t len, HCIBeaconHandler handler,
+                   uint64_t timestamp_us);
+  uint16_t bodyLength() const;
+
+  HCIBeaconParser& parser;
+  uint8_t event[HCI_MAX_EVENT_SIZE];  // Header of any packet, body of split LE Meta events
+  uint16_t filled;                    // Bytes of event[] in use
+  uint16_t body_left;                 // Body bytes of the current packet still to come
+  uint8_t header_size;                // Header bytes of the current packet type
+  uint8_t packet_type;                // H4 packet type of the current packet
+  uint8_t state;
+  uint32_t event_count;
+  uint32_t copy_count;
+  uint32_t resync_count;
+};
+
+#endif  // HCI_ADAPTER_H
@@ -1,117 +1,89 @@
 #include "AltBeaconParser.h"
-
-// Radius Networks Company ID (little-endian in advertisement data)
-#define RADIUS_COMPANY_ID_LOW 0x18
-#define RADIUS_COMPANY_ID_HIGH 0x01
+#include <string.h>
 
 // AltBeacon beacon code
 #define ALTBEACON_CODE_1 0xBE
 #define ALTBEACON_CODE_2 0xAC
 
-// Expected AltBeacon data length: beacon code (2) + ID (16) + RSSI (1) +
-// Manufacturer Reserved (1) + Major (2) + Minor (2) = 24 bytes
-#define ALTBEACON_DATA_LENGTH 24
+// AltBeacon layout (offsets include the 2-byte Company ID): beacon code BE AC,
+// ID (16), Reference RSSI (1), Manufacturer Reserved (1), Major (2), Minor (2)
+#define ALTBEACON_LAYOUT "m:2-3=beac,i:4-19,p:20-20,d:21-21,i:22-23,i:24-25"
 
-// AD Structure types
-#define AD_TYPE_MANUFACTURER_SPECIFIC_DATA 0xFF
+const BeaconLayout& AltBeaconParser::layout() {
+  static const BeaconLayout plan(ALTBEACON_LAYOUT, AD_ID);
+  return plan;
+}
 
-bool AltBeaconParser::canParse(const uint8_t* data, uint8_t len) {
-  const uint8_t* mfg_data;
-  uint8_t mfg_len;
+bool AltBeaconParser::canParse(const uint8_t* data, uint16_t len) {
+  ADFields fields;
+  ADTokenizer::tokenize(data, len, fields, AD_TYPE, AD_ID);
+  return canParse(fields);
+}
 
-  if (!findRadiusManufacturerData(data, len, mfg_data, mfg_len)) {
-    return false;
-  }
+bool AltBeaconParser::parse(const uint8_t* data, uint16_t len, BeaconData& result) {
+  ADFields fields;
+  ADTokenizer::tokenize(data, len, fields, AD_TYPE, AD_ID);
+  return parse(fields, result);
+}
+
+bool AltBeaconParser::canParse(const ADFields& fields) {
+  const ADField* mfg = fields.find(AD_TYPE, AD_ID);
 
   // Check if we have enough data for AltBeacon code
-  if (mfg_len < 2) {
+  if (mfg == nullptr || mfg->len < 2) {
     return false;
   }
 
   // Check for AltBeacon code (0xBE 0xAC)
-  return (mfg_data[0] == ALTBEACON_CODE_1 && mfg_data[1] == ALTBEACON_CODE_2);
+  return (mfg->data[0] == ALTBEACON_CODE_1 && mfg->data[1] == ALTBEACON_CODE_2);
 }
 
-bool AltBeaconParser::parse(const uint8_t* data, uint8_t len, BeaconData& result) {
-  const uint8_t* mfg_data;
-  uint8_t mfg_len;
+bool AltBeaconParser::parse(const ADFields& fields, BeaconData& result) {
+  const ADField* mfg = fields.find(AD_TYPE, AD_ID);
 
-  if (!findRadiusManufacturerData(data, len, mfg_data, mfg_len)) {
+  if (mfg == nullptr) {
     result.valid = false;
     return false;
   }
 
-  // Verify AltBeacon code and length
-  if (mfg_len < ALTBEACON_DATA_LENGTH || mfg_data[0] != ALTBEACON_CODE_1 ||
-      mfg_data[1] != ALTBEACON_CODE_2) {
+  return decode(*mfg, result);
+}
+
+bool AltBeaconParser::decode(const ADField& field, BeaconData& result) {
+  // Verify AltBeacon code and length, then extract the layout fields
+  BeaconLayoutValues values;
+  if (!layout().extract(field, values)) {
     result.valid = false;
     return false;
   }
 
-  // Extract Beacon ID (16 bytes starting at offset 2)
-  for (int i = 0; i < 16; i++) {
-    result.altbeacon.id[i] = mfg_data[2 + i];
-  }
-
-  // Extract Reference RSSI (1 byte, signed, at offset 18)
-  // Note: This is stored as tx_power in our structure
-  result.altbeacon.tx_power = (int8_t)mfg_data[18];
-
-  // Extract Manufacturer Reserved (1 byte, at offset 19)
-  result.altbeacon.mfg_reserved = mfg_data[19];
-
-  // Extract Major (2 bytes, big-endian, at offset 20)
-  result.altbeacon.major = (mfg_data[20] << 8) | mfg_data[21];
+  memcpy(result.altbeacon.id, values.identifiers[0].bytes, 16);
 
-  // Extract Minor (2 bytes, big-endian, at offset 22)
-  result.altbeacon.minor = (mfg_data[22] << 8) | mfg_data[23];
+  // Reference RSSI is stored as tx_power in our structure
+  result.altbeacon.tx_power = values.power;
+  result.altbeacon.mfg_reserved = values.data[0].value;
+  result.altbeacon.major = values.identifiers[1].value;
+  result.altbeacon.minor = values.identifiers[2].value;
 
   result.type = BEACON_TYPE_ALTBEACON;
   result.valid = true;
   return true;
 }
 
-bool AltBeaconParser::findRadiusManufacturerData(const uint8_t* data, uint8_t len,
-                                                 const uint8_t*& out_data, uint8_t& out_len) {
-  uint8_t pos = 0;
-
-  // Parse AD structures: [Length][Type][Data...]
-  while (pos < len) {
-    uint8_t ad_len = data[pos];
-
-    // Check for valid length (0 means end of data)
-    if (ad_len == 0) {
-      break;
-    }
-
-    // Check if we have enough data
-    if (pos + ad_len >= len) {
-      break;
-    }
-
-    uint8_t ad_type = data[pos + 1];
-
-    // Check for Manufacturer Specific Data
-    if (ad_type == AD_TYPE_MANUFACTURER_SPECIFIC_DATA) {
-      // Manufacturer data starts at pos + 2
-      // First 2 bytes are Company ID (little-endian)
-      if (ad_len >= 2) {
-        uint8_t company_id_low = data[pos + 2];
-        uint8_t company_id_high = data[pos + 3];
-
-        // Check for Radius Networks Company ID (0x0118)
-        if (company_id_low == RADIUS_COMPANY_ID_LOW && company_id_high == RADIUS_COMPANY_ID_HIGH) {
-          // Manufacturer data starts after Company ID (offset 4)
-          out_data = &data[pos + 4];
-          out_len = ad_len - 2;  // Subtract Company ID length
-          return true;
-        }
-      }
-    }
-
-    // Move to next AD structure
-    pos += ad_len + 1;
+bool AltBeaconParser::decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row) {
+  BeaconLayoutValues values;
+  if (!layout().extract(field, values)) {
+    return false;
   }
 
-  return false;
+  memcpy(batch.id[row], values.identifiers[0].bytes, 16);
+  batch.tx_power[row] = values.power;
+  batch.major[row] = values.identifiers[1].value;
+  batch.minor[row] = values.identifiers[2].value;
+  batch.type[row] = BEACON_TYPE_ALTBEACON;
+  return true;
+}
+
+BeaconType AltBeaconParser::classify(const ADField& field) {
+  return layout().matches(field) ? BEACON_TYPE_ALTBEACON : BEACON_TYPE_UNKNOWN;
 }
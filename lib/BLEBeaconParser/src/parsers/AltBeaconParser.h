@@ -2,7 +2,10 @@
 #define ALTBEACON_PARSER_H
 
 #include <stdint.h>
+#include "../ADStructures.h"
+#include "../BeaconBatch.h"
 #include "../BeaconData.h"
+#include "../BeaconLayout.h"
 
 /**
  * @brief Parser for AltBeacon format (Radius Networks)
@@ -17,16 +20,22 @@
  *   - Manufacturer Reserved: 1 byte
  *   - Major: 2 bytes (big-endian)
  *   - Minor: 2 bytes (big-endian)
+ *
+ * Decoded by a compiled BeaconLayout (see layout()).
  */
 class AltBeaconParser {
  public:
+  // Dispatch key: Manufacturer Specific Data with Radius Networks Company ID
+  static const uint8_t AD_TYPE = AD_TYPE_MANUFACTURER_SPECIFIC_DATA;
+  static const uint16_t AD_ID = 0x0118;
+
   /**
    * @brief Check if the advertisement data matches AltBeacon format
    * @param data Raw advertisement data
    * @param len Length of advertisement data
    * @return true if data matches AltBeacon format
    */
-  static bool canParse(const uint8_t* data, uint8_t len);
+  static bool canParse(const uint8_t* data, uint16_t len);
 
   /**
    * @brief Parse AltBeacon data from advertisement packet
@@ -35,19 +44,51 @@ class AltBeaconParser {
    * @param result BeaconData structure to fill with parsed data
    * @return true if parsing was successful
    */
-  static bool parse(const uint8_t* data, uint8_t len, BeaconData& result);
+  static bool parse(const uint8_t* data, uint16_t len, BeaconData& result);
 
- private:
   /**
-   * @brief Find manufacturer-specific data with Radius Networks Company ID
-   * @param data Raw advertisement data
-   * @param len Length of advertisement data
-   * @param out_data Output pointer to manufacturer data
-   * @param out_len Output length of manufacturer data
-   * @return true if found
+   * @brief Check if pre-tokenized AD fields match AltBeacon format
+   * @param fields AD fields located by ADTokenizer
+   * @return true if fields contain AltBeacon data
+   */
+  static bool canParse(const ADFields& fields);
+
+  /**
+   * @brief Parse AltBeacon data from pre-tokenized AD fields
+   * @param fields AD fields located by ADTokenizer
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if parsing was successful
+   */
+  static bool parse(const ADFields& fields, BeaconData& result);
+
+  /**
+   * @brief Decode AltBeacon data from a field matching AD_TYPE and AD_ID
+   * @param field Manufacturer data field (payload after Company ID)
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if parsing was successful
+   */
+  static bool decode(const ADField& field, BeaconData& result);
+
+  /**
+   * @brief Decode AltBeacon identity columns for batch parsing
+   * @param field Field matching AD_TYPE and AD_ID
+   * @param batch Batch whose columns receive the decoded fields
+   * @param row Row to write
+   * @return true if parsing was successful
+   */
+  static bool decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row);
+
+  /**
+   * @brief Check a field matching AD_TYPE and AD_ID without decoding it
+   * @param field Field matching AD_TYPE and AD_ID
+   * @return BEACON_TYPE_ALTBEACON, or BEACON_TYPE_UNKNOWN if decode() would fail
+   */
+  static BeaconType classify(const ADField& field);
+
+  /**
+   * @brief Compiled layout used by decode(), decodeColumns() and classify()
    */
-  static bool findRadiusManufacturerData(const uint8_t* data, uint8_t len, const uint8_t*& out_data,
-                                         uint8_t& out_len);
+  static const BeaconLayout& layout();
 };
 
 #endif  // ALTBEACON_PARSER_H
@@ -1,17 +1,11 @@
 #include "EddystoneParser.h"
-
-// Eddystone Service UUID (little-endian in advertisement data)
-#define EDDYSTONE_SERVICE_UUID_LOW 0xAA
-#define EDDYSTONE_SERVICE_UUID_HIGH 0xFE
+#include <string.h>
 
 // Eddystone frame types
 #define EDDYSTONE_FRAME_TYPE_UID 0x00
 #define EDDYSTONE_FRAME_TYPE_URL 0x10
 #define EDDYSTONE_FRAME_TYPE_TLM 0x20
 
-// AD Structure types
-#define AD_TYPE_SERVICE_DATA 0x16
-
 // Eddystone-UID frame structure (after frame type byte)
 // TX Power (1 byte) + Namespace ID (10 bytes) + Instance ID (6 bytes) = 17 bytes
 #define EDDYSTONE_UID_DATA_LENGTH 17
@@ -25,33 +19,49 @@
 // Adv Count (4 bytes) + Sec Since Boot (4 bytes) = 13 bytes
 #define EDDYSTONE_TLM_DATA_LENGTH 13
 
-bool EddystoneParser::canParse(const uint8_t* data, uint8_t len) {
-  const uint8_t* service_data;
-  uint8_t service_len;
+bool EddystoneParser::canParse(const uint8_t* data, uint16_t len) {
+  ADFields fields;
+  ADTokenizer::tokenize(data, len, fields, AD_TYPE, AD_ID);
+  return canParse(fields);
+}
+
+bool EddystoneParser::parse(const uint8_t* data, uint16_t len, BeaconData& result) {
+  ADFields fields;
+  ADTokenizer::tokenize(data, len, fields, AD_TYPE, AD_ID);
+  return parse(fields, result);
+}
 
-  return findEddystoneServiceData(data, len, service_data, service_len);
+bool EddystoneParser::canParse(const ADFields& fields) {
+  return fields.find(AD_TYPE, AD_ID) != nullptr;
 }
 
-bool EddystoneParser::parse(const uint8_t* data, uint8_t len, BeaconData& result) {
-  const uint8_t* service_data;
-  uint8_t service_len;
+bool EddystoneParser::parse(const ADFields& fields, BeaconData& result) {
+  const ADField* service = fields.find(AD_TYPE, AD_ID);
 
-  if (!findEddystoneServiceData(data, len, service_data, service_len)) {
+  if (service == nullptr) {
     result.valid = false;
     return false;
   }
 
-  // Service data format: [UUID low][UUID high][Frame Type][Frame Data...]
-  // We need at least 3 bytes (UUID + Frame Type)
-  if (service_len < 3) {
+  return decode(*service, result);
+}
+
+bool EddystoneParser::decode(const ADField& field, BeaconData& result) {
+  return decode(field, result, nullptr);
+}
+
+bool EddystoneParser::decode(const ADField& field, BeaconData& result,
+                             EddystoneURLCache* url_cache) {
+  // Service data format (after UUID): [Frame Type][Frame Data...]
+  // We need at least the Frame Type byte
+  if (field.len < 1) {
     result.valid = false;
     return false;
   }
 
-  // Frame type is at offset 2 (after UUID)
-  uint8_t frame_type = service_data[2];
-  const uint8_t* frame_data = &service_data[3];
-  uint8_t frame_len = service_len - 3;
+  uint8_t frame_type = field.data[0];
+  const uint8_t* frame_data = &field.data[1];
+  uint8_t frame_len = field.len - 1;
 
   // Route to appropriate parser based on frame type
   switch (frame_type) {
@@ -59,7 +69,7 @@ bool EddystoneParser::parse(const uint8_t* data, uint8_t len, BeaconData& result
       return parseUID(frame_data, frame_len, result);
 
     case EDDYSTONE_FRAME_TYPE_URL:
-      return parseURL(frame_data, frame_len, result);
+      return parseURL(frame_data, frame_len, result, url_cache);
 
     case EDDYSTONE_FRAME_TYPE_TLM:
       return parseTLM(frame_data, frame_len, result);
@@ -70,51 +80,73 @@ bool EddystoneParser::parse(const uint8_t* data, uint8_t len, BeaconData& result
   }
 }
 
-bool EddystoneParser::findEddystoneServiceData(const uint8_t* data, uint8_t len,
-                                               const uint8_t*& out_data, uint8_t& out_len) {
-  uint8_t pos = 0;
+bool EddystoneParser::decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row) {
+  // Same acceptance as decode(); frame data starts after the frame type byte
+  BeaconType type = classify(field);
+  const uint8_t* frame_data = &field.data[1];
+
+  switch (type) {
+    case BEACON_TYPE_EDDYSTONE_UID:
+      // Namespace ID (offset 1) and Instance ID (offset 11) are contiguous
+      memcpy(batch.id[row], &frame_data[1], 16);
+      batch.tx_power[row] = (int8_t)frame_data[0];
+      break;
+
+    case BEACON_TYPE_EDDYSTONE_URL:
+      memset(batch.id[row], 0, 16);
+      batch.tx_power[row] = (int8_t)frame_data[0];
+      break;
+
+    case BEACON_TYPE_EDDYSTONE_TLM:
+      memset(batch.id[row], 0, 16);
+      batch.tx_power[row] = 0;
+      break;
+
+    default:
+      return false;
+  }
+
+  batch.type[row] = type;
+  batch.major[row] = 0;
+  batch.minor[row] = 0;
+  return true;
+}
+
+BeaconType EddystoneParser::classify(const ADField& field) {
+  if (field.len < 1) {
+    return BEACON_TYPE_UNKNOWN;
+  }
 
-  // Parse AD structures: [Length][Type][Data...]
-  while (pos < len) {
-    uint8_t ad_len = data[pos];
+  const uint8_t* frame_data = &field.data[1];
+  uint8_t frame_len = field.len - 1;
 
-    // Check for valid length (0 means end of data)
-    if (ad_len == 0) {
+  switch (field.data[0]) {
+    case EDDYSTONE_FRAME_TYPE_UID:
+      if (frame_len >= EDDYSTONE_UID_DATA_LENGTH) {
+        return BEACON_TYPE_EDDYSTONE_UID;
+      }
       break;
-    }
 
-    // Check if we have enough data
-    // ad_len includes Type byte, so we need pos + 1 (Length) + ad_len bytes total
-    if (pos + 1 + ad_len > len) {
+    case EDDYSTONE_FRAME_TYPE_URL:
+      // TX Power, a known URL scheme and a spec-compliant encoded length
+      if (frame_len >= EDDYSTONE_URL_MIN_DATA_LENGTH &&
+          frame_len <= 2 + EDDYSTONE_URL_MAX_ENCODED_LENGTH && frame_data[1] <= 0x03) {
+        return BEACON_TYPE_EDDYSTONE_URL;
+      }
       break;
-    }
-
-    uint8_t ad_type = data[pos + 1];
-
-    // Check for Service Data
-    if (ad_type == AD_TYPE_SERVICE_DATA) {
-      // Service data starts at pos + 2
-      // First 2 bytes are Service UUID (little-endian)
-      if (ad_len >= 2) {
-        uint8_t uuid_low = data[pos + 2];
-        uint8_t uuid_high = data[pos + 3];
-
-        // Check for Eddystone Service UUID (0xFEAA)
-        if (uuid_low == EDDYSTONE_SERVICE_UUID_LOW && uuid_high == EDDYSTONE_SERVICE_UUID_HIGH) {
-          // Service data starts at pos + 2 (includes UUID)
-          // ad_len includes Type byte, so Data length is ad_len - 1
-          out_data = &data[pos + 2];
-          out_len = ad_len - 1;  // Data length (excludes Type byte)
-          return true;
-        }
+
+    case EDDYSTONE_FRAME_TYPE_TLM:
+      // Unencrypted TLM (version 0x00) only
+      if (frame_len >= EDDYSTONE_TLM_DATA_LENGTH && frame_data[0] == 0x00) {
+        return BEACON_TYPE_EDDYSTONE_TLM;
       }
-    }
+      break;
 
-    // Move to next AD structure
-    pos += ad_len + 1;
+    default:
+      break;
   }
 
-  return false;
+  return BEACON_TYPE_UNKNOWN;
 }
 
 bool EddystoneParser::parseUID(const uint8_t* frame_data, uint8_t frame_len, BeaconData& result) {
@@ -141,35 +173,28 @@ bool EddystoneParser::parseUID(const uint8_t* frame_data, uint8_t frame_len, Bea
   return true;
 }
 
-bool EddystoneParser::parseURL(const uint8_t* frame_data, uint8_t frame_len, BeaconData& result) {
+bool EddystoneParser::parseURL(const uint8_t* frame_data, uint8_t frame_len, BeaconData& result,
+                               EddystoneURLCache* url_cache) {
   if (frame_len < EDDYSTONE_URL_MIN_DATA_LENGTH) {
     result.valid = false;
     return false;
   }
 
-  // TX Power is at offset 0 (signed byte)
-  result.eddystone_url.tx_power = (int8_t)frame_data[0];
-
-  // URL starts at offset 1
-  String url = decodeURLScheme(frame_data[1]);
+  // URL (scheme byte + encoded bytes) starts at offset 1; the decoder
+  // rejects unknown schemes and over-long encodings
+  const uint8_t* encoded = &frame_data[1];
+  uint8_t encoded_len = frame_len - 1;
+  uint8_t url_len = (url_cache != nullptr)
+                      ? url_cache->expand(encoded, encoded_len, result.eddystone_url.url)
+                      : EddystoneURLDecoder::expand(encoded, encoded_len, result.eddystone_url.url);
 
-  if (url.length() == 0) {
+  if (url_len == 0) {
     result.valid = false;
     return false;
   }
 
-  // Decode remaining URL bytes
-  for (uint8_t i = 2; i < frame_len; i++) {
-    String suffix = decodeURLSuffix(frame_data[i]);
-    if (suffix.length() > 0) {
-      url += suffix;
-    } else {
-      // If not a special encoding, treat as ASCII character
-      url += (char)frame_data[i];
-    }
-  }
-
-  result.eddystone_url.url = url;
+  // TX Power is at offset 0 (signed byte)
+  result.eddystone_url.tx_power = (int8_t)frame_data[0];
   result.type = BEACON_TYPE_EDDYSTONE_URL;
   result.valid = true;
   return true;
@@ -210,55 +235,3 @@ bool EddystoneParser::parseTLM(const uint8_t* frame_data, uint8_t frame_len, Bea
   result.valid = true;
   return true;
 }
-
-String EddystoneParser::decodeURLScheme(uint8_t encoded_url) {
-  // Eddystone URL scheme encoding
-  switch (encoded_url) {
-    case 0x00:
-      return "http://www.";
-    case 0x01:
-      return "https://www.";
-    case 0x02:
-      return "http://";
-    case 0x03:
-      return "https://";
-    default:
-      return "";
-  }
-}
-
-String EddystoneParser::decodeURLSuffix(uint8_t encoded_suffix) {
-  // Eddystone URL suffix encoding
-  switch (encoded_suffix) {
-    case 0x00:
-      return ".com/";
-    case 0x01:
-      return ".org/";
-    case 0x02:
-      return ".edu/";
-    case 0x03:
-      return ".net/";
-    case 0x04:
-      return ".info/";
-    case 0x05:
-      return ".biz/";
-    case 0x06:
-      return ".gov/";
-    case 0x07:
-      return ".com";
-    case 0x08:
-      return ".org";
-    case 0x09:
-      return ".edu";
-    case 0x0A:
-      return ".net";
-    case 0x0B:
-      return ".info";
-    case 0x0C:
-      return ".biz";
-    case 0x0D:
-      return ".gov";
-    default:
-      return "";  // Not a special encoding
-  }
-}
@@ -2,7 +2,10 @@
 #define EDDYSTONE_PARSER_H
 
 #include <stdint.h>
+#include "../ADStructures.h"
+#include "../BeaconBatch.h"
 #include "../BeaconData.h"
+#include "EddystoneURL.h"
 
 /**
  * @brief Parser for Eddystone format (Google)
@@ -16,13 +19,17 @@
  */
 class EddystoneParser {
  public:
+  // Dispatch key: Service Data with Eddystone Service UUID
+  static const uint8_t AD_TYPE = AD_TYPE_SERVICE_DATA;
+  static const uint16_t AD_ID = 0xFEAA;
+
   /**
    * @brief Check if the advertisement data matches Eddystone format
    * @param data Raw advertisement data
    * @param len Length of advertisement data
    * @return true if data matches Eddystone format
    */
-  static bool canParse(const uint8_t* data, uint8_t len);
+  static bool canParse(const uint8_t* data, uint16_t len);
 
   /**
    * @brief Parse Eddystone data from advertisement packet
@@ -31,20 +38,57 @@ class EddystoneParser {
    * @param result BeaconData structure to fill with parsed data
    * @return true if parsing was successful
    */
-  static bool parse(const uint8_t* data, uint8_t len, BeaconData& result);
+  static bool parse(const uint8_t* data, uint16_t len, BeaconData& result);
 
- private:
   /**
-   * @brief Find service data with Eddystone Service UUID
-   * @param data Raw advertisement data
-   * @param len Length of advertisement data
-   * @param out_data Output pointer to service data
-   * @param out_len Output length of service data
-   * @return true if found
+   * @brief Check if pre-tokenized AD fields match Eddystone format
+   * @param fields AD fields located by ADTokenizer
+   * @return true if fields contain Eddystone service data
+   */
+  static bool canParse(const ADFields& fields);
+
+  /**
+   * @brief Parse Eddystone data from pre-tokenized AD fields
+   * @param fields AD fields located by ADTokenizer
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if parsing was successful
    */
-  static bool findEddystoneServiceData(const uint8_t* data, uint8_t len, const uint8_t*& out_data,
-                                       uint8_t& out_len);
+  static bool parse(const ADFields& fields, BeaconData& result);
 
+  /**
+   * @brief Decode an Eddystone frame from a field matching AD_TYPE and AD_ID
+   * @param field Service data field (payload after Service UUID)
+   * @param result BeaconData structure to fill with parsed data
+   * @return true if parsing was successful
+   */
+  static bool decode(const ADField& field, BeaconData& result);
+
+  /**
+   * @brief Decode an Eddystone frame, expanding URL frames through a cache
+   * @param field Service data field (payload after Service UUID)
+   * @param result BeaconData structure to fill with parsed data
+   * @param url_cache Cache for URL frames, or nullptr to expand every time
+   * @return true if parsing was successful
+   */
+  static bool decode(const ADField& field, BeaconData& result, EddystoneURLCache* url_cache);
+
+  /**
+   * @brief Decode Eddystone identity columns for batch parsing
+   * @param field Field matching AD_TYPE and AD_ID
+   * @param batch Batch whose columns receive the decoded fields
+   * @param row Row to write
+   * @return true if parsing was successful
+   */
+  static bool decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row);
+
+  /**
+   * @brief Check a field matching AD_TYPE and AD_ID without decoding it
+   * @param field Field matching AD_TYPE and AD_ID
+   * @return BEACON_TYPE_EDDYSTONE_UID, _URL or _TLM, or BEACON_TYPE_UNKNOWN if decode() would fail
+   */
+  static BeaconType classify(const ADField& field);
+
+ private:
   /**
    * @brief Parse Eddystone-UID frame
    * @param frame_data Frame data (after frame type byte)
@@ -59,9 +103,11 @@ class EddystoneParser {
    * @param frame_data Frame data (after frame type byte)
    * @param frame_len Frame data length
    * @param result BeaconData structure to fill
+   * @param url_cache Optional cache for the URL expansion
    * @return true if parsing was successful
    */
-  static bool parseURL(const uint8_t* frame_data, uint8_t frame_len, BeaconData& result);
+  static bool parseURL(const uint8_t* frame_data, uint8_t frame_len, BeaconData& result,
+                       EddystoneURLCache* url_cache);
 
   /**
    * @brief Parse Eddystone-TLM frame
@@ -71,20 +117,6 @@ class EddystoneParser {
    * @return true if parsing was successful
    */
   static bool parseTLM(const uint8_t* frame_data, uint8_t frame_len, BeaconData& result);
-
-  /**
-   * @brief Decode Eddystone URL encoding
-   * @param encoded_url Encoded URL byte
-   * @return Decoded URL string or empty string if invalid
-   */
-  static String decodeURLScheme(uint8_t encoded_url);
-
-  /**
-   * @brief Decode Eddystone URL suffix
-   * @param encoded_suffix Encoded suffix byte
-   * @return Decoded URL suffix string or empty string if invalid
-   */
-  static String decodeURLSuffix(uint8_t encoded_suffix);
 };
 
 #endif  // EDDYSTONE_PARSER_H
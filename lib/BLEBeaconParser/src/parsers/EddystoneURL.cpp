@@ -0,0 +1,137 @@
+#include "EddystoneURL.h"
+#include <string.h>
+
+// Keep the 2 KB expansion table in flash on AVR
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define URL_TABLE_STORAGE PROGMEM
+#define URL_TABLE_COPY memcpy_P
+#else
+#define URL_TABLE_STORAGE
+#define URL_TABLE_COPY memcpy
+#endif
+
+// Every expansion is copied as a whole text slot; pos then advances by its length
+#define URL_EXPANSION_TEXT_SIZE 7
+
+struct URLExpansion {
+  char text[URL_EXPANSION_TEXT_SIZE];
+  uint8_t len;
+};
+
+struct URLScheme {
+  const char* text;
+  uint8_t len;
+};
+
+static const URLScheme URL_SCHEMES[4] = {
+  {"http://www.", 11}, {"https://www.", 12}, {"http://", 7}, {"https://", 8}};
+
+static const URLExpansion URL_EXPANSIONS[256] URL_TABLE_STORAGE = {
+  // 0x00-0x0D: TLD suffix expansions
+  {".com/", 5}, {".org/", 5}, {".edu/", 5}, {".net/", 5}, {".info/", 6}, {".biz/", 5}, {".gov/", 5},
+  {".com", 4}, {".org", 4}, {".edu", 4}, {".net", 4}, {".info", 5}, {".biz", 4}, {".gov", 4},
+  // 0x0E-0xFF: emitted as-is (0x0E-0x20 and 0x7F-0xFF are reserved by the spec)
+  {"\x0E", 1}, {"\x0F", 1}, {"\x10", 1}, {"\x11", 1}, {"\x12", 1}, {"\x13", 1}, {"\x14", 1},
+  {"\x15", 1}, {"\x16", 1}, {"\x17", 1}, {"\x18", 1}, {"\x19", 1}, {"\x1A", 1}, {"\x1B", 1},
+  {"\x1C", 1}, {"\x1D", 1}, {"\x1E", 1}, {"\x1F", 1}, {" ", 1}, {"!", 1}, {"\"", 1}, {"#", 1},
+  {"$", 1}, {"%", 1}, {"&", 1}, {"'", 1}, {"(", 1}, {")", 1}, {"*", 1}, {"+", 1}, {",", 1},
+  {"-", 1}, {".", 1}, {"/", 1}, {"0", 1}, {"1", 1}, {"2", 1}, {"3", 1}, {"4", 1}, {"5", 1},
+  {"6", 1}, {"7", 1}, {"8", 1}, {"9", 1}, {":", 1}, {";", 1}, {"<", 1}, {"=", 1}, {">", 1},
+  {"?", 1}, {"@", 1}, {"A", 1}, {"B", 1}, {"C", 1}, {"D", 1}, {"E", 1}, {"F", 1}, {"G", 1},
+  {"H", 1}, {"I", 1}, {"J", 1}, {"K", 1}, {"L", 1}, {"M", 1}, {"N", 1}, {"O", 1}, {"P", 1},
+  {"Q", 1}, {"R", 1}, {"S", 1}, {"T", 1}, {"U", 1}, {"V", 1}, {"W", 1}, {"X", 1}, {"Y", 1},
+  {"Z", 1}, {"[", 1}, {"\\", 1}, {"]", 1}, {"^", 1}, {"_", 1}, {"`", 1}, {"a", 1}, {"b", 1},
+  {"c", 1}, {"d", 1}, {"e", 1}, {"f", 1}, {"g", 1}, {"h", 1}, {"i", 1}, {"j", 1}, {"k", 1},
+  {"l", 1}, {"m", 1}, {"n", 1}, {"o", 1}, {"p", 1}, {"q", 1}, {"r", 1}, {"s", 1}, {"t", 1},
+  {"u", 1}, {"v", 1}, {"w", 1}, {"x", 1}, {"y", 1}, {"z", 1}, {"{", 1}, {"|", 1}, {"}", 1},
+  {"~", 1}, {"\x7F", 1}, {"\x80", 1}, {"\x81", 1}, {"\x82", 1}, {"\x83", 1}, {"\x84", 1},
+  {"\x85", 1}, {"\x86", 1}, {"\x87", 1}, {"\x88", 1}, {"\x89", 1}, {"\x8A", 1}, {"\x8B", 1},
+  {"\x8C", 1}, {"\x8D", 1}, {"\x8E", 1}, {"\x8F", 1}, {"\x90", 1}, {"\x91", 1}, {"\x92", 1},
+  {"\x93", 1}, {"\x94", 1}, {"\x95", 1}, {"\x96", 1}, {"\x97", 1}, {"\x98", 1}, {"\x99", 1},
+  {"\x9A", 1}, {"\x9B", 1}, {"\x9C", 1}, {"\x9D", 1}, {"\x9E", 1}, {"\x9F", 1}, {"\xA0", 1},
+  {"\xA1", 1}, {"\xA2", 1}, {"\xA3", 1}, {"\xA4", 1}, {"\xA5", 1}, {"\xA6", 1}, {"\xA7", 1},
+  {"\xA8", 1}, {"\xA9", 1}, {"\xAA", 1}, {"\xAB", 1}, {"\xAC", 1}, {"\xAD", 1}, {"\xAE", 1},
+  {"\xAF", 1}, {"\xB0", 1}, {"\xB1", 1}, {"\xB2", 1}, {"\xB3", 1}, {"\xB4", 1}, {"\xB5", 1},
+  {"\xB6", 1}, {"\xB7", 1}, {"\xB8", 1}, {"\xB9", 1}, {"\xBA", 1}, {"\xBB", 1}, {"\xBC", 1},
+  {"\xBD", 1}, {"\xBE", 1}, {"\xBF", 1}, {"\xC0", 1}, {"\xC1", 1}, {"\xC2", 1}, {"\xC3", 1},
+  {"\xC4", 1}, {"\xC5", 1}, {"\xC6", 1}, {"\xC7", 1}, {"\xC8", 1}, {"\xC9", 1}, {"\xCA", 1},
+  {"\xCB", 1}, {"\xCC", 1}, {"\xCD", 1}, {"\xCE", 1}, {"\xCF", 1}, {"\xD0", 1}, {"\xD1", 1},
+  {"\xD2", 1}, {"\xD3", 1}, {"\xD4", 1}, {"\xD5", 1}, {"\xD6", 1}, {"\xD7", 1}, {"\xD8", 1},
+  {"\xD9", 1}, {"\xDA", 1}, {"\xDB", 1}, {"\xDC", 1}, {"\xDD", 1}, {"\xDE", 1}, {"\xDF", 1},
+  {"\xE0", 1}, {"\xE1", 1}, {"\xE2", 1}, {"\xE3", 1}, {"\xE4", 1}, {"\xE5", 1}, {"\xE6", 1},
+  {"\xE7", 1}, {"\xE8", 1}, {"\xE9", 1}, {"\xEA", 1}, {"\xEB", 1}, {"\xEC", 1}, {"\xED", 1},
+  {"\xEE", 1}, {"\xEF", 1}, {"\xF0", 1}, {"\xF1", 1}, {"\xF2", 1}, {"\xF3", 1}, {"\xF4", 1},
+  {"\xF5", 1}, {"\xF6", 1}, {"\xF7", 1}, {"\xF8", 1}, {"\xF9", 1}, {"\xFA", 1}, {"\xFB", 1},
+  {"\xFC", 1}, {"\xFD", 1}, {"\xFE", 1}, {"\xFF", 1},
+};
+
+uint8_t EddystoneURLDecoder::expand(const uint8_t* encoded, uint8_t len, char* out) {
+  if (encoded == nullptr || len < 1 || len > 1 + EDDYSTONE_URL_MAX_ENCODED_LENGTH ||
+      encoded[0] >= 4) {
+    return 0;
+  }
+
+  // Whole-slot copies can overhang the last expansion, so decode into a
+  // scratch buffer with room for one extra slot
+  char scratch[EDDYSTONE_URL_MAX_LENGTH + URL_EXPANSION_TEXT_SIZE];
+
+  const URLScheme& scheme = URL_SCHEMES[encoded[0]];
+  memcpy(scratch, scheme.text, scheme.len);
+  uint8_t pos = scheme.len;
+
+  for (uint8_t i = 1; i < len; i++) {
+    URLExpansion expansion;
+    URL_TABLE_COPY(&expansion, &URL_EXPANSIONS[encoded[i]], sizeof(expansion));
+    memcpy(&scratch[pos], expansion.text, URL_EXPANSION_TEXT_SIZE);
+    pos += expansion.len;
+  }
+
+  memcpy(out, scratch, pos);
+  out[pos] = '\0';
+  return pos;
+}
+
+EddystoneURLCache::EddystoneURLCache() {
+  clear();
+}
+
+void EddystoneURLCache::clear() {
+  for (uint8_t i = 0; i < EDDYSTONE_URL_CACHE_SIZE; i++) {
+    entries[i].encoded_len = 0;
+  }
+  hit_count = 0;
+  miss_count = 0;
+}
+
+uint8_t EddystoneURLCache::expand(const uint8_t* encoded, uint8_t len, char* out) {
+  if (encoded == nullptr || len < 1 || len > 1 + EDDYSTONE_URL_MAX_ENCODED_LENGTH) {
+    return 0;
+  }
+
+  // FNV-1a over the encoded bytes selects the slot
+  uint32_t hash = 2166136261u;
+  for (uint8_t i = 0; i < len; i++) {
+    hash ^= encoded[i];
+    hash *= 16777619u;
+  }
+  Entry& entry = entries[(hash ^ (hash >> 16)) & (EDDYSTONE_URL_CACHE_SIZE - 1)];
+
+  if (entry.encoded_len == len && memcmp(entry.encoded, encoded, len) == 0) {
+    hit_count++;
+    memcpy(out, entry.url, entry.url_len + 1);
+    return entry.url_len;
+  }
+
+  miss_count++;
+
+  uint8_t url_len = EddystoneURLDecoder::expand(encoded, len, out);
+  if (url_len > 0) {
+    memcpy(entry.encoded, encoded, len);
+    entry.encoded_len = len;
+    entry.url_len = url_len;
+    memcpy(entry.url, out, url_len + 1);
+  }
+
+  return url_len;
+}
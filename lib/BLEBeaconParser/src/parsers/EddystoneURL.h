@@ -0,0 +1,82 @@
+#ifndef EDDYSTONE_URL_H
+#define EDDYSTONE_URL_H
+
+#include <stdint.h>
+#include "../BeaconData.h"
+
+// Number of entries in an EddystoneURLCache (power of two)
+#define EDDYSTONE_URL_CACHE_BITS 3
+#define EDDYSTONE_URL_CACHE_SIZE (1 << EDDYSTONE_URL_CACHE_BITS)
+
+/**
+ * @brief Table-driven Eddystone-URL decoder
+ *
+ * Encoded URL format: [Scheme][Encoded bytes (0-17)]
+ * - Scheme: 0x00 "http://www.", 0x01 "https://www.", 0x02 "http://", 0x03 "https://"
+ * - Bytes 0x00-0x0D expand to TLD suffixes (".com/", ".org", ...)
+ * - All other bytes are emitted as-is
+ *
+ * Every encoded byte is expanded through a precomputed 256-entry table with
+ * one fixed-size copy, directly into a bounded buffer.
+ */
+class EddystoneURLDecoder {
+ public:
+  /**
+   * @brief Expand an encoded URL
+   * @param encoded Scheme byte followed by the encoded URL bytes
+   * @param len Length of encoded data (1 to 1 + EDDYSTONE_URL_MAX_ENCODED_LENGTH)
+   * @param out Buffer of at least EDDYSTONE_URL_MAX_LENGTH + 1 bytes (NUL-terminated)
+   * @return Length of the decoded URL, or 0 if the scheme or length is invalid
+   */
+  static uint8_t expand(const uint8_t* encoded, uint8_t len, char* out);
+};
+
+/**
+ * @brief Optional cache of decoded Eddystone URLs keyed on the raw encoded bytes
+ *
+ * A small direct-mapped cache: URL beacons repeat the same handful of
+ * encodings, so a hit replaces the expansion with a single copy of the
+ * previously decoded URL.
+ *
+ * Not thread-safe; use one cache per parsing thread.
+ */
+class EddystoneURLCache {
+ public:
+  EddystoneURLCache();
+
+  /**
+   * @brief Decode an encoded URL, consulting and updating the cache
+   * @param encoded Scheme byte followed by the encoded URL bytes
+   * @param len Length of encoded data
+   * @param out Buffer of at least EDDYSTONE_URL_MAX_LENGTH + 1 bytes (NUL-terminated)
+   * @return Length of the decoded URL, or 0 if invalid
+   */
+  uint8_t expand(const uint8_t* encoded, uint8_t len, char* out);
+
+  /**
+   * @brief Drop all cached URLs and reset the counters
+   */
+  void clear();
+
+  uint32_t hits() const {
+    return hit_count;
+  }
+
+  uint32_t misses() const {
+    return miss_count;
+  }
+
+ private:
+  struct Entry {
+    uint8_t encoded[1 + EDDYSTONE_URL_MAX_ENCODED_LENGTH];
+    uint8_t encoded_len;  // 0 marks an empty entry
+    uint8_t url_len;
+    char url[EDDYSTONE_URL_MAX_LENGTH + 1];
+  };
+
+  Entry entries[EDDYSTONE_URL_CACHE_SIZE];
+  uint32_t hit_count;
+  uint32_t miss_count;
+};
+
+#endif  // EDDYSTONE_URL_H
@@ -1,132 +1,86 @@
 #include "iBeaconParser.h"
-
-// Apple Company ID (little-endian in advertisement data)
-#define APPLE_COMPANY_ID_LOW 0x4C
-#define APPLE_COMPANY_ID_HIGH 0x00
+#include <string.h>
 
 // iBeacon prefix bytes
 #define IBEACON_PREFIX_1 0x02
 #define IBEACON_PREFIX_2 0x15
 
-// Expected iBeacon data length: prefix (2) + UUID (16) + Major (2) + Minor (2) + TX Power (1) = 23
-// bytes
-#define IBEACON_DATA_LENGTH 23
+// iBeacon layout (offsets include the 2-byte Company ID):
+// prefix 02 15, UUID (16), Major (2), Minor (2), TX Power (1)
+#define IBEACON_LAYOUT "m:2-3=0215,i:4-19,i:20-21,i:22-23,p:24-24"
 
-// AD Structure types
-#define AD_TYPE_MANUFACTURER_SPECIFIC_DATA 0xFF
+const BeaconLayout& iBeaconParser::layout() {
+  static const BeaconLayout plan(IBEACON_LAYOUT, AD_ID);
+  return plan;
+}
 
-bool iBeaconParser::canParse(const uint8_t* data, uint8_t len) {
-  const uint8_t* mfg_data;
-  uint8_t mfg_len;
+bool iBeaconParser::canParse(const uint8_t* data, uint16_t len) {
+  ADFields fields;
+  ADTokenizer::tokenize(data, len, fields, AD_TYPE, AD_ID);
+  return canParse(fields);
+}
 
-  if (!findAppleManufacturerData(data, len, mfg_data, mfg_len)) {
-    return false;
-  }
+bool iBeaconParser::parse(const uint8_t* data, uint16_t len, BeaconData& result) {
+  ADFields fields;
+  ADTokenizer::tokenize(data, len, fields, AD_TYPE, AD_ID);
+  return parse(fields, result);
+}
+
+bool iBeaconParser::canParse(const ADFields& fields) {
+  const ADField* mfg = fields.find(AD_TYPE, AD_ID);
 
   // Check if we have enough data for iBeacon prefix
-  if (mfg_len < 2) {
+  if (mfg == nullptr || mfg->len < 2) {
     return false;
   }
 
   // Check for iBeacon prefix (0x02 0x15)
-  return (mfg_data[0] == IBEACON_PREFIX_1 && mfg_data[1] == IBEACON_PREFIX_2);
+  return (mfg->data[0] == IBEACON_PREFIX_1 && mfg->data[1] == IBEACON_PREFIX_2);
 }
 
-bool iBeaconParser::parse(const uint8_t* data, uint8_t len, BeaconData& result) {
-  const uint8_t* mfg_data;
-  uint8_t mfg_len;
+bool iBeaconParser::parse(const ADFields& fields, BeaconData& result) {
+  const ADField* mfg = fields.find(AD_TYPE, AD_ID);
 
-  if (!findAppleManufacturerData(data, len, mfg_data, mfg_len)) {
+  if (mfg == nullptr) {
     result.valid = false;
     return false;
   }
 
-  // Verify iBeacon prefix and length
-  if (mfg_len < IBEACON_DATA_LENGTH || mfg_data[0] != IBEACON_PREFIX_1 ||
-      mfg_data[1] != IBEACON_PREFIX_2) {
+  return decode(*mfg, result);
+}
+
+bool iBeaconParser::decode(const ADField& field, BeaconData& result) {
+  // Verify iBeacon prefix and length, then extract the layout fields
+  BeaconLayoutValues values;
+  if (!layout().extract(field, values)) {
     result.valid = false;
     return false;
   }
 
-  // Extract UUID (16 bytes starting at offset 2)
-  result.ibeacon.uuid = uuidToString(&mfg_data[2]);
-
-  // Extract Major (2 bytes, big-endian, at offset 18)
-  result.ibeacon.major = (mfg_data[18] << 8) | mfg_data[19];
-
-  // Extract Minor (2 bytes, big-endian, at offset 20)
-  result.ibeacon.minor = (mfg_data[20] << 8) | mfg_data[21];
-
-  // Extract TX Power (1 byte, signed, at offset 22)
-  result.ibeacon.tx_power = (int8_t)mfg_data[22];
+  memcpy(result.ibeacon.uuid, values.identifiers[0].bytes, IBEACON_UUID_LENGTH);
+  result.ibeacon.major = values.identifiers[1].value;
+  result.ibeacon.minor = values.identifiers[2].value;
+  result.ibeacon.tx_power = values.power;
 
   result.type = BEACON_TYPE_IBEACON;
   result.valid = true;
   return true;
 }
 
-String iBeaconParser::uuidToString(const uint8_t* uuid_bytes) {
-  String uuid = "";
-
-  // Format: XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX
-  for (int i = 0; i < 16; i++) {
-    if (uuid.length() > 0) {
-      // Add dashes at positions 8, 12, 16, 20
-      if (i == 4 || i == 6 || i == 8 || i == 10) {
-        uuid += "-";
-      }
-    }
-
-    // Convert byte to hex
-    char hex[3];
-    sprintf(hex, "%02X", uuid_bytes[i]);
-    uuid += hex;
+bool iBeaconParser::decodeColumns(const ADField& field, BeaconBatch& batch, uint16_t row) {
+  BeaconLayoutValues values;
+  if (!layout().extract(field, values)) {
+    return false;
   }
 
-  return uuid;
+  memcpy(batch.id[row], values.identifiers[0].bytes, IBEACON_UUID_LENGTH);
+  batch.major[row] = values.identifiers[1].value;
+  batch.minor[row] = values.identifiers[2].value;
+  batch.tx_power[row] = values.power;
+  batch.type[row] = BEACON_TYPE_IBEACON;
+  return true;
 }
 
-bool iBeaconParser::findAppleManufacturerData(const uint8_t* data, uint8_t len,
-                                              const uint8_t*& out_data, uint8_t& out_len) {
-  uint8_t pos = 0;
-
-  // Parse AD structures: [Length][Type][Data...]
-  while (pos < len) {
-    uint8_t ad_len = data[pos];
-
-    // Check for valid length (0 means end of data)
-    if (ad_len == 0) {
-      break;
-    }
-
-    // Check if we have enough data
-    if (pos + ad_len >= len) {
-      break;
-    }
-
-    uint8_t ad_type = data[pos + 1];
-
-    // Check for Manufacturer Specific Data
-    if (ad_type == AD_TYPE_MANUFACTURER_SPECIFIC_DATA) {
-      // Manufacturer data starts at pos + 2
-      // First 2 bytes are Company ID (little-endian)
-      if (ad_len >= 2) {
-        uint8_t company_id_low = data[pos + 2];
-        uint8_t company_id_high = data[pos + 3];
-
-        // Check for Apple Company ID (0x004C)
-        if (company_id_low == APPLE_COMPANY_ID_LOW && company_id_high == APPLE_COMPANY_ID_HIGH) {
-          // Manufacturer data starts after Company ID (offset 4)
-          out_data = &data[pos + 4];
-          out_len = ad_len - 2;  // Subtract Company ID length
-          return true;
-        }
-      }
-    }
-
-    // Move to next AD structure
-    pos += ad_len + 1;
-  }
-
-  return false;
+BeaconType iBeaconParser::classify(const ADField& field) {
+  return layout().matches(field) ? BEACON_TYPE_IBEACON : BEACON_TYPE_UNKNOWN;
 }
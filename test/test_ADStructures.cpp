@@ -0,0 +1,187 @@
+#include <string.h>
+#include <unity.h>
+#include "ADStructures.h"
+#include "BLEBeaconParser.h"
+#include "BLEBeaconParserT.h"
+
+void test_tokenizer_locates_fields() {
+  // Flags, Apple manufacturer data and Eddystone service data in one packet
+  uint8_t packet[] = {
+    0x02, 0x01, 0x06,                    // Flags
+    0x05, 0xFF, 0x4C, 0x00, 0x01, 0x02,  // Apple manufacturer data (2 payload bytes)
+    0x04, 0x16, 0xAA, 0xFE, 0x10         // Eddystone service data (1 payload byte)
+  };
+
+  ADFields fields;
+  uint8_t count = ADTokenizer::tokenize(packet, sizeof(packet), fields);
+
+  TEST_ASSERT_EQUAL(2, count);
+
+  const ADField* mfg = fields.find(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x004C);
+  TEST_ASSERT_NOT_NULL(mfg);
+  TEST_ASSERT_EQUAL(2, mfg->len);
+  TEST_ASSERT_EQUAL(0x01, mfg->data[0]);
+  TEST_ASSERT_EQUAL(0x02, mfg->data[1]);
+
+  const ADField* service = fields.find(AD_TYPE_SERVICE_DATA, 0xFEAA);
+  TEST_ASSERT_NOT_NULL(service);
+  TEST_ASSERT_EQUAL(1, service->len);
+  TEST_ASSERT_EQUAL(0x10, service->data[0]);
+
+  TEST_ASSERT_NULL(fields.find(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x0118));
+}
+
+void test_tokenizer_bounds() {
+  ADFields fields;
+
+  // Manufacturer data too short to hold a company ID is skipped
+  uint8_t no_company[] = {0x02, 0xFF, 0x4C};
+  TEST_ASSERT_EQUAL(0, ADTokenizer::tokenize(no_company, sizeof(no_company), fields));
+
+  // Structure running past the end of the buffer stops the walk
+  uint8_t truncated[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F};
+  TEST_ASSERT_EQUAL(0, ADTokenizer::tokenize(truncated, sizeof(truncated), fields));
+
+  // Truncated iBeacon is rejected by the parser rather than read out of bounds
+  BLEBeaconParser parser;
+  BeaconData result;
+  TEST_ASSERT_FALSE(parser.parse(truncated, sizeof(truncated), result));
+  TEST_ASSERT_FALSE(result.valid);
+}
+
+// Extended advertising data longer than 255 bytes: flags, two long names,
+// an iBeacon at offset 387 and an Eddystone-UID service structure at 418
+static uint16_t buildExtended(uint8_t* out) {
+  static const uint8_t beacons[] = {
+    0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8, 0x96, 0xB8, 0x86, 0x45, 0x49,
+    0xAE, 0x01, 0xE4, 0x1A, 0xCD, 0x7A, 0x35, 0x4A, 0x01, 0x02, 0x03, 0x04, 0xC5,
+    0x03, 0x03, 0xAA, 0xFE, 0x15, 0x16, 0xAA, 0xFE, 0x00, 0xEC, 0x01, 0x02, 0x03, 0x04,
+    0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10};
+
+  uint16_t len = 0;
+  out[len++] = 0x02;
+  out[len++] = 0x01;
+  out[len++] = 0x06;
+  for (uint8_t name_len = 0xFE; name_len >= 0x80; name_len -= 0x7E) {
+    out[len++] = name_len;
+    out[len++] = 0x09;
+    for (uint8_t i = 1; i < name_len; i++) {
+      out[len++] = 'a' + i % 26;
+    }
+  }
+  memcpy(&out[len], beacons, sizeof(beacons));
+  return len + sizeof(beacons);
+}
+
+void test_tokenizer_extended_length() {
+  uint8_t payload[440];
+  uint16_t len = buildExtended(payload);
+  TEST_ASSERT_EQUAL(sizeof(payload), len);
+
+  // Fields past byte 255 are found in one contiguous buffer
+  BLEBeaconParser parser;
+  BeaconData result;
+  TEST_ASSERT_TRUE(parser.parse(payload, len, result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL(0x0102, result.getIBeacon().major);
+
+  const uint8_t* data;
+  uint8_t data_len;
+  TEST_ASSERT_TRUE(BLEBeaconParser::findServiceData(payload, len, 0xFEAA, data, data_len));
+  TEST_ASSERT_EQUAL_PTR(&payload[420], data);
+  TEST_ASSERT_TRUE(BLEBeaconParser::findManufacturerData(payload, len, 0x004C, data, data_len));
+  TEST_ASSERT_EQUAL_PTR(&payload[391], data);
+}
+
+void test_chain_tokenizer_fragments() {
+  uint8_t payload[440];
+  uint16_t len = buildExtended(payload);
+  BLEBeaconParser parser;
+
+  // Split anywhere, with an empty fragment in between
+  for (uint16_t split = 0; split <= len; split++) {
+    uint16_t rest = len - split;
+    AdvFragment chain[] = {{payload, split}, {nullptr, 0}, {&payload[split], rest}};
+    ADChainTokenizer tokens(chain, 3);
+    ADField field;
+
+    TEST_ASSERT_TRUE(tokens.next(field));
+    TEST_ASSERT_EQUAL(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, field.type);
+    TEST_ASSERT_EQUAL(0x004C, field.id);
+    TEST_ASSERT_EQUAL(23, field.len);
+    TEST_ASSERT_EQUAL_MEMORY(&payload[391], field.data, 23);
+
+    TEST_ASSERT_TRUE(tokens.next(field));
+    TEST_ASSERT_EQUAL(0xFEAA, field.id);
+    TEST_ASSERT_EQUAL(18, field.len);
+    TEST_ASSERT_EQUAL_MEMORY(&payload[422], field.data, 18);
+    TEST_ASSERT_FALSE(tokens.next(field));
+
+    // Only a beacon structure whose body the split cuts is copied
+    bool cut = (split > 388 && split < 414) || (split > 419 && split < 440);
+    TEST_ASSERT_EQUAL(cut ? 1 : 0, tokens.copies());
+
+    BeaconData result;
+    TEST_ASSERT_TRUE(parser.parseChain(chain, 3, result));
+    TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+    TEST_ASSERT_EQUAL(0x0304, result.getIBeacon().minor);
+  }
+
+  // Chain ending inside a structure stops the walk
+  AdvFragment missing[] = {{payload, 200}, {&payload[200], 200}};
+  ADChainTokenizer tokens(missing, 2);
+  ADField field;
+  TEST_ASSERT_FALSE(tokens.next(field));
+  BeaconData result;
+  TEST_ASSERT_FALSE(parser.parseChain(missing, 2, result));
+  TEST_ASSERT_FALSE(result.valid);
+}
+
+void test_tokenizer_many_fields() {
+  // Five service data structures ahead of an iBeacon
+  uint8_t packet[] = {
+    0x03, 0x16, 0x0F, 0x18, 0x04, 0x16, 0x0F, 0x18, 0x64, 0x03, 0x16, 0x1A, 0x18, 0x03, 0x16,
+    0x1C, 0x18, 0x03, 0x16, 0x1D, 0x18, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+    0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A, 0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07,
+    0x00, 0x09, 0xC5};
+
+  // next() visits every field; ADFields keeps the first AD_MAX_FIELDS
+  ADTokenizer tokens(packet, sizeof(packet));
+  ADField field;
+  uint8_t count = 0;
+  while (tokens.next(field)) {
+    count++;
+  }
+  TEST_ASSERT_EQUAL(6, count);
+  TEST_ASSERT_EQUAL(0x004C, field.id);
+
+  ADFields fields;
+  TEST_ASSERT_EQUAL(AD_MAX_FIELDS, ADTokenizer::tokenize(packet, sizeof(packet), fields));
+  TEST_ASSERT_EQUAL(1, ADTokenizer::tokenize(packet, sizeof(packet), fields,
+                                             AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x004C));
+
+  // The beacon in the sixth field is found by every entry point
+  BLEBeaconParser parser;
+  BeaconData result;
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL(7, result.getIBeacon().major);
+
+  BeaconView view;
+  TEST_ASSERT_TRUE(parser.parseView(packet, sizeof(packet), view));
+  TEST_ASSERT_EQUAL(9, view.minor());
+
+  BeaconBatchBuffer<1> batch;
+  AdvPacket packets[] = {{packet, sizeof(packet)}};
+  TEST_ASSERT_EQUAL(1, parser.parseBatch(packets, 1, batch));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, batch.type[0]);
+
+  BLEBeaconParserT<iBeaconParser, EddystoneParser> composed;
+  TEST_ASSERT_TRUE(composed.parse(packet, sizeof(packet), result));
+  TEST_ASSERT_TRUE(composed.parseView(packet, sizeof(packet), view));
+  TEST_ASSERT_EQUAL(1, composed.parseBatch(packets, 1, batch));
+
+  TEST_ASSERT_TRUE(iBeaconParser::canParse(packet, sizeof(packet)));
+  TEST_ASSERT_TRUE(iBeaconParser::parse(packet, sizeof(packet), result));
+  TEST_ASSERT_EQUAL(9, result.getIBeacon().minor);
+}
@@ -0,0 +1,47 @@
+#include <unity.h>
+#include "BLEBeaconParserT.h"
+
+static const uint8_t IBEACON_PACKET[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                         0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                         0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+static const uint8_t EDDYSTONE_UID_PACKET[] = {
+  0x15, 0x16, 0xAA, 0xFE, 0x00, 0xF0, 0x00, 0x11, 0x22, 0x33, 0x44,
+  0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+
+void test_composed_parser_single_format() {
+  BLEBeaconParserT<iBeaconParser> parser;
+  BeaconData result;
+
+  TEST_ASSERT_TRUE(parser.parse(IBEACON_PACKET, sizeof(IBEACON_PACKET), result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL(7, result.getIBeacon().major);
+  TEST_ASSERT_EQUAL(9, result.getIBeacon().minor);
+
+  // Formats left out of the composition are not recognised
+  TEST_ASSERT_FALSE(parser.parse(EDDYSTONE_UID_PACKET, sizeof(EDDYSTONE_UID_PACKET), result));
+  TEST_ASSERT_FALSE(result.valid);
+
+  BeaconView view;
+  TEST_ASSERT_FALSE(parser.parseView(EDDYSTONE_UID_PACKET, sizeof(EDDYSTONE_UID_PACKET), view));
+  TEST_ASSERT_TRUE(parser.parseView(IBEACON_PACKET, sizeof(IBEACON_PACKET), view));
+  TEST_ASSERT_EQUAL(7, view.major());
+}
+
+void test_composed_parser_batch() {
+  BLEBeaconParserT<EddystoneParser, iBeaconParser> parser;
+  static BeaconBatchBuffer<3> batch;
+
+  static const uint8_t noise[] = {0x02, 0x01, 0x06};
+  AdvPacket packets[] = {{IBEACON_PACKET, sizeof(IBEACON_PACKET)},
+                         {noise, sizeof(noise)},
+                         {EDDYSTONE_UID_PACKET, sizeof(EDDYSTONE_UID_PACKET)}};
+
+  TEST_ASSERT_EQUAL(2, parser.parseBatch(packets, 3, batch));
+  TEST_ASSERT_EQUAL(3, batch.count);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, batch.type[0]);
+  TEST_ASSERT_EQUAL(9, batch.minor[0]);
+  TEST_ASSERT_FALSE(batch.valid[1]);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_UID, batch.type[2]);
+  TEST_ASSERT_EQUAL(-16, batch.tx_power[2]);
+}
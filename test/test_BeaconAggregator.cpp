@@ -0,0 +1,143 @@
+#include <unity.h>
+#include "BeaconAggregator.h"
+
+#define MAX_SUMMARIES 8
+
+struct SummaryLog {
+  BeaconSummary summaries[MAX_SUMMARIES];
+  uint8_t count;
+};
+
+static void logSummary(const BeaconSummary& summary, void* context) {
+  SummaryLog* log = (SummaryLog*)context;
+  if (log->count < MAX_SUMMARIES) {
+    log->summaries[log->count++] = summary;
+  }
+}
+
+static BeaconKey makeKey(uint8_t n) {
+  uint8_t identity[16] = {0};
+  identity[15] = n;
+
+  BeaconKey key;
+  key.set(BEACON_TYPE_EDDYSTONE_UID, identity, sizeof(identity));
+  return key;
+}
+
+void test_aggregator_tumbling_window() {
+  static BeaconAggregatorBuffer<2> aggregator(1000);
+  SummaryLog log;
+  log.count = 0;
+  aggregator.setHandler(logSummary, &log);
+
+  BeaconData data;
+  BeaconKey a = makeKey(1);
+  BeaconKey b = makeKey(2);
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 100));
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -70, 200));
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -80, 300));
+  TEST_ASSERT_TRUE(aggregator.update(b, data, -50, 500));
+
+  // Table holds two beacons
+  TEST_ASSERT_FALSE(aggregator.update(makeKey(3), data, -50, 600));
+  TEST_ASSERT_EQUAL(1, aggregator.overflows());
+
+  // TLM frames attach to the key they are reported under
+  BeaconData tlm;
+  tlm.type = BEACON_TYPE_EDDYSTONE_TLM;
+  tlm.valid = true;
+  tlm.eddystone_tlm.battery_voltage = 2900;
+  TEST_ASSERT_TRUE(aggregator.update(b, tlm, -54, 700));
+  TEST_ASSERT_EQUAL(0, log.count);
+
+  // The first packet of the next window closes this one
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -65, 1200));
+  TEST_ASSERT_EQUAL(2, log.count);
+
+  const BeaconSummary& first = log.summaries[0];
+  TEST_ASSERT_TRUE(first.key == a);
+  TEST_ASSERT_EQUAL(0, first.window_start);
+  TEST_ASSERT_EQUAL(1000, first.window_end);
+  TEST_ASSERT_EQUAL(3, first.count);
+  TEST_ASSERT_EQUAL(-80, first.rssi_min);
+  TEST_ASSERT_EQUAL(-60, first.rssi_max);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -70.0f, first.rssi_mean);
+  TEST_ASSERT_EQUAL(-78, first.rssi_p10);
+  TEST_ASSERT_EQUAL(-70, first.rssi_p50);
+  TEST_ASSERT_EQUAL(-60, first.rssi_p90);  // Bin midpoint -58, clamped to the maximum
+  TEST_ASSERT_FALSE(first.has_tlm);
+
+  const BeaconSummary& second = log.summaries[1];
+  TEST_ASSERT_TRUE(second.key == b);
+  TEST_ASSERT_EQUAL(2, second.count);
+  TEST_ASSERT_TRUE(second.has_tlm);
+  TEST_ASSERT_EQUAL(2900, second.tlm.battery_voltage);
+
+  // Tumbling windows start empty: only a is in the new window
+  TEST_ASSERT_EQUAL(1, aggregator.size());
+  aggregator.advance(5000);
+  TEST_ASSERT_EQUAL(3, log.count);
+  TEST_ASSERT_EQUAL(1, log.summaries[2].count);
+  TEST_ASSERT_EQUAL(1000, log.summaries[2].window_start);
+  TEST_ASSERT_EQUAL(0, aggregator.size());
+}
+
+void test_aggregator_sliding_window() {
+  static BeaconAggregatorBuffer<4, 2> aggregator(1000);
+  SummaryLog log;
+  log.count = 0;
+  aggregator.setHandler(logSummary, &log);
+
+  BeaconData data;
+  BeaconKey a = makeKey(1);
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 100));
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -40, 600));
+
+  // A 1000-unit window closes every 500 units
+  aggregator.advance(1000);
+  TEST_ASSERT_EQUAL(2, log.count);
+  TEST_ASSERT_EQUAL(0, log.summaries[0].window_start);
+  TEST_ASSERT_EQUAL(500, log.summaries[0].window_end);
+  TEST_ASSERT_EQUAL(1, log.summaries[0].count);
+  TEST_ASSERT_EQUAL(0, log.summaries[1].window_start);
+  TEST_ASSERT_EQUAL(1000, log.summaries[1].window_end);
+  TEST_ASSERT_EQUAL(2, log.summaries[1].count);
+  TEST_ASSERT_EQUAL(-60, log.summaries[1].rssi_min);
+  TEST_ASSERT_EQUAL(-40, log.summaries[1].rssi_max);
+
+  // The first pane slides out; the beacon is dropped once no pane holds it
+  aggregator.advance(1500);
+  TEST_ASSERT_EQUAL(3, log.count);
+  TEST_ASSERT_EQUAL(500, log.summaries[2].window_start);
+  TEST_ASSERT_EQUAL(1500, log.summaries[2].window_end);
+  TEST_ASSERT_EQUAL(1, log.summaries[2].count);
+  TEST_ASSERT_EQUAL(-40, log.summaries[2].rssi_max);
+  TEST_ASSERT_EQUAL(0, aggregator.size());
+
+  aggregator.advance(3000);
+  TEST_ASSERT_EQUAL(3, log.count);
+}
+
+void test_aggregator_late_packet() {
+  static BeaconAggregatorBuffer<2> aggregator(10000);
+  SummaryLog log;
+  log.count = 0;
+  aggregator.setHandler(logSummary, &log);
+
+  BeaconData data;
+  BeaconKey a = makeKey(1);
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 10000));
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 12000));
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 15000));
+
+  // A packet from before the window, relayed late, joins the open window
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 9999));
+  TEST_ASSERT_TRUE(aggregator.update(a, data, -60, 16000));
+  TEST_ASSERT_EQUAL(0, log.count);
+
+  aggregator.advance(20000);
+  TEST_ASSERT_EQUAL(1, log.count);
+  TEST_ASSERT_EQUAL(10000, log.summaries[0].window_start);
+  TEST_ASSERT_EQUAL(20000, log.summaries[0].window_end);
+  TEST_ASSERT_EQUAL(5, log.summaries[0].count);
+}
@@ -0,0 +1,66 @@
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+
+static const uint8_t batch_ibeacon[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                        0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                        0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x01, 0x00, 0x02, 0xC5};
+
+static const uint8_t batch_noise[] = {0x02, 0x01, 0x06, 0x03, 0x03, 0x0F, 0x18};
+
+static const uint8_t batch_eddystone_uid[] = {
+  0x15, 0x16, 0xAA, 0xFE, 0x00, 0xF0, 0x00, 0x11, 0x22, 0x33, 0x44,
+  0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+
+void test_parse_batch_packets() {
+  BLEBeaconParser parser;
+  BeaconBatchBuffer<4> batch;
+
+  AdvPacket packets[] = {{batch_ibeacon, sizeof(batch_ibeacon)},
+                         {batch_noise, sizeof(batch_noise)},
+                         {batch_eddystone_uid, sizeof(batch_eddystone_uid)}};
+
+  uint16_t parsed = parser.parseBatch(packets, 3, batch);
+
+  TEST_ASSERT_EQUAL(2, parsed);
+  TEST_ASSERT_EQUAL(3, batch.count);
+
+  TEST_ASSERT_TRUE(batch.valid[0]);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, batch.type[0]);
+  TEST_ASSERT_EQUAL_MEMORY(&batch_ibeacon[6], batch.id[0], 16);
+  TEST_ASSERT_EQUAL(1, batch.major[0]);
+  TEST_ASSERT_EQUAL(2, batch.minor[0]);
+  TEST_ASSERT_EQUAL(-59, batch.tx_power[0]);
+
+  TEST_ASSERT_FALSE(batch.valid[1]);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_UNKNOWN, batch.type[1]);
+
+  TEST_ASSERT_TRUE(batch.valid[2]);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_UID, batch.type[2]);
+  TEST_ASSERT_EQUAL_MEMORY(&batch_eddystone_uid[6], batch.id[2], 16);
+  TEST_ASSERT_EQUAL(-16, batch.tx_power[2]);
+}
+
+void test_parse_batch_packed() {
+  BLEBeaconParser parser;
+  BeaconBatchBuffer<2> batch;
+
+  uint8_t buffer[sizeof(batch_noise) + sizeof(batch_ibeacon) + sizeof(batch_eddystone_uid)];
+  memcpy(buffer, batch_noise, sizeof(batch_noise));
+  memcpy(&buffer[sizeof(batch_noise)], batch_ibeacon, sizeof(batch_ibeacon));
+  memcpy(&buffer[sizeof(batch_noise) + sizeof(batch_ibeacon)], batch_eddystone_uid,
+         sizeof(batch_eddystone_uid));
+
+  uint16_t offsets[] = {0, sizeof(batch_noise), sizeof(batch_noise) + sizeof(batch_ibeacon),
+                        sizeof(buffer)};
+
+  // Three packets, but the batch only holds two rows
+  uint16_t parsed = parser.parseBatch(buffer, offsets, 3, batch);
+
+  TEST_ASSERT_EQUAL(1, parsed);
+  TEST_ASSERT_EQUAL(2, batch.count);
+  TEST_ASSERT_FALSE(batch.valid[0]);
+  TEST_ASSERT_TRUE(batch.valid[1]);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, batch.type[1]);
+  TEST_ASSERT_EQUAL(1, batch.major[1]);
+}
@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconCapture.h"
+
+static const uint8_t IBEACON_PACKET[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                         0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                         0xCD, 0x7A, 0x35, 0x4A, 0x01, 0x02, 0x03, 0x04, 0xC5};
+
+void test_capture_record_encoding() {
+  static const uint8_t address[6] = {0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6};
+  ScanObservation observation;
+  observation.payload = IBEACON_PACKET;
+  observation.payload_len = sizeof(IBEACON_PACKET);
+  observation.timestamp_us = 0x0102030405060708ULL;
+  memcpy(observation.address, address, 6);
+  observation.address_type = 1;
+  observation.rssi = -61;
+  observation.channel = 38;
+  observation.flags = SCAN_OBSERVATION_LEGACY | SCAN_OBSERVATION_CONNECTABLE;
+
+  // 24-byte header + 27-byte payload, padded to 56
+  uint8_t record[64];
+  TEST_ASSERT_EQUAL(56, BeaconCapture::recordSize(sizeof(IBEACON_PACKET)));
+  TEST_ASSERT_EQUAL(56, BeaconCapture::encodeRecord(observation, record));
+
+  // Little-endian fields at documented offsets
+  TEST_ASSERT_EQUAL_HEX8(0x08, record[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, record[7]);
+  TEST_ASSERT_EQUAL_HEX8(27, record[8]);
+  TEST_ASSERT_EQUAL_HEX8(0x00, record[9]);
+  TEST_ASSERT_EQUAL_HEX8(0xA1, record[10]);
+  TEST_ASSERT_EQUAL_HEX8((uint8_t)-61, record[17]);
+  TEST_ASSERT_EQUAL_HEX8(127, record[19]);
+  TEST_ASSERT_EQUAL_HEX8(0x1A, record[24]);
+  TEST_ASSERT_EQUAL_HEX8(0x00, record[55]);
+
+  ScanObservation decoded;
+  TEST_ASSERT_EQUAL(56, BeaconCapture::decodeRecord(record, sizeof(record), 24, decoded));
+  TEST_ASSERT_EQUAL_PTR(&record[24], decoded.payload);
+  TEST_ASSERT_EQUAL(27, decoded.payload_len);
+  TEST_ASSERT_TRUE(decoded.timestamp_us == observation.timestamp_us);
+  TEST_ASSERT_EQUAL_MEMORY(address, decoded.address, 6);
+  TEST_ASSERT_EQUAL(-61, decoded.rssi);
+  TEST_ASSERT_EQUAL(38, decoded.channel);
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_UNAVAILABLE, decoded.tx_power);
+  TEST_ASSERT_EQUAL(observation.flags, decoded.flags);
+
+  // Incomplete records are rejected
+  TEST_ASSERT_EQUAL(0, BeaconCapture::decodeRecord(record, 40, 24, decoded));
+
+  uint8_t header[BEACON_CAPTURE_FILE_HEADER_SIZE];
+  BeaconCapture::encodeFileHeader(header);
+  TEST_ASSERT_EQUAL_MEMORY("BBCP", header, 4);
+  TEST_ASSERT_EQUAL(24, BeaconCapture::checkFileHeader(header, sizeof(header)));
+  header[4] = 2;
+  TEST_ASSERT_EQUAL(0, BeaconCapture::checkFileHeader(header, sizeof(header)));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <unistd.h>
+
+void test_capture_file_replay() {
+  char path[] = "/tmp/beacon_capture_XXXXXX";
+  int fd = mkstemp(path);
+  TEST_ASSERT_TRUE(fd >= 0);
+  close(fd);
+
+  // Two sessions append to the same capture
+  ScanObservation observation;
+  observation.payload = IBEACON_PACKET;
+  observation.payload_len = sizeof(IBEACON_PACKET);
+  for (uint8_t session = 0; session < 2; session++) {
+    BeaconCaptureWriter writer;
+    TEST_ASSERT_TRUE(writer.open(path));
+    for (uint16_t i = 0; i < 50; i++) {
+      observation.timestamp_us = session * 1000 + i;
+      observation.rssi = -(int8_t)(i % 100);
+      TEST_ASSERT_TRUE(writer.write(observation));
+    }
+
+    // An oversized record goes out in pieces
+    static uint8_t extended[1000];
+    memset(extended, 0x5A, sizeof(extended));
+    ScanObservation large;
+    large.payload = extended;
+    large.payload_len = sizeof(extended);
+    TEST_ASSERT_TRUE(writer.write(large));
+    TEST_ASSERT_EQUAL(51, writer.records());
+  }
+
+  BeaconCaptureReader reader;
+  TEST_ASSERT_TRUE(reader.open(path));
+  TEST_ASSERT_EQUAL(16 + 2 * (50 * 56 + 1024), reader.size());
+
+  BLEBeaconParser parser;
+  BeaconData result;
+  uint16_t records = 0;
+  uint16_t beacons = 0;
+  while (reader.next(observation)) {
+    if (observation.payload_len == 1000) {
+      TEST_ASSERT_EQUAL_HEX8(0x5A, observation.payload[999]);
+    } else if (parser.parse(observation, result)) {
+      TEST_ASSERT_EQUAL(0x0102, result.ibeacon.major);
+      beacons++;
+    }
+    records++;
+  }
+  TEST_ASSERT_EQUAL(102, records);
+  TEST_ASSERT_EQUAL(100, beacons);
+  TEST_ASSERT_FALSE(reader.truncated());
+  TEST_ASSERT_EQUAL(reader.size(), reader.position());
+
+  reader.rewind();
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_TRUE(observation.timestamp_us == 0);
+  reader.close();
+
+  // A torn final record ends the replay early
+  TEST_ASSERT_EQUAL(0, truncate(path, 16 + 56 + 30));
+  TEST_ASSERT_TRUE(reader.open(path));
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_FALSE(reader.next(observation));
+  TEST_ASSERT_TRUE(reader.truncated());
+
+  // Writers refuse to append after it
+  BeaconCaptureWriter writer;
+  TEST_ASSERT_FALSE(writer.open(path));
+
+  // Also when the cut leaves an aligned size (here, right after a record header)
+  TEST_ASSERT_EQUAL(0, truncate(path, 16 + 56 + 24));
+  TEST_ASSERT_FALSE(writer.open(path));
+
+  // Cut back to the last complete record, appending works again
+  TEST_ASSERT_EQUAL(0, truncate(path, 16 + 56));
+  TEST_ASSERT_TRUE(writer.open(path));
+  TEST_ASSERT_TRUE(writer.write(observation));
+  writer.close();
+  TEST_ASSERT_TRUE(reader.open(path));
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_FALSE(reader.next(observation));
+  TEST_ASSERT_FALSE(reader.truncated());
+  unlink(path);
+}
+
+#endif
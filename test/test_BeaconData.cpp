@@ -0,0 +1,48 @@
+#include <string.h>
+#include <unity.h>
+#include <type_traits>
+#include "BLEBeaconParser.h"
+#include "BeaconData.h"
+
+static_assert(std::is_trivially_copyable<BeaconData>::value,
+              "BeaconData must be relocatable with memcpy");
+
+void test_beacon_data_memcpy_relocation() {
+  static const uint8_t packet[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                   0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                   0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+  BLEBeaconParser parser;
+  BeaconData parsed;
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), parsed));
+
+  BeaconData relocated;
+  memcpy(&relocated, &parsed, sizeof(BeaconData));
+
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, relocated.type);
+  TEST_ASSERT_TRUE(relocated.valid);
+  TEST_ASSERT_EQUAL(7, relocated.getIBeacon().major);
+  TEST_ASSERT_EQUAL(9, relocated.getIBeacon().minor);
+
+  char uuid[BEACON_UUID_STRING_SIZE];
+  relocated.getIBeacon().uuidToChars(uuid);
+  TEST_ASSERT_EQUAL_STRING("5F2DD896-B886-4549-AE01-E41ACD7A354A", uuid);
+}
+
+void test_eddystone_url_length_limit() {
+  BLEBeaconParser parser;
+  BeaconData result;
+
+  // https:// followed by 17 ".info/" codes: the longest spec-compliant URL
+  uint8_t longest[] = {0x17, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x03, 0x04, 0x04, 0x04, 0x04, 0x04,
+                       0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04};
+  TEST_ASSERT_TRUE(parser.parse(longest, sizeof(longest), result));
+  TEST_ASSERT_EQUAL(8 + 17 * 6, strlen(result.getEddystoneURL().url));
+
+  // 18 encoded bytes exceed the Eddystone-URL limit
+  uint8_t too_long[] = {0x18, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x01, 0x04, 0x04,
+                        0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+                        0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04};
+  TEST_ASSERT_FALSE(parser.parse(too_long, sizeof(too_long), result));
+  TEST_ASSERT_FALSE(result.valid);
+}
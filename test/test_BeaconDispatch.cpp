@@ -0,0 +1,64 @@
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconDispatch.h"
+#include "parsers/AltBeaconParser.h"
+#include "parsers/EddystoneParser.h"
+#include "parsers/iBeaconParser.h"
+
+void test_dispatch_lookup() {
+  BeaconDispatch dispatch;
+
+  TEST_ASSERT_TRUE(dispatch.add<iBeaconParser>());
+  TEST_ASSERT_TRUE(dispatch.add<AltBeaconParser>());
+  TEST_ASSERT_TRUE(dispatch.add<EddystoneParser>());
+  TEST_ASSERT_EQUAL(3, dispatch.size());
+
+  TEST_ASSERT_TRUE(dispatch.contains(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x004C));
+  TEST_ASSERT_TRUE(dispatch.contains(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x0118));
+  TEST_ASSERT_TRUE(dispatch.contains(AD_TYPE_SERVICE_DATA, 0xFEAA));
+
+  // Same ID under a different AD type is a different key
+  TEST_ASSERT_FALSE(dispatch.contains(AD_TYPE_SERVICE_DATA, 0x004C));
+  TEST_ASSERT_FALSE(dispatch.contains(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x0059));
+}
+
+void test_dispatch_skips_unmatched_fields() {
+  BLEBeaconParser parser;
+  BeaconData result;
+
+  // Apple manufacturer data that is not an iBeacon, followed by an Eddystone-UID frame
+  uint8_t packet[] = {0x06, 0xFF, 0x4C, 0x00, 0x10, 0x01, 0x00, 0x15, 0x16, 0xAA, 0xFE,
+                      0x00, 0xF0, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
+                      0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result));
+  TEST_ASSERT_TRUE(result.valid);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_UID, result.type);
+  TEST_ASSERT_EQUAL(-16, result.getEddystoneUID().tx_power);
+}
+
+static uint8_t attempts;
+
+static bool countAttempt(const ADField& field, BeaconData& result) {
+  (void)field;
+  (void)result;
+  attempts++;
+  return false;
+}
+
+void test_dispatch_skip_decoder() {
+  BeaconDispatch dispatch;
+  TEST_ASSERT_TRUE(dispatch.add(AD_TYPE_SERVICE_DATA, 0xFEAA, countAttempt));
+
+  uint8_t payload[] = {0x10, 0x00};
+  ADField field = {AD_TYPE_SERVICE_DATA, 0xFEAA, payload, sizeof(payload)};
+  BeaconData result;
+
+  attempts = 0;
+  TEST_ASSERT_FALSE(dispatch.decode(field, result));
+  TEST_ASSERT_EQUAL(1, attempts);
+
+  // A decoder the caller has already run is not run again
+  TEST_ASSERT_FALSE(dispatch.decode(field, result, countAttempt));
+  TEST_ASSERT_EQUAL(1, attempts);
+}
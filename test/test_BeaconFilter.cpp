@@ -0,0 +1,106 @@
+#include <string.h>
+#include <unity.h>
+#include "BeaconFilter.h"
+
+// iBeacon 5F2DD896-B886-4549-AE01-E41ACD7A354A, major 258, minor 772
+static const uint8_t IBEACON_PACKET[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                         0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                         0xCD, 0x7A, 0x35, 0x4A, 0x01, 0x02, 0x03, 0x04, 0xC5};
+
+// TLM: 3000 mV, 25.5 C, 258 advertisements, 100.0 s uptime
+static const uint8_t TLM_PACKET[] = {0x11, 0x16, 0xAA, 0xFE, 0x20, 0x00, 0x0B, 0xB8, 0x19,
+                                     0x80, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0x03, 0xE8};
+
+static bool matches(const char* expression, const uint8_t* packet, uint8_t len, int8_t rssi) {
+  BLEBeaconParser parser;
+  BeaconFilter filter(expression);
+  BeaconView view;
+  TEST_ASSERT_TRUE_MESSAGE(filter.valid(), expression);
+  return filter.match(parser, packet, len, rssi, view);
+}
+
+void test_filter_compile() {
+  BeaconFilter filter;
+  TEST_ASSERT_TRUE(filter.compile("type == ibeacon && (major in {1, 2, 3} || !(rssi < -90))"));
+  TEST_ASSERT_EQUAL(3, filter.predicateCount());
+  TEST_ASSERT_TRUE(filter.compile("uuid != 5f2dd896b8864549ae01e41acd7a354a"));
+  TEST_ASSERT_TRUE(filter.compile("namespace in {00112233445566778899} && tlm.uptime >= 0x10"));
+
+  // Unknown field
+  TEST_ASSERT_FALSE(filter.compile("type == ibeacon && color == 3"));
+  TEST_ASSERT_EQUAL(19, filter.errorOffset());
+  TEST_ASSERT_FALSE(filter.valid());
+
+  // Identities and types have no ordering
+  TEST_ASSERT_FALSE(filter.compile("type < ibeacon"));
+  TEST_ASSERT_FALSE(filter.compile("uuid > 5F2DD896-B886-4549-AE01-E41ACD7A354A"));
+
+  // Wrong identity length, bad literals and unbalanced syntax
+  TEST_ASSERT_FALSE(filter.compile("instance == 0011223344"));
+  TEST_ASSERT_FALSE(filter.compile("type == ibeacons"));
+  TEST_ASSERT_FALSE(filter.compile("major == 12abc"));
+  TEST_ASSERT_FALSE(filter.compile("(rssi > -70"));
+  TEST_ASSERT_FALSE(filter.compile("rssi > -70 &&"));
+  TEST_ASSERT_FALSE(filter.compile("major in {}"));
+  TEST_ASSERT_FALSE(filter.compile(""));
+
+  // Nesting is bounded
+  TEST_ASSERT_FALSE(filter.compile("!!!!!!!!!(rssi > 0)"));
+  TEST_ASSERT_TRUE(filter.compile("!!(rssi > 0)"));
+}
+
+void test_filter_match() {
+  static const uint8_t other[] = {0x02, 0x01, 0x06, 0x03, 0x03, 0x0F, 0x18};
+  uint8_t ibeacon_len = sizeof(IBEACON_PACKET);
+  uint8_t tlm_len = sizeof(TLM_PACKET);
+
+  const char* wanted =
+    "type == ibeacon && rssi > -75 && "
+    "uuid in {E2C56DB5-DFFB-48D2-B060-D0F5A71096E0, 5F2DD896-B886-4549-AE01-E41ACD7A354A}";
+  TEST_ASSERT_TRUE(matches(wanted, IBEACON_PACKET, ibeacon_len, -60));
+  TEST_ASSERT_FALSE(matches(wanted, IBEACON_PACKET, ibeacon_len, -80));
+  TEST_ASSERT_FALSE(matches(wanted, TLM_PACKET, tlm_len, -60));
+  TEST_ASSERT_FALSE(matches(wanted, other, sizeof(other), -60));
+
+  TEST_ASSERT_TRUE(matches("major in {1, 258} && minor == 0x304", IBEACON_PACKET, ibeacon_len, 0));
+  TEST_ASSERT_FALSE(matches("major in {1, 258} && minor != 772", IBEACON_PACKET, ibeacon_len, 0));
+  TEST_ASSERT_TRUE(matches("!(major < 258) && tx_power == -59", IBEACON_PACKET, ibeacon_len, 0));
+  TEST_ASSERT_TRUE(matches("type != altbeacon", IBEACON_PACKET, ibeacon_len, 0));
+
+  // TLM fields in expression units (mV, degrees, seconds)
+  TEST_ASSERT_FALSE(matches("type == eddystone_tlm && tlm.battery < 2600", TLM_PACKET, tlm_len, 0));
+  TEST_ASSERT_TRUE(matches("tlm.battery < 3100 && tlm.temperature > 25 && tlm.uptime == 100",
+                           TLM_PACKET, tlm_len, 0));
+  TEST_ASSERT_FALSE(matches("tlm.temperature >= 26", TLM_PACKET, tlm_len, 0));
+  TEST_ASSERT_TRUE(matches("tlm.adv_count == 258 || major == 1", TLM_PACKET, tlm_len, 0));
+
+  // Fields the beacon does not carry never match
+  TEST_ASSERT_FALSE(matches("major >= 0", TLM_PACKET, tlm_len, 0));
+  TEST_ASSERT_TRUE(matches("!(major >= 0)", TLM_PACKET, tlm_len, 0));
+
+  // A match leaves a classified view to decode
+  BLEBeaconParser parser;
+  BeaconView view;
+  BeaconFilter filter(wanted);
+  TEST_ASSERT_TRUE(filter.match(parser, IBEACON_PACKET, ibeacon_len, -60, view));
+  BeaconData result;
+  TEST_ASSERT_TRUE(view.decode(result));
+  TEST_ASSERT_EQUAL(258, result.ibeacon.major);
+
+  // Cheap checks run first: a failing RSSI or signature check returns
+  // before the packet is tokenized, so the previous view is left in place
+  TEST_ASSERT_TRUE(parser.parseView(TLM_PACKET, tlm_len, view));
+  TEST_ASSERT_FALSE(filter.match(parser, IBEACON_PACKET, ibeacon_len, -80, view));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_TLM, view.type());
+  TEST_ASSERT_FALSE(filter.match(parser, other, sizeof(other), -60, view));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_TLM, view.type());
+
+  // Observations without RSSI fail RSSI predicates
+  ScanObservation observation;
+  observation.clear();
+  observation.payload = IBEACON_PACKET;
+  observation.payload_len = ibeacon_len;
+  TEST_ASSERT_FALSE(filter.match(parser, observation, view));
+  observation.rssi = -50;
+  TEST_ASSERT_TRUE(filter.match(parser, observation, view));
+}
@@ -0,0 +1,295 @@
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconImport.h"
+
+static const uint8_t IBEACON_PACKET[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                         0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                         0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+static const uint8_t ADDRESS[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+
+// Assembles capture files in memory
+struct CaptureBytes {
+  uint8_t data[1024];
+  size_t len;
+
+  CaptureBytes() : len(0) {}
+
+  void u8(uint8_t value) {
+    data[len++] = value;
+  }
+  void le16(uint16_t value) {
+    u8(value & 0xFF);
+    u8(value >> 8);
+  }
+  void le32(uint32_t value) {
+    le16(value & 0xFFFF);
+    le16(value >> 16);
+  }
+  void be32(uint32_t value) {
+    for (uint8_t shift = 32; shift > 0; shift -= 8) {
+      u8((value >> (shift - 8)) & 0xFF);
+    }
+  }
+  void bytes(const uint8_t* values, size_t count) {
+    memcpy(&data[len], values, count);
+    len += count;
+  }
+};
+
+// LE pseudo-header on RF channel 12 (channel 38) with a valid signal of
+// -55 dBm, then a link-layer PDU on the advertising access address
+static void pushLinkLayer(CaptureBytes& out, uint32_t access_address, uint8_t header,
+                          const uint8_t* payload, uint8_t payload_len) {
+  out.u8(12);
+  out.u8((uint8_t)-55);
+  out.u8((uint8_t)-90);
+  out.u8(0);
+  out.le32(0x8E89BED6);
+  out.le16(0x0003);
+  out.le32(access_address);
+  out.u8(header);
+  out.u8(payload_len);
+  out.bytes(payload, payload_len);
+  out.u8(0xAA);  // CRC
+  out.u8(0xBB);
+  out.u8(0xCC);
+}
+
+static uint8_t legacyPdu(uint8_t* out) {
+  memcpy(out, ADDRESS, 6);
+  memcpy(&out[6], IBEACON_PACKET, sizeof(IBEACON_PACKET));
+  return 6 + sizeof(IBEACON_PACKET);
+}
+
+void test_import_pcap_link_layer() {
+  uint8_t pdu[64];
+  uint8_t pdu_len = legacyPdu(pdu);
+
+  // ADV_EXT_IND with AdvA and TxPower in the extended header
+  uint8_t extended[64];
+  extended[0] = 8;
+  extended[1] = 0x41;
+  memcpy(&extended[2], ADDRESS, 6);
+  extended[8] = (uint8_t)-4;
+  memcpy(&extended[9], IBEACON_PACKET, sizeof(IBEACON_PACKET));
+  uint8_t extended_len = 9 + sizeof(IBEACON_PACKET);
+
+  // The same frames, once as pcap and once as pcapng
+  CaptureBytes frames[4];
+  pushLinkLayer(frames[0], 0x8E89BED6, 0x42, pdu, pdu_len);            // ADV_NONCONN_IND, random
+  pushLinkLayer(frames[1], 0x50654A21, 0x01, pdu, pdu_len);            // Data channel
+  pushLinkLayer(frames[2], 0x8E89BED6, 0x03, pdu, 12);                 // SCAN_REQ
+  pushLinkLayer(frames[3], 0x8E89BED6, 0x07, extended, extended_len);  // ADV_EXT_IND
+
+  CaptureBytes pcap;
+  pcap.le32(0xA1B2C3D4);
+  pcap.le16(2);
+  pcap.le16(4);
+  pcap.le32(0);
+  pcap.le32(0);
+  pcap.le32(65535);
+  pcap.le32(BEACON_IMPORT_LINKTYPE_LE_LL_WITH_PHDR);
+  for (uint8_t i = 0; i < 4; i++) {
+    pcap.le32(1700000000);
+    pcap.le32(250000 + i);
+    pcap.le32(frames[i].len);
+    pcap.le32(frames[i].len);
+    pcap.bytes(frames[i].data, frames[i].len);
+  }
+
+  CaptureBytes pcapng;
+  pcapng.le32(0x0A0D0D0A);
+  pcapng.le32(28);
+  pcapng.le32(0x1A2B3C4D);
+  pcapng.le16(1);
+  pcapng.le16(0);
+  pcapng.le32(0xFFFFFFFF);
+  pcapng.le32(0xFFFFFFFF);
+  pcapng.le32(28);
+  pcapng.le32(1);  // Interface with nanosecond timestamps
+  pcapng.le32(28);
+  pcapng.le16(BEACON_IMPORT_LINKTYPE_LE_LL_WITH_PHDR);
+  pcapng.le16(0);
+  pcapng.le32(0);
+  pcapng.le16(9);
+  pcapng.le16(1);
+  pcapng.le32(9);
+  pcapng.le32(28);
+  for (uint8_t i = 0; i < 4; i++) {
+    uint32_t padded = (frames[i].len + 3) & ~3;
+    uint64_t time = 1700000000250000000ULL + i * 1000;
+    pcapng.le32(6);
+    pcapng.le32(32 + padded);
+    pcapng.le32(0);
+    pcapng.le32((uint32_t)(time >> 32));
+    pcapng.le32((uint32_t)time);
+    pcapng.le32(frames[i].len);
+    pcapng.le32(frames[i].len);
+    pcapng.bytes(frames[i].data, frames[i].len);
+    while (pcapng.len % 4 != 0) {
+      pcapng.u8(0);
+    }
+    pcapng.le32(32 + padded);
+  }
+
+  BLEBeaconParser parser;
+  BeaconData result;
+  ScanObservation observation;
+  BeaconImportReader reader;
+  const CaptureBytes* files[2] = {&pcap, &pcapng};
+
+  for (uint8_t file = 0; file < 2; file++) {
+    TEST_ASSERT_TRUE(reader.open(files[file]->data, files[file]->len));
+    TEST_ASSERT_EQUAL(file == 0 ? BEACON_IMPORT_PCAP : BEACON_IMPORT_PCAPNG, reader.format());
+    TEST_ASSERT_EQUAL(BEACON_IMPORT_LINKTYPE_LE_LL_WITH_PHDR, reader.linkType());
+
+    TEST_ASSERT_TRUE(reader.next(observation));
+    TEST_ASSERT_TRUE(observation.payload > files[file]->data &&
+                     observation.payload < &files[file]->data[files[file]->len]);
+    TEST_ASSERT_EQUAL(sizeof(IBEACON_PACKET), observation.payload_len);
+    TEST_ASSERT_EQUAL_MEMORY(IBEACON_PACKET, observation.payload, sizeof(IBEACON_PACKET));
+    TEST_ASSERT_EQUAL_MEMORY(ADDRESS, observation.address, 6);
+    TEST_ASSERT_EQUAL(1, observation.address_type);
+    TEST_ASSERT_EQUAL(38, observation.channel);
+    TEST_ASSERT_EQUAL(-55, observation.rssi);
+    TEST_ASSERT_EQUAL(SCAN_OBSERVATION_LEGACY, observation.flags);
+    TEST_ASSERT_TRUE(observation.timestamp_us == 1700000000250000ULL);
+    TEST_ASSERT_TRUE(parser.parse(observation, result));
+    TEST_ASSERT_EQUAL(7, result.ibeacon.major);
+
+    // Data channel and scan request frames are skipped
+    TEST_ASSERT_TRUE(reader.next(observation));
+    TEST_ASSERT_EQUAL(4, reader.frames());
+    TEST_ASSERT_EQUAL(0, observation.flags);
+    TEST_ASSERT_EQUAL(-4, observation.tx_power);
+    TEST_ASSERT_EQUAL_MEMORY(ADDRESS, observation.address, 6);
+    TEST_ASSERT_TRUE(observation.timestamp_us == 1700000000250003ULL);
+    TEST_ASSERT_TRUE(parser.parse(observation, result));
+
+    TEST_ASSERT_FALSE(reader.next(observation));
+    TEST_ASSERT_FALSE(reader.truncated());
+    TEST_ASSERT_EQUAL(reader.size(), reader.position());
+
+    reader.rewind();
+    TEST_ASSERT_TRUE(reader.next(observation));
+    TEST_ASSERT_EQUAL(1, reader.frames());
+  }
+
+  // A capture cut inside a record
+  TEST_ASSERT_TRUE(reader.open(pcap.data, pcap.len - 5));
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_FALSE(reader.next(observation));
+  TEST_ASSERT_TRUE(reader.truncated());
+
+  uint8_t junk[32] = {0};
+  TEST_ASSERT_FALSE(reader.open(junk, sizeof(junk)));
+}
+
+// First report's data length: file header, command record, record header,
+// then H4 type, event code, parameter length, subevent, count, event type,
+// address type, address
+#define BEACON_TEST_BTSNOOP_LEGACY_DATA_LEN (16 + 24 + 6 + 24 + 13)
+
+void test_import_btsnoop_reports() {
+  CaptureBytes log;
+  log.bytes((const uint8_t*)"btsnoop", 8);
+  log.be32(1);
+  log.be32(BEACON_IMPORT_BTSNOOP_H4);
+
+  // Command (skipped), then a legacy report event with two reports, then
+  // an extended report event
+  static const uint8_t command[] = {0x01, 0x0C, 0x20, 0x02, 0x01, 0x00};
+  uint8_t legacy[128];
+  uint8_t pos = 0;
+  legacy[pos++] = 0x04;
+  legacy[pos++] = 0x3E;
+  legacy[pos++] = 0;  // Parameter length, filled in below
+  legacy[pos++] = 0x02;
+  legacy[pos++] = 2;
+  for (uint8_t i = 0; i < 2; i++) {
+    legacy[pos++] = i == 0 ? 0x03 : 0x04;  // ADV_NONCONN_IND, SCAN_RSP
+    legacy[pos++] = 0x01;
+    memcpy(&legacy[pos], ADDRESS, 6);
+    legacy[pos + 5] += i;
+    pos += 6;
+    uint8_t data_len = i == 0 ? sizeof(IBEACON_PACKET) : 3;
+    legacy[pos++] = data_len;
+    memcpy(&legacy[pos], IBEACON_PACKET, data_len);
+    pos += data_len;
+    legacy[pos++] = (uint8_t)(-60 - i);
+  }
+  legacy[2] = pos - 3;
+
+  uint8_t extended[64];
+  uint8_t extended_len = 0;
+  extended[extended_len++] = 0x04;
+  extended[extended_len++] = 0x3E;
+  extended[extended_len++] = 2 + 24 + sizeof(IBEACON_PACKET);
+  extended[extended_len++] = 0x0D;
+  extended[extended_len++] = 1;
+  memset(&extended[extended_len], 0, 24);
+  extended[extended_len] = 0x01;  // Connectable, not legacy
+  memcpy(&extended[extended_len + 3], ADDRESS, 6);
+  extended[extended_len + 12] = 0;
+  extended[extended_len + 13] = (uint8_t)-70;
+  extended[extended_len + 23] = sizeof(IBEACON_PACKET);
+  extended_len += 24;
+  memcpy(&extended[extended_len], IBEACON_PACKET, sizeof(IBEACON_PACKET));
+  extended_len += sizeof(IBEACON_PACKET);
+
+  const uint8_t* packets[3] = {command, legacy, extended};
+  uint8_t lengths[3] = {sizeof(command), pos, extended_len};
+  for (uint8_t i = 0; i < 3; i++) {
+    // 2023-11-14 22:13:20 UTC plus i seconds
+    uint64_t time = 0x00DCDDB30F2F8000ULL + (1700000000ULL + i) * 1000000;
+    log.be32(lengths[i]);
+    log.be32(lengths[i]);
+    log.be32(i == 0 ? 0x02 : 0x03);
+    log.be32(0);
+    log.be32((uint32_t)(time >> 32));
+    log.be32((uint32_t)time);
+    log.bytes(packets[i], lengths[i]);
+  }
+
+  BeaconImportReader reader;
+  TEST_ASSERT_TRUE(reader.open(log.data, log.len));
+  TEST_ASSERT_EQUAL(BEACON_IMPORT_BTSNOOP, reader.format());
+
+  BLEBeaconParser parser;
+  BeaconData result;
+  ScanObservation observation;
+
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_EQUAL(2, reader.frames());
+  TEST_ASSERT_EQUAL_MEMORY(ADDRESS, observation.address, 6);
+  TEST_ASSERT_EQUAL(1, observation.address_type);
+  TEST_ASSERT_EQUAL(-60, observation.rssi);
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_LEGACY, observation.flags);
+  TEST_ASSERT_TRUE(observation.timestamp_us == 1700000001000000ULL);
+  TEST_ASSERT_TRUE(parser.parse(observation, result));
+
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_EQUAL(0x67, observation.address[5]);
+  TEST_ASSERT_EQUAL(3, observation.payload_len);
+  TEST_ASSERT_EQUAL(-61, observation.rssi);
+  TEST_ASSERT_TRUE(observation.flags & SCAN_OBSERVATION_SCAN_RESPONSE);
+
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_CONNECTABLE, observation.flags);
+  TEST_ASSERT_EQUAL(-70, observation.rssi);
+  TEST_ASSERT_EQUAL(0, observation.tx_power);
+  TEST_ASSERT_TRUE(parser.parse(observation, result));
+  TEST_ASSERT_EQUAL(9, result.ibeacon.minor);
+
+  TEST_ASSERT_FALSE(reader.next(observation));
+  TEST_ASSERT_EQUAL(3, reader.frames());
+  TEST_ASSERT_FALSE(reader.truncated());
+
+  // A report claiming more data than its event holds ends the event
+  log.data[BEACON_TEST_BTSNOOP_LEGACY_DATA_LEN] = 200;
+  TEST_ASSERT_TRUE(reader.open(log.data, log.len));
+  TEST_ASSERT_TRUE(reader.next(observation));
+  TEST_ASSERT_EQUAL(3, reader.frames());
+}
@@ -0,0 +1,57 @@
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconHash.h"
+#include "BeaconKey.h"
+
+void test_hash_matches_scalar() {
+  // Standard CRC32C check value
+  TEST_ASSERT_EQUAL_HEX32(0xE3069283, BeaconHash::crc32c((const uint8_t*)"123456789", 9));
+
+  uint8_t data[64];
+  uint32_t state = 12345;
+  for (uint8_t i = 0; i < sizeof(data); i++) {
+    state = state * 1103515245u + 12345u;
+    data[i] = state >> 16;
+  }
+
+  // Selected implementation agrees with the software path for every length
+  for (uint16_t len = 0; len <= sizeof(data); len++) {
+    uint64_t expected = BeaconHash::hash64Scalar(data, len, len);
+    TEST_ASSERT_TRUE(BeaconHash::hash64(data, len, len) == expected);
+  }
+  TEST_ASSERT_TRUE(BeaconHash::hash64(data, 20, 1) != BeaconHash::hash64(data, 20, 2));
+}
+
+void test_beacon_key_identity() {
+  uint8_t packet[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                      0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                      0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+  BLEBeaconParser parser;
+  BeaconData result;
+  BeaconKey key;
+
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result, key));
+  TEST_ASSERT_TRUE(key.valid());
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, key.type);
+  TEST_ASSERT_EQUAL(20, key.len);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(&packet[6], key.bytes, 20);
+
+  // The lazy view builds the same key
+  BeaconView view;
+  TEST_ASSERT_TRUE(parser.parseView(packet, sizeof(packet), view));
+  TEST_ASSERT_TRUE(view.key() == key);
+
+  // Same UUID and major with a different minor is a different beacon
+  packet[25] = 0x0A;
+  BeaconKey other;
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result, other));
+  TEST_ASSERT_TRUE(other != key);
+  TEST_ASSERT_TRUE(other.hash != key.hash);
+
+  // Formats without identity fields give an empty key
+  uint8_t url[] = {0x0D, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x01,
+                   0x67, 0x6F, 0x6F, 0x67, 0x6C, 0x65, 0x00};
+  TEST_ASSERT_TRUE(parser.parse(url, sizeof(url), result, key));
+  TEST_ASSERT_FALSE(key.valid());
+}
@@ -0,0 +1,58 @@
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconLayout.h"
+
+void test_layout_compile() {
+  BeaconLayout layout;
+
+  TEST_ASSERT_TRUE(layout.compile("m:2-3=beac,i:4-19,i:20-21,i:22-23,p:24-24,d:25-25", 0x0118));
+  TEST_ASSERT_EQUAL(AD_TYPE_MANUFACTURER_SPECIFIC_DATA, layout.adType());
+  TEST_ASSERT_EQUAL(0x0118, layout.id());
+  TEST_ASSERT_EQUAL(24, layout.minLength());
+
+  BeaconSignature signature = layout.signature();
+  TEST_ASSERT_EQUAL(2, signature.prefix_len);
+  TEST_ASSERT_EQUAL(0xBE, signature.prefix[0]);
+  TEST_ASSERT_EQUAL(0xAC, signature.prefix[1]);
+
+  // Service data layouts take their key from the s term
+  TEST_ASSERT_TRUE(layout.compile("s:0-1=feaa,m:2-2=00,p:3-3,i:4-13,i:14-19"));
+  TEST_ASSERT_EQUAL(AD_TYPE_SERVICE_DATA, layout.adType());
+  TEST_ASSERT_EQUAL(0xFEAA, layout.id());
+
+  // Syntax errors and unsupported terms
+  TEST_ASSERT_FALSE(layout.compile("m:2-3=be"));        // Matcher shorter than its range
+  TEST_ASSERT_FALSE(layout.compile("i:4-19,x:20-20"));  // Unknown kind
+  TEST_ASSERT_FALSE(layout.compile("i:0-1"));           // Overlaps the ID
+  TEST_ASSERT_FALSE(layout.compile("p:4-5"));           // Power is one byte
+  TEST_ASSERT_FALSE(layout.compile("i:5-4"));           // Reversed range
+  TEST_ASSERT_FALSE(layout.compile("i:4-19;i:20-21"));  // Bad separator
+  TEST_ASSERT_FALSE(layout.valid());
+}
+
+void test_layout_extract() {
+  // Prefix 0xC0 0xDE, 4-byte ID, little-endian 16-bit reading, power
+  BeaconLayout layout("m:2-3=c0de,i:4-7,d:8-9l,p:10-10", 0x0059);
+  TEST_ASSERT_TRUE(layout.valid());
+
+  const uint8_t payload[] = {0xC0, 0xDE, 0x01, 0x02, 0x03, 0x04, 0x2C, 0x01, 0xC5};
+  ADField field = {AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x0059, payload, sizeof(payload)};
+
+  BeaconLayoutValues values;
+  TEST_ASSERT_TRUE(layout.extract(field, values));
+  TEST_ASSERT_EQUAL(1, values.identifier_count);
+  TEST_ASSERT_EQUAL(0x01020304, values.identifiers[0].value);
+  TEST_ASSERT_EQUAL_PTR(&payload[2], values.identifiers[0].bytes);
+  TEST_ASSERT_EQUAL(1, values.data_count);
+  TEST_ASSERT_EQUAL(300, values.data[0].value);
+  TEST_ASSERT_EQUAL(-59, values.power);
+
+  // Too short or wrong matcher
+  field.len = sizeof(payload) - 1;
+  TEST_ASSERT_FALSE(layout.extract(field, values));
+  field.len = sizeof(payload);
+  const uint8_t other[] = {0xC0, 0xDF, 0x01, 0x02, 0x03, 0x04, 0x2C, 0x01, 0xC5};
+  field.data = other;
+  TEST_ASSERT_FALSE(layout.matches(field));
+}
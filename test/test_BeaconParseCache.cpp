@@ -0,0 +1,103 @@
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconParseCache.h"
+
+static const uint8_t IBEACON_PACKET[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                         0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                         0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+void test_parse_cache_hits() {
+  static BeaconParseCacheBuffer<16> cache;
+  cache.clear();
+
+  BLEBeaconParser parser;
+  parser.setCache(&cache);
+  BeaconData result;
+
+  TEST_ASSERT_TRUE(parser.parse(IBEACON_PACKET, sizeof(IBEACON_PACKET), result));
+  TEST_ASSERT_EQUAL(0, cache.hits());
+  TEST_ASSERT_EQUAL(1, cache.misses());
+
+  // Identical bytes in a different buffer are served from the cache
+  uint8_t copy[sizeof(IBEACON_PACKET)];
+  memcpy(copy, IBEACON_PACKET, sizeof(copy));
+  TEST_ASSERT_TRUE(parser.parse(copy, sizeof(copy), result));
+  TEST_ASSERT_EQUAL(1, cache.hits());
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL(7, result.getIBeacon().major);
+
+  // A view from the cache points into the caller's buffer
+  BeaconView view;
+  TEST_ASSERT_TRUE(parser.parseView(copy, sizeof(copy), view));
+  TEST_ASSERT_EQUAL(2, cache.hits());
+  TEST_ASSERT_EQUAL_PTR(&copy[6], view.uuidBytes());
+  TEST_ASSERT_EQUAL(9, view.minor());
+
+  // Non-beacon packets are cached as failures
+  static const uint8_t flags[] = {0x02, 0x01, 0x06};
+  TEST_ASSERT_FALSE(parser.parse(flags, sizeof(flags), result));
+  TEST_ASSERT_FALSE(parser.parse(flags, sizeof(flags), result));
+  TEST_ASSERT_FALSE(result.valid);
+  TEST_ASSERT_EQUAL(3, cache.hits());
+
+  // A changed byte misses
+  copy[25] = 0x0A;
+  TEST_ASSERT_TRUE(parser.parse(copy, sizeof(copy), result));
+  TEST_ASSERT_EQUAL(10, result.getIBeacon().minor);
+  TEST_ASSERT_EQUAL(3, cache.misses());
+}
+
+void test_parse_cache_eviction() {
+  static BeaconParseCacheBuffer<4> cache;
+  cache.clear();
+
+  BLEBeaconParser parser;
+  parser.setCache(&cache);
+  BeaconData result;
+
+  // More distinct packets than slots: every one still parses correctly
+  uint8_t packet[sizeof(IBEACON_PACKET)];
+  memcpy(packet, IBEACON_PACKET, sizeof(packet));
+  for (uint8_t minor = 0; minor < 12; minor++) {
+    packet[25] = minor;
+    TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result));
+    TEST_ASSERT_EQUAL(minor, result.getIBeacon().minor);
+  }
+  TEST_ASSERT_EQUAL(12, cache.misses());
+  TEST_ASSERT_EQUAL(8, cache.evictions());
+
+  // The most recent packet is still cached
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result));
+  TEST_ASSERT_EQUAL(1, cache.hits());
+  TEST_ASSERT_EQUAL(11, result.getIBeacon().minor);
+}
+
+void test_parse_cache_clock_hand() {
+  static BeaconParseCacheBuffer<4> cache;
+  cache.clear();
+
+  // Six packets sharing one home slot and window
+  uint8_t packets[6][1];
+  for (uint8_t i = 0; i < 6; i++) {
+    packets[i][0] = i;
+  }
+  for (uint8_t i = 0; i < 4; i++) {
+    TEST_ASSERT_NOT_NULL(cache.insert(packets[i], 1, 0));
+  }
+  TEST_ASSERT_NOT_NULL(cache.lookup(packets[0], 1, 0));
+  TEST_ASSERT_NOT_NULL(cache.lookup(packets[1], 1, 0));
+
+  // The hand clears 0 and 1 and evicts 2
+  TEST_ASSERT_NOT_NULL(cache.insert(packets[4], 1, 0));
+  TEST_ASSERT_NULL(cache.lookup(packets[2], 1, 0));
+
+  // It resumes after 2 rather than starting over, so 3 goes next and the
+  // recently used 0 and 1 stay
+  TEST_ASSERT_NOT_NULL(cache.lookup(packets[0], 1, 0));
+  TEST_ASSERT_NOT_NULL(cache.insert(packets[5], 1, 0));
+  TEST_ASSERT_NULL(cache.lookup(packets[3], 1, 0));
+  TEST_ASSERT_NOT_NULL(cache.lookup(packets[0], 1, 0));
+  TEST_ASSERT_NOT_NULL(cache.lookup(packets[1], 1, 0));
+  TEST_ASSERT_EQUAL(2, cache.evictions());
+}
@@ -0,0 +1,132 @@
+#include <unity.h>
+
+#if defined(__linux__)
+
+#include <string.h>
+#include <thread>
+#include "BeaconPipeline.h"
+
+static uint32_t handled = 0;
+
+static void countBeacon(const ScanObservation& observation, const BeaconData& result,
+                        const BeaconTracker& tracker, void* context) {
+  (void)observation;
+  (void)tracker;
+  (void)context;
+  if (result.type == BEACON_TYPE_IBEACON) {
+    __atomic_fetch_add(&handled, 1, __ATOMIC_RELAXED);
+  }
+}
+
+void test_pipeline_shards_beacon_state() {
+  const uint8_t packet[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                            0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                            0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+  const uint16_t beacons = 32;
+  const uint16_t repeats = 500;
+
+  BeaconPipelineConfig config;
+  config.workers = 4;
+  config.shards = 16;
+  config.queue_slots = 16384;
+  config.pin_threads = false;
+  config.handler = countBeacon;
+  BeaconPipeline pipeline(config);
+  TEST_ASSERT_EQUAL(16, pipeline.shardCount());
+  TEST_ASSERT_TRUE(pipeline.start());
+
+  // Two ingest threads; beacon b always advertises from address b
+  handled = 0;
+  auto ingest = [&](uint16_t first) {
+    uint8_t data[sizeof(packet)];
+    uint8_t address[6] = {0xC0, 0, 0, 0, 0, 0};
+    memcpy(data, packet, sizeof(packet));
+    for (uint16_t r = 0; r < repeats; r++) {
+      for (uint16_t b = first; b < beacons; b += 2) {
+        data[25] = (uint8_t)b;
+        address[5] = (uint8_t)b;
+        pipeline.submit(data, sizeof(data), -60, address);
+      }
+    }
+  };
+  std::thread a(ingest, 0);
+  std::thread b(ingest, 1);
+  a.join();
+  b.join();
+  pipeline.stop();
+
+  TEST_ASSERT_EQUAL(0, pipeline.dropped());
+  TEST_ASSERT_EQUAL(beacons * repeats, pipeline.processed());
+  TEST_ASSERT_EQUAL(beacons * repeats, handled);
+
+  // Each beacon's state lives, complete, in exactly one shard
+  uint16_t tracked = 0;
+  BeaconTrackInfo info;
+  for (uint16_t s = 0; s < pipeline.shardCount(); s++) {
+    const BeaconTracker& tracker = pipeline.tracker(s);
+    for (uint16_t i = 0; i < tracker.capacity(); i++) {
+      if (tracker.entryAt(i, info)) {
+        TEST_ASSERT_EQUAL(repeats, info.packet_count);
+        tracked++;
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL(beacons, tracked);
+
+  // Oversized reports are rejected
+  uint8_t big[BEACON_PIPELINE_DATA_SIZE + 1] = {0};
+  TEST_ASSERT_FALSE(pipeline.submit(big, sizeof(big), -60, nullptr));
+  TEST_ASSERT_EQUAL(1, pipeline.dropped());
+}
+
+static uint16_t handled_len = 0;
+
+static void recordLength(const ScanObservation& observation, const BeaconData& result,
+                         const BeaconTracker& tracker, void* context) {
+  (void)result;
+  (void)tracker;
+  (void)context;
+  handled_len = observation.payload_len;
+}
+
+void test_pipeline_extended_payload() {
+  // A full HCI extended report's data: a 195-byte name, then an iBeacon
+  uint8_t payload[BEACON_PIPELINE_DATA_SIZE];
+  memset(payload, 'n', sizeof(payload));
+  payload[0] = 0xC1;
+  payload[1] = 0x09;
+  const uint8_t packet[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                            0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                            0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+  memcpy(&payload[0xC2], packet, sizeof(packet));
+  payload[0xC2 + sizeof(packet)] = 0;  // Padding after the last structure
+  TEST_ASSERT_EQUAL(sizeof(payload), 0xC2 + sizeof(packet) + 8);
+
+  BeaconPipelineConfig config;
+  config.workers = 1;
+  config.shards = 1;
+  config.queue_slots = 4;
+  config.pin_threads = false;
+  config.handler = recordLength;
+  BeaconPipeline pipeline(config);
+  TEST_ASSERT_TRUE(pipeline.start());
+
+  uint8_t address[6] = {0xC0, 1, 2, 3, 4, 5};
+  handled_len = 0;
+  TEST_ASSERT_TRUE(pipeline.submit(payload, sizeof(payload), -60, address));
+  pipeline.stop();
+
+  TEST_ASSERT_EQUAL(0, pipeline.dropped());
+  TEST_ASSERT_EQUAL(1, pipeline.processed());
+  TEST_ASSERT_EQUAL(sizeof(payload), handled_len);
+
+  BeaconTrackInfo info;
+  uint16_t tracked = 0;
+  const BeaconTracker& tracker = pipeline.tracker(0);
+  for (uint16_t i = 0; i < tracker.capacity(); i++) {
+    tracked += tracker.entryAt(i, info) ? 1 : 0;
+  }
+  TEST_ASSERT_EQUAL(1, tracked);
+}
+
+#endif  // __linux__
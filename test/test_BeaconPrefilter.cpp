@@ -0,0 +1,53 @@
+#include <stdlib.h>
+#include <unity.h>
+#include "BeaconPrefilter.h"
+
+void test_prefilter_signatures() {
+  uint8_t ibeacon[] = {0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15};
+  uint8_t altbeacon[] = {0x1B, 0xFF, 0x18, 0x01, 0xBE, 0xAC};
+  uint8_t eddystone[] = {0x03, 0x03, 0xAA, 0xFE, 0x15, 0x16, 0xAA, 0xFE};
+  uint8_t noise[] = {0x02, 0x01, 0x06, 0x05, 0xFF, 0x4C, 0x00, 0x10, 0x05};
+
+  TEST_ASSERT_EQUAL(BEACON_CANDIDATE_IBEACON, BeaconPrefilter::scan(ibeacon, sizeof(ibeacon)));
+  TEST_ASSERT_EQUAL(BEACON_CANDIDATE_ALTBEACON,
+                    BeaconPrefilter::scan(altbeacon, sizeof(altbeacon)));
+  TEST_ASSERT_EQUAL(BEACON_CANDIDATE_EDDYSTONE,
+                    BeaconPrefilter::scan(eddystone, sizeof(eddystone)));
+  TEST_ASSERT_EQUAL(0, BeaconPrefilter::scan(noise, sizeof(noise)));
+
+  // Signature cut off by the end of the packet is not a candidate
+  TEST_ASSERT_EQUAL(0, BeaconPrefilter::scan(ibeacon, sizeof(ibeacon) - 1));
+
+  AdvPacket packets[] = {{ibeacon, sizeof(ibeacon)}, {noise, sizeof(noise)}, {nullptr, 0}};
+  uint8_t masks[3];
+  TEST_ASSERT_EQUAL(1, BeaconPrefilter::scanBatch(packets, 3, masks));
+  TEST_ASSERT_EQUAL(BEACON_CANDIDATE_IBEACON, masks[0]);
+  TEST_ASSERT_EQUAL(0, masks[1]);
+  TEST_ASSERT_EQUAL(0, masks[2]);
+}
+
+void test_prefilter_matches_scalar() {
+  static const uint8_t signatures[][5] = {
+    {0xFF, 0x4C, 0x00, 0x02, 0x15}, {0xFF, 0x18, 0x01, 0xBE, 0xAC}, {0x16, 0xAA, 0xFE, 0, 0}};
+  static const uint8_t signature_lengths[] = {5, 5, 3};
+
+  uint8_t packet[1650];
+  srand(1234);
+
+  // Random packets of every length up to the extended advertising limit,
+  // with signatures planted at random positions, including across vector
+  // and 255-byte block boundaries
+  for (int iteration = 0; iteration < 2000; iteration++) {
+    uint16_t len = 3 + rand() % (iteration % 2 == 0 ? 253 : 1648);
+    for (uint16_t i = 0; i < len; i++) {
+      packet[i] = (uint8_t)(rand() % 4 == 0 ? 0xFF : rand());
+    }
+    int which = rand() % 4;
+    if (which < 3 && len >= signature_lengths[which]) {
+      uint16_t pos = rand() % (len - signature_lengths[which] + 1);
+      memcpy(&packet[pos], signatures[which], signature_lengths[which]);
+    }
+
+    TEST_ASSERT_EQUAL(BeaconPrefilter::scanScalar(packet, len), BeaconPrefilter::scan(packet, len));
+  }
+}
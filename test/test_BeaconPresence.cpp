@@ -0,0 +1,165 @@
+#include <unity.h>
+#include "BeaconPresence.h"
+
+#define MAX_EVENTS 16
+
+struct EventLog {
+  BeaconPresenceEvent events[MAX_EVENTS];
+  uint8_t count;
+};
+
+static void logEvent(const BeaconPresenceEvent& event, void* context) {
+  EventLog* log = (EventLog*)context;
+  if (log->count < MAX_EVENTS) {
+    log->events[log->count++] = event;
+  }
+}
+
+static BeaconKey makeKey(uint8_t n) {
+  uint8_t identity[16] = {0};
+  identity[15] = n;
+
+  BeaconKey key;
+  key.set(BEACON_TYPE_EDDYSTONE_UID, identity, sizeof(identity));
+  return key;
+}
+
+void test_presence_enter_exit() {
+  static BeaconPresenceBuffer<4> presence(1000, 100);
+  EventLog log;
+  log.count = 0;
+  presence.setHandler(logEvent, &log);
+  presence.setThresholds(-75, -85);
+
+  BeaconKey a = makeKey(1);
+  BeaconKey b = makeKey(2);
+
+  // Too weak to enter
+  TEST_ASSERT_FALSE(presence.update(a, -80, 0));
+  TEST_ASSERT_EQUAL(0, log.count);
+
+  TEST_ASSERT_TRUE(presence.update(a, -70, 50));
+  TEST_ASSERT_EQUAL(1, log.count);
+  TEST_ASSERT_EQUAL(BEACON_PRESENCE_ENTER, log.events[0].type);
+  TEST_ASSERT_TRUE(log.events[0].key == a);
+  TEST_ASSERT_EQUAL(50, log.events[0].time);
+  TEST_ASSERT_EQUAL(-70, log.events[0].rssi);
+
+  // Inside the hysteresis band: stays present and refreshes the timeout
+  TEST_ASSERT_TRUE(presence.update(a, -84, 100));
+  TEST_ASSERT_TRUE(presence.present(a));
+  TEST_ASSERT_EQUAL(1, log.count);
+
+  presence.advance(1099);
+  TEST_ASSERT_EQUAL(1, log.count);
+  presence.advance(1100);
+  TEST_ASSERT_EQUAL(2, log.count);
+  TEST_ASSERT_EQUAL(BEACON_PRESENCE_EXIT_TIMEOUT, log.events[1].type);
+  TEST_ASSERT_TRUE(log.events[1].key == a);
+  TEST_ASSERT_EQUAL(1100, log.events[1].time);
+  TEST_ASSERT_EQUAL(-73, log.events[1].rssi);  // (-70 * 3 + -84) / 4, smoothed
+  TEST_ASSERT_FALSE(presence.present(a));
+
+  // A single weak packet is smoothed away; a run of them exits
+  TEST_ASSERT_TRUE(presence.update(b, -60, 2000));
+  TEST_ASSERT_TRUE(presence.update(b, -100, 2100));
+  TEST_ASSERT_TRUE(presence.update(b, -100, 2200));
+  TEST_ASSERT_TRUE(presence.update(b, -100, 2300));
+  TEST_ASSERT_FALSE(presence.update(b, -100, 2400));
+  TEST_ASSERT_EQUAL(4, log.count);
+  TEST_ASSERT_EQUAL(BEACON_PRESENCE_EXIT_SIGNAL, log.events[3].type);
+  TEST_ASSERT_EQUAL(2400, log.events[3].time);
+  TEST_ASSERT_EQUAL(-87, log.events[3].rssi);
+
+  // Gone, and too weak to re-enter; no timeout fires later
+  TEST_ASSERT_FALSE(presence.update(b, -100, 2500));
+  TEST_ASSERT_EQUAL(0, presence.size());
+  presence.advance(10000);
+  TEST_ASSERT_EQUAL(4, log.count);
+}
+
+void test_presence_wheel_levels() {
+  // 6000-tick timeout: scheduled on the third wheel level and cascaded down
+  static BeaconPresenceBuffer<8> presence(600000, 100);
+  EventLog log;
+  log.count = 0;
+  presence.setHandler(logEvent, &log);
+
+  BeaconKey a = makeKey(1);
+  BeaconKey b = makeKey(2);
+  BeaconKey c = makeKey(3);
+  TEST_ASSERT_TRUE(presence.update(a, -60, 0));
+  TEST_ASSERT_TRUE(presence.update(b, -60, 50));
+  TEST_ASSERT_TRUE(presence.update(c, -60, 1000));
+  for (uint8_t n = 4; n <= 8; n++) {
+    TEST_ASSERT_TRUE(presence.update(makeKey(n), -60, 2000));
+  }
+
+  // Table holds eight beacons
+  TEST_ASSERT_FALSE(presence.update(makeKey(9), -60, 2000));
+  TEST_ASSERT_EQUAL(1, presence.overflows());
+  TEST_ASSERT_EQUAL(8, log.count);
+
+  // Refreshing moves a to a later slot
+  TEST_ASSERT_TRUE(presence.update(a, -60, 300000));
+
+  // Timeouts fire on the first tick at or after last packet + timeout
+  presence.advance(600099);
+  TEST_ASSERT_EQUAL(8, log.count);
+  presence.advance(600100);
+  TEST_ASSERT_EQUAL(9, log.count);
+  TEST_ASSERT_TRUE(log.events[8].key == b);
+  TEST_ASSERT_EQUAL(600100, log.events[8].time);
+
+  presence.advance(899999);
+  TEST_ASSERT_EQUAL(15, log.count);
+  TEST_ASSERT_TRUE(log.events[9].key == c);
+  TEST_ASSERT_EQUAL(601000, log.events[9].time);
+  TEST_ASSERT_EQUAL(602000, log.events[14].time);
+  TEST_ASSERT_TRUE(presence.present(a));
+  TEST_ASSERT_FALSE(presence.present(c));
+
+  presence.advance(900000);
+  TEST_ASSERT_EQUAL(16, log.count);
+  TEST_ASSERT_TRUE(log.events[15].key == a);
+  TEST_ASSERT_EQUAL(BEACON_PRESENCE_EXIT_TIMEOUT, log.events[15].type);
+  TEST_ASSERT_EQUAL(0, presence.size());
+
+  // Freed slots and index entries are reused
+  for (uint8_t n = 1; n <= 8; n++) {
+    TEST_ASSERT_FALSE(presence.present(makeKey(n)));
+  }
+  TEST_ASSERT_TRUE(presence.update(makeKey(9), -60, 900100));
+  TEST_ASSERT_TRUE(presence.present(makeKey(9)));
+  TEST_ASSERT_EQUAL(1, presence.size());
+}
+
+void test_presence_time_wrap() {
+  static BeaconPresenceBuffer<16> presence(1000, 100);
+  EventLog log;
+  log.count = 0;
+  presence.setHandler(logEvent, &log);
+
+  // millis() wraps 256 ms after the packet; the timeout still fires on time
+  BeaconKey a = makeKey(1);
+  uint32_t start = 0xFFFFFF00;
+  TEST_ASSERT_TRUE(presence.update(a, -60, start));
+  for (uint32_t elapsed = 100; elapsed <= 10000; elapsed += 100) {
+    presence.advance(start + elapsed);
+    if (elapsed < 1000) {
+      TEST_ASSERT_EQUAL(1, log.count);
+    }
+  }
+  TEST_ASSERT_EQUAL(2, log.count);
+  TEST_ASSERT_EQUAL(BEACON_PRESENCE_EXIT_TIMEOUT, log.events[1].type);
+  TEST_ASSERT_EQUAL(start + 1060, log.events[1].time);  // Next 100 ms tick boundary
+  TEST_ASSERT_FALSE(presence.present(a));
+
+  // Packets after the wrap keep refreshing the timeout
+  TEST_ASSERT_TRUE(presence.update(a, -60, 10000));
+  presence.advance(10900);
+  TEST_ASSERT_TRUE(presence.present(a));
+  presence.advance(11100);
+  TEST_ASSERT_FALSE(presence.present(a));
+  TEST_ASSERT_EQUAL(4, log.count);
+}
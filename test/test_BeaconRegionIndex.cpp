@@ -0,0 +1,213 @@
+#include <unity.h>
+#include "BeaconRegionIndex.h"
+
+static const uint8_t UUID_A[16] = {0x5F, 0x2D, 0xD8, 0x96, 0xB8, 0x86, 0x45, 0x49,
+                                   0xAE, 0x01, 0xE4, 0x1A, 0xCD, 0x7A, 0x35, 0x4A};
+static const uint8_t UUID_B[16] = {0xE2, 0xC5, 0x6D, 0xB5, 0xDF, 0xFB, 0x48, 0xD2,
+                                   0xB0, 0x60, 0xD0, 0xF5, 0xA7, 0x10, 0x96, 0xE0};
+
+static BeaconData makeIBeacon(const uint8_t* uuid, uint16_t major, uint16_t minor) {
+  BeaconData data;
+  data.type = BEACON_TYPE_IBEACON;
+  data.valid = true;
+  memcpy(data.ibeacon.uuid, uuid, 16);
+  data.ibeacon.major = major;
+  data.ibeacon.minor = minor;
+  return data;
+}
+
+// Matched IDs (all below 32) as a bitmask, independent of order
+static uint32_t idMask(const uint32_t* ids, uint16_t count) {
+  uint32_t mask = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    mask |= 1UL << ids[i];
+  }
+  return mask;
+}
+
+void test_region_index_lookup() {
+  static BeaconRegionIndexBuffer<16> index;
+  BeaconRegion region;
+
+  region.set(1, BEACON_TYPE_IBEACON, UUID_A, 16);
+  TEST_ASSERT_TRUE(index.add(region));
+  region.set(2, BEACON_TYPE_IBEACON, UUID_A, 16);
+  region.setMajor(100, 199);
+  TEST_ASSERT_TRUE(index.add(region));
+  region.set(3, BEACON_TYPE_IBEACON, UUID_A, 16);
+  region.setMajor(150, 160);
+  region.setMinor(5, 9);
+  TEST_ASSERT_TRUE(index.add(region));
+  region.set(4, BEACON_TYPE_IBEACON, UUID_A, 16);
+  region.setMajor(0, 10);
+  TEST_ASSERT_TRUE(index.add(region));
+  region.set(5, BEACON_TYPE_IBEACON, UUID_B, 16);
+  TEST_ASSERT_TRUE(index.add(region));
+
+  // Same bytes under another format are a separate group
+  region.set(6, BEACON_TYPE_ALTBEACON, UUID_A, 16);
+  region.setMinor(1, 1);
+  TEST_ASSERT_TRUE(index.add(region));
+
+  // Eddystone namespace-wide and namespace + instance regions
+  region.set(7, BEACON_TYPE_EDDYSTONE_UID, UUID_B, BEACON_REGION_NAMESPACE_LENGTH);
+  TEST_ASSERT_TRUE(index.add(region));
+  region.set(8, BEACON_TYPE_EDDYSTONE_UID, UUID_B, 16);
+  TEST_ASSERT_TRUE(index.add(region));
+
+  // Malformed regions are rejected
+  region.set(9, BEACON_TYPE_IBEACON, UUID_A, BEACON_REGION_NAMESPACE_LENGTH);
+  TEST_ASSERT_FALSE(index.add(region));
+  region.set(9, BEACON_TYPE_IBEACON, UUID_A, 16);
+  region.setMajor(10, 5);
+  TEST_ASSERT_FALSE(index.add(region));
+
+  uint32_t ids[8];
+  BeaconData packet = makeIBeacon(UUID_A, 155, 7);
+  TEST_ASSERT_EQUAL(0, index.match(packet, ids, 8));  // Not built yet
+  index.build();
+  TEST_ASSERT_EQUAL(8, index.size());
+  TEST_ASSERT_EQUAL(5, index.groupCount());
+
+  TEST_ASSERT_EQUAL(3, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL_HEX32((1 << 1) | (1 << 2) | (1 << 3), idMask(ids, 3));
+
+  packet = makeIBeacon(UUID_A, 155, 10);
+  TEST_ASSERT_EQUAL(2, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL_HEX32((1 << 1) | (1 << 2), idMask(ids, 2));
+
+  packet = makeIBeacon(UUID_A, 10, 0);
+  TEST_ASSERT_EQUAL(2, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL_HEX32((1 << 1) | (1 << 4), idMask(ids, 2));
+
+  packet = makeIBeacon(UUID_A, 200, 0);
+  TEST_ASSERT_EQUAL(1, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL(1, ids[0]);
+
+  // Output is capped at max_ids
+  packet = makeIBeacon(UUID_A, 155, 7);
+  TEST_ASSERT_EQUAL(2, index.match(packet, ids, 2));
+
+  packet = makeIBeacon(UUID_B, 155, 7);
+  TEST_ASSERT_EQUAL(1, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL(5, ids[0]);
+
+  packet.type = BEACON_TYPE_ALTBEACON;
+  memcpy(packet.altbeacon.id, UUID_A, 16);
+  packet.altbeacon.major = 3;
+  packet.altbeacon.minor = 1;
+  TEST_ASSERT_EQUAL(1, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL(6, ids[0]);
+
+  packet.type = BEACON_TYPE_EDDYSTONE_UID;
+  memcpy(packet.eddystone_uid.namespace_id, UUID_B, 10);
+  memcpy(packet.eddystone_uid.instance_id, &UUID_B[10], 6);
+  TEST_ASSERT_EQUAL(2, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL_HEX32((1 << 7) | (1 << 8), idMask(ids, 2));
+  packet.eddystone_uid.instance_id[5] ^= 0xFF;
+  TEST_ASSERT_EQUAL(1, index.match(packet, ids, 8));
+  TEST_ASSERT_EQUAL(7, ids[0]);
+
+  // Unknown identity
+  packet = makeIBeacon(UUID_B, 0, 0);
+  packet.ibeacon.uuid[0] ^= 0xFF;
+  TEST_ASSERT_EQUAL(0, index.match(packet, ids, 8));
+}
+
+void test_region_index_matches_linear_scan() {
+  static BeaconRegionIndexBuffer<1024> index;
+  static BeaconRegion configured[1000];
+  uint32_t state = 12345;
+
+  index.clear();
+  for (uint32_t i = 0; i < 1000; i++) {
+    // Few UUIDs, many overlapping major / minor ranges
+    uint8_t uuid[16];
+    memcpy(uuid, UUID_A, 16);
+    state = state * 1103515245 + 12345;
+    uuid[15] = (uint8_t)((state >> 16) % 4);
+
+    state = state * 1103515245 + 12345;
+    uint16_t major = (uint16_t)((state >> 16) % 200);
+    state = state * 1103515245 + 12345;
+    uint16_t major_span = (uint16_t)((state >> 16) % 40);
+    state = state * 1103515245 + 12345;
+    uint16_t minor = (uint16_t)((state >> 16) % 20);
+
+    configured[i].set(i, BEACON_TYPE_IBEACON, uuid, 16);
+    configured[i].setMajor(major, major + major_span);
+    configured[i].setMinor(minor, minor + 5);
+    TEST_ASSERT_TRUE(index.add(configured[i]));
+  }
+  index.build();
+  TEST_ASSERT_EQUAL(4, index.groupCount());
+
+  static uint32_t ids[1000];
+  for (uint16_t probe = 0; probe < 500; probe++) {
+    uint8_t uuid[16];
+    memcpy(uuid, UUID_A, 16);
+    uuid[15] = probe % 4;
+    uint16_t major = (probe * 7) % 250;
+    uint16_t minor = (probe * 3) % 30;
+    BeaconData packet = makeIBeacon(uuid, major, minor);
+
+    uint32_t expected = 0;
+    uint32_t expected_sum = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+      const BeaconRegion& region = configured[i];
+      if (region.bytes[15] == uuid[15] && major >= region.major_min &&
+          major <= region.major_max && minor >= region.minor_min && minor <= region.minor_max) {
+        expected++;
+        expected_sum += i;
+      }
+    }
+
+    uint16_t found = index.match(packet, ids, 1000);
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < found; i++) {
+      sum += ids[i];
+    }
+    TEST_ASSERT_EQUAL(expected, found);
+    TEST_ASSERT_EQUAL(expected_sum, sum);
+  }
+}
+
+void test_region_index_minor_bands() {
+  // A venue: one region for the whole UUID, then one region per minor
+  // (beacon) on major 7 and a few minor ranges on major 8
+  static BeaconRegionIndexBuffer<8192> index;
+  index.clear();
+
+  BeaconRegion region;
+  region.set(0, BEACON_TYPE_IBEACON, UUID_A, 16);
+  TEST_ASSERT_TRUE(index.add(region));
+  for (uint16_t minor = 0; minor < 4000; minor++) {
+    region.set(1000 + minor, BEACON_TYPE_IBEACON, UUID_A, 16);
+    region.setMajor(7, 7);
+    region.setMinor(minor, minor);
+    TEST_ASSERT_TRUE(index.add(region));
+  }
+  for (uint16_t floor = 0; floor < 4; floor++) {
+    region.set(100 + floor, BEACON_TYPE_IBEACON, UUID_A, 16);
+    region.setMajor(8, 8);
+    region.setMinor(floor * 1000, floor * 1000 + 999);
+    TEST_ASSERT_TRUE(index.add(region));
+  }
+  index.build();
+  TEST_ASSERT_EQUAL(1, index.groupCount());
+
+  uint32_t ids[8];
+  TEST_ASSERT_EQUAL(2, index.match(makeIBeacon(UUID_A, 7, 1234), ids, 8));
+  TEST_ASSERT_TRUE((ids[0] == 0 && ids[1] == 2234) || (ids[0] == 2234 && ids[1] == 0));
+
+  TEST_ASSERT_EQUAL(2, index.match(makeIBeacon(UUID_A, 8, 2500), ids, 8));
+  TEST_ASSERT_TRUE(ids[0] == 102 || ids[1] == 102);
+
+  // Only the whole-UUID region holds other majors and minors
+  TEST_ASSERT_EQUAL(1, index.match(makeIBeacon(UUID_A, 7, 4000), ids, 8));
+  TEST_ASSERT_EQUAL(0, ids[0]);
+  TEST_ASSERT_EQUAL(1, index.match(makeIBeacon(UUID_A, 9, 0), ids, 8));
+
+  // Output is capped
+  TEST_ASSERT_EQUAL(1, index.match(makeIBeacon(UUID_A, 7, 5), ids, 1));
+}
@@ -0,0 +1,108 @@
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconTracker.h"
+
+static BeaconKey makeKey(uint16_t n) {
+  uint8_t identity[20] = {0};
+  identity[18] = n >> 8;
+  identity[19] = n & 0xFF;
+
+  BeaconKey key;
+  key.set(BEACON_TYPE_IBEACON, identity, sizeof(identity));
+  return key;
+}
+
+void test_tracker_updates() {
+  uint8_t packet[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                      0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                      0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+  static BeaconTrackerBuffer<16> tracker;
+  tracker.clear();
+
+  BLEBeaconParser parser;
+  BeaconData result;
+  BeaconKey key;
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result, key));
+
+  TEST_ASSERT_TRUE(tracker.update(result, -70, 1000));
+  TEST_ASSERT_TRUE(tracker.update(key, result, -65, 1500));
+  TEST_ASSERT_EQUAL(1, tracker.size());
+
+  BeaconTrackInfo info;
+  TEST_ASSERT_TRUE(tracker.find(key, info));
+  TEST_ASSERT_TRUE(info.key == key);
+  TEST_ASSERT_EQUAL(1000, info.first_seen);
+  TEST_ASSERT_EQUAL(1500, info.last_seen);
+  TEST_ASSERT_EQUAL(2, info.packet_count);
+  TEST_ASSERT_EQUAL(-65, info.last_rssi);
+  TEST_ASSERT_FALSE(info.has_tlm);
+
+  // TLM frames have no identity of their own but attach to a given key
+  BeaconData tlm;
+  tlm.type = BEACON_TYPE_EDDYSTONE_TLM;
+  tlm.valid = true;
+  tlm.eddystone_tlm.battery_voltage = 3000;
+  tlm.eddystone_tlm.temperature = 21.5f;
+  tlm.eddystone_tlm.adv_count = 42;
+  tlm.eddystone_tlm.uptime = 600;
+  TEST_ASSERT_FALSE(tracker.update(tlm, -60, 2000));
+  TEST_ASSERT_TRUE(tracker.update(key, tlm, -60, 2000));
+
+  TEST_ASSERT_TRUE(tracker.find(key, info));
+  TEST_ASSERT_TRUE(info.has_tlm);
+  TEST_ASSERT_EQUAL(2000, info.tlm_seen);
+  TEST_ASSERT_EQUAL(3000, info.tlm.battery_voltage);
+  TEST_ASSERT_EQUAL(42, info.tlm.adv_count);
+  TEST_ASSERT_EQUAL(3, info.packet_count);
+
+  TEST_ASSERT_TRUE(tracker.remove(key));
+  TEST_ASSERT_FALSE(tracker.find(key, info));
+  TEST_ASSERT_EQUAL(0, tracker.size());
+}
+
+void test_tracker_eviction_and_expiry() {
+  static BeaconTrackerBuffer<64> tracker;
+  tracker.clear();
+  BeaconData data;
+  BeaconTrackInfo info;
+
+  // Fill to the load limit (48 of 64), then keep inserting
+  for (uint16_t n = 0; n < 48; n++) {
+    TEST_ASSERT_TRUE(tracker.update(makeKey(n), data, -50, n));
+  }
+  TEST_ASSERT_EQUAL(48, tracker.size());
+  TEST_ASSERT_EQUAL(0, tracker.evictions());
+
+  for (uint16_t n = 48; n < 80; n++) {
+    TEST_ASSERT_TRUE(tracker.update(makeKey(n), data, -50, 1000 + n));
+  }
+  TEST_ASSERT_EQUAL(48, tracker.size());
+  TEST_ASSERT_EQUAL(32, tracker.evictions());
+
+  // Evictions take old beacons: every newer one is still found
+  for (uint16_t n = 48; n < 80; n++) {
+    TEST_ASSERT_TRUE(tracker.find(makeKey(n), info));
+    TEST_ASSERT_EQUAL(1000 + n, info.last_seen);
+  }
+
+  // Iteration sees exactly the tracked beacons
+  uint16_t seen = 0;
+  for (uint16_t i = 0; i < tracker.capacity(); i++) {
+    if (tracker.entryAt(i, info)) {
+      TEST_ASSERT_TRUE(tracker.find(info.key, info));
+      seen++;
+    }
+  }
+  TEST_ASSERT_EQUAL(48, seen);
+
+  // Age out everything not seen in the last 10 time units, across a clock wrap
+  for (uint16_t n = 70; n < 80; n++) {
+    TEST_ASSERT_TRUE(tracker.update(makeKey(n), data, -50, 0xFFFFFFF0u));
+  }
+  TEST_ASSERT_EQUAL(38, tracker.expire(5, 100));
+  TEST_ASSERT_EQUAL(10, tracker.size());
+  for (uint16_t n = 70; n < 80; n++) {
+    TEST_ASSERT_TRUE(tracker.find(makeKey(n), info));
+  }
+}
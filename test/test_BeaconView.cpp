@@ -0,0 +1,67 @@
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "BeaconView.h"
+
+void test_view_ibeacon_fields() {
+  static const uint8_t packet[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                   0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                   0xCD, 0x7A, 0x35, 0x4A, 0x01, 0x02, 0x03, 0x04, 0xC5};
+
+  BLEBeaconParser parser;
+  BeaconView view;
+
+  TEST_ASSERT_TRUE(parser.parseView(packet, sizeof(packet), view));
+  TEST_ASSERT_TRUE(view.valid());
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, view.type());
+
+  // Identity points into the caller's buffer rather than a copy
+  TEST_ASSERT_EQUAL_PTR(&packet[6], view.uuidBytes());
+  TEST_ASSERT_EQUAL(0x0102, view.major());
+  TEST_ASSERT_EQUAL(0x0304, view.minor());
+  TEST_ASSERT_EQUAL(-59, view.txPower());
+  TEST_ASSERT_EQUAL(0, view.tlmBatteryMv());
+  TEST_ASSERT_NULL(view.namespaceId());
+
+  // Full decode on demand matches parse()
+  BeaconData result;
+  TEST_ASSERT_TRUE(view.decode(result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL(0x0102, result.getIBeacon().major);
+
+  // Apple data that is not an iBeacon clears the view
+  static const uint8_t not_ibeacon[] = {0x06, 0xFF, 0x4C, 0x00, 0x10, 0x01, 0x00};
+  TEST_ASSERT_FALSE(parser.parseView(not_ibeacon, sizeof(not_ibeacon), view));
+  TEST_ASSERT_FALSE(view.valid());
+  TEST_ASSERT_NULL(view.uuidBytes());
+}
+
+void test_view_eddystone_frames() {
+  BLEBeaconParser parser;
+  BeaconView view;
+
+  // TLM: 3000 mV, 25.5 C, 258 advertisements, 100.0 s uptime
+  static const uint8_t tlm[] = {0x11, 0x16, 0xAA, 0xFE, 0x20, 0x00, 0x0B, 0xB8, 0x19,
+                                0x80, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00, 0x03, 0xE8};
+  TEST_ASSERT_TRUE(parser.parseView(tlm, sizeof(tlm), view));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_TLM, view.type());
+  TEST_ASSERT_EQUAL(3000, view.tlmBatteryMv());
+  TEST_ASSERT_EQUAL(0x1980, view.tlmTemperatureRaw());
+  TEST_ASSERT_EQUAL(258, view.tlmAdvCount());
+  TEST_ASSERT_EQUAL(1000, view.tlmUptimeDeciseconds());
+  TEST_ASSERT_EQUAL(0, view.major());
+
+  // URL: https://www.google.com/
+  static const uint8_t url[] = {0x0D, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x01,
+                                0x67, 0x6F, 0x6F, 0x67, 0x6C, 0x65, 0x00};
+  char text[EDDYSTONE_URL_MAX_LENGTH + 1];
+  TEST_ASSERT_TRUE(parser.parseView(url, sizeof(url), view));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_URL, view.type());
+  TEST_ASSERT_EQUAL(-21, view.txPower());
+  TEST_ASSERT_EQUAL(23, view.urlToChars(text));
+  TEST_ASSERT_EQUAL_STRING("https://www.google.com/", text);
+
+  // Unknown URL scheme is rejected at classification, as in parse()
+  static const uint8_t bad_scheme[] = {0x07, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x07, 0x61};
+  TEST_ASSERT_FALSE(parser.parseView(bad_scheme, sizeof(bad_scheme), view));
+}
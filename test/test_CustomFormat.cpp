@@ -0,0 +1,74 @@
+#include <string.h>
+#include <unity.h>
+#include "BLEBeaconParser.h"
+
+#define SENSOR_TAG_FORMAT 7
+
+// Nordic company ID, prefix CA FE, then a big-endian 16-bit reading
+static bool decodeSensorTag(const ADField& field, BeaconData& result) {
+  if (field.len < 4) {
+    return false;
+  }
+  uint16_t reading = (field.data[2] << 8) | field.data[3];
+  memcpy(result.custom.data, &reading, sizeof(reading));
+  result.custom.len = sizeof(reading);
+  result.custom.format = SENSOR_TAG_FORMAT;
+  result.type = BEACON_TYPE_CUSTOM;
+  result.valid = true;
+  return true;
+}
+
+// Apple manufacturer data sharing the iBeacon key (e.g. 0x12 0x19 Find My)
+static bool decodeAppleNearby(const ADField& field, BeaconData& result) {
+  result.custom.len = 0;
+  result.custom.format = field.data[0];
+  result.type = BEACON_TYPE_CUSTOM;
+  result.valid = true;
+  return true;
+}
+
+void test_custom_format_dispatch() {
+  BLEBeaconParser parser;
+  BeaconData result;
+
+  BeaconSignature sensor_tag = {AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x0059, {0xCA, 0xFE}, 2};
+  TEST_ASSERT_TRUE(parser.addFormat(sensor_tag, decodeSensorTag));
+
+  // Flags, then the custom manufacturer data
+  uint8_t packet[] = {0x02, 0x01, 0x06, 0x07, 0xFF, 0x59, 0x00, 0xCA, 0xFE, 0x01, 0x2C};
+  TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_CUSTOM, result.type);
+  TEST_ASSERT_EQUAL(SENSOR_TAG_FORMAT, result.getCustom().format);
+
+  uint16_t reading;
+  memcpy(&reading, result.getCustom().data, sizeof(reading));
+  TEST_ASSERT_EQUAL(300, reading);
+
+  // Same company ID with a different prefix does not reach the decoder
+  packet[7] = 0xCB;
+  TEST_ASSERT_FALSE(parser.parse(packet, sizeof(packet), result));
+
+  // Oversized prefixes are rejected
+  BeaconSignature too_long = {AD_TYPE_SERVICE_DATA, 0xFEAA, {0}, BEACON_SIGNATURE_MAX_PREFIX + 1};
+  TEST_ASSERT_FALSE(parser.addFormat(too_long, decodeSensorTag));
+}
+
+void test_custom_format_shares_builtin_key() {
+  BLEBeaconParser parser;
+  BeaconData result;
+
+  BeaconSignature nearby = {AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x004C, {0x12, 0x19}, 2};
+  TEST_ASSERT_TRUE(parser.addFormat(nearby, decodeAppleNearby));
+
+  uint8_t find_my[] = {0x07, 0xFF, 0x4C, 0x00, 0x12, 0x19, 0x00, 0x01};
+  TEST_ASSERT_TRUE(parser.parse(find_my, sizeof(find_my), result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_CUSTOM, result.type);
+  TEST_ASSERT_EQUAL(0x12, result.getCustom().format);
+
+  // iBeacon data on the same key still goes to the built-in decoder
+  uint8_t ibeacon[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                       0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                       0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+  TEST_ASSERT_TRUE(parser.parse(ibeacon, sizeof(ibeacon), result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+}
@@ -84,7 +84,7 @@ void test_eddystone_url_parse() {
   const EddystoneURLData& url = result.getEddystoneURL();
   TEST_ASSERT_EQUAL(-16, url.tx_power);
   // URL should be: http://www. + example + .com/
-  TEST_ASSERT_EQUAL_STRING("http://www.example.com/", url.url.c_str());
+  TEST_ASSERT_EQUAL_STRING("http://www.example.com/", url.url);
 }
 
 void test_eddystone_tlm_parse() {
@@ -0,0 +1,71 @@
+#include <unity.h>
+#include "BLEBeaconParser.h"
+#include "parsers/EddystoneParser.h"
+#include "parsers/EddystoneURL.h"
+
+void test_eddystone_url_expansion_table() {
+  char url[EDDYSTONE_URL_MAX_LENGTH + 1];
+
+  // Every suffix code, then plain characters
+  const uint8_t suffixes[] = {0x03, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                              0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 'a', 'Z', '~'};
+  const char* expected =
+    "https://.com/.org/.edu/.net/.info/.biz/.gov/.com.org.edu.net.info.biz.govaZ~";
+  TEST_ASSERT_EQUAL(strlen(expected), EddystoneURLDecoder::expand(suffixes, sizeof(suffixes), url));
+  TEST_ASSERT_EQUAL_STRING(expected, url);
+
+  // Scheme only
+  const uint8_t scheme_only[] = {0x01};
+  TEST_ASSERT_EQUAL(12, EddystoneURLDecoder::expand(scheme_only, sizeof(scheme_only), url));
+  TEST_ASSERT_EQUAL_STRING("https://www.", url);
+
+  // Unknown scheme
+  const uint8_t bad_scheme[] = {0x04, 'a'};
+  TEST_ASSERT_EQUAL(0, EddystoneURLDecoder::expand(bad_scheme, sizeof(bad_scheme), url));
+}
+
+// Custom frame type 0x50 on the Eddystone service UUID
+static bool decodeFrame50(const ADField& field, BeaconData& result) {
+  result.custom.data[0] = field.data[1];
+  result.custom.len = 1;
+  result.custom.format = 0x50;
+  result.type = BEACON_TYPE_CUSTOM;
+  result.valid = true;
+  return true;
+}
+
+void test_eddystone_url_cache() {
+  EddystoneURLCache cache;
+  BLEBeaconParser parser;
+  BeaconData result;
+
+  // https://www.google.com/
+  uint8_t packet[] = {0x0D, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x01,
+                      0x67, 0x6F, 0x6F, 0x67, 0x6C, 0x65, 0x00};
+
+  parser.setURLCache(&cache);
+  for (uint8_t i = 0; i < 3; i++) {
+    TEST_ASSERT_TRUE(parser.parse(packet, sizeof(packet), result));
+    TEST_ASSERT_EQUAL_STRING("https://www.google.com/", result.getEddystoneURL().url);
+  }
+
+  // The cache belongs to that parser; others expand on their own
+  BLEBeaconParser other;
+  TEST_ASSERT_TRUE(other.parse(packet, sizeof(packet), result));
+  TEST_ASSERT_EQUAL_STRING("https://www.google.com/", result.getEddystoneURL().url);
+
+  TEST_ASSERT_EQUAL(1, cache.misses());
+  TEST_ASSERT_EQUAL(2, cache.hits());
+
+  // Custom formats on the Eddystone key still decode with the cache set
+  BeaconSignature frame50 = {AD_TYPE_SERVICE_DATA, 0xFEAA, {0x50}, 1};
+  TEST_ASSERT_TRUE(parser.addFormat(frame50, decodeFrame50));
+  uint8_t custom[] = {0x05, 0x16, 0xAA, 0xFE, 0x50, 0x2A};
+  TEST_ASSERT_TRUE(parser.parse(custom, sizeof(custom), result));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_CUSTOM, result.type);
+  TEST_ASSERT_EQUAL(0x2A, result.getCustom().data[0]);
+
+  cache.clear();
+  TEST_ASSERT_EQUAL(0, cache.hits());
+  TEST_ASSERT_EQUAL(0, cache.misses());
+}
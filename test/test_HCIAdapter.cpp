@@ -0,0 +1,274 @@
+#include <string.h>
+#include <unity.h>
+#include "BeaconBatch.h"
+#include "HCIAdapter.h"
+
+// LE Advertising Report event with three reports: an iBeacon
+// (ADV_NONCONN_IND), an Eddystone-UID (ADV_IND) and a scan response that
+// is not a beacon
+static const uint8_t LEGACY_EVENT[] = {
+  0x3E, 0x5B, 0x02, 0x03,
+  // iBeacon: event type, address type, address, length, data, RSSI
+  0x03, 0x01, 0x01, 0x02, 0x03, 0x04, 0x05, 0xC6, 0x1E, 0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00,
+  0x02, 0x15, 0x5F, 0x2D, 0xD8, 0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A, 0xCD, 0x7A,
+  0x35, 0x4A, 0x00, 0x01, 0x00, 0x02, 0xC5, 0xC4,
+  // Eddystone-UID
+  0x00, 0x00, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x1A, 0x03, 0x03, 0xAA, 0xFE, 0x15, 0x16, 0xAA,
+  0xFE, 0x00, 0xEC, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D,
+  0x0E, 0x0F, 0x10, 0xBA,
+  // Scan response
+  0x04, 0x00, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x03, 0x02, 0x0A, 0x08, 0xB0};
+
+// LE Extended Advertising Report event with one connectable report
+static const uint8_t EXTENDED_EVENT[] = {
+  0x3E, 0x28, 0x0D, 0x01,
+  // Event type, address type, address, PHYs, SID, TX power, RSSI
+  0x01, 0x00, 0x00, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0x01, 0x02, 0x00, 0xF8, 0xBE,
+  // Periodic interval, direct address type and address, length, data
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x02, 0x01, 0x06, 0x0A, 0x09, 'G',
+  'a', 't', 'e', 'w', 'a', 'y', '-', '1'};
+
+static uint8_t handled;
+
+static void count_beacon(const BeaconData& result, const ScanObservation& observation) {
+  (void)observation;
+  if (result.valid) {
+    handled++;
+  }
+}
+
+void test_hci_report_reader() {
+  HCIReportReader reports;
+  ScanObservation observation;
+
+  TEST_ASSERT_TRUE(reports.begin(LEGACY_EVENT, sizeof(LEGACY_EVENT), 1234));
+  TEST_ASSERT_EQUAL(3, reports.remaining());
+
+  TEST_ASSERT_TRUE(reports.next(observation));
+  TEST_ASSERT_EQUAL_PTR(&LEGACY_EVENT[13], observation.payload);
+  TEST_ASSERT_EQUAL(30, observation.payload_len);
+  TEST_ASSERT_EQUAL(0xC6, observation.address[5]);
+  TEST_ASSERT_EQUAL(1, observation.address_type);
+  TEST_ASSERT_EQUAL(-60, observation.rssi);
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_LEGACY, observation.flags);
+  TEST_ASSERT_TRUE(observation.timestamp_us == 1234);
+
+  TEST_ASSERT_TRUE(reports.next(observation));
+  TEST_ASSERT_EQUAL(0x16, observation.address[5]);
+  TEST_ASSERT_EQUAL(-70, observation.rssi);
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_LEGACY | SCAN_OBSERVATION_CONNECTABLE |
+                      SCAN_OBSERVATION_SCANNABLE,
+                    observation.flags);
+
+  TEST_ASSERT_TRUE(reports.next(observation));
+  TEST_ASSERT_EQUAL(3, observation.payload_len);
+  TEST_ASSERT_EQUAL(-80, observation.rssi);
+  TEST_ASSERT_TRUE(observation.flags & SCAN_OBSERVATION_SCAN_RESPONSE);
+  TEST_ASSERT_FALSE(reports.next(observation));
+
+  // Extended reports carry TX power and the event type bits as flags
+  TEST_ASSERT_TRUE(reports.begin(EXTENDED_EVENT, sizeof(EXTENDED_EVENT)));
+  TEST_ASSERT_TRUE(reports.next(observation));
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_CONNECTABLE, observation.flags);
+  TEST_ASSERT_EQUAL(0xA6, observation.address[5]);
+  TEST_ASSERT_EQUAL(-8, observation.tx_power);
+  TEST_ASSERT_EQUAL(-66, observation.rssi);
+  TEST_ASSERT_EQUAL(14, observation.payload_len);
+  TEST_ASSERT_EQUAL('1', observation.payload[13]);
+  TEST_ASSERT_FALSE(reports.next(observation));
+
+  // Reports overrunning the event, other events, short buffers
+  uint8_t broken[sizeof(LEGACY_EVENT)];
+  memcpy(broken, LEGACY_EVENT, sizeof(broken));
+  broken[12] = 0xF0;
+  TEST_ASSERT_TRUE(reports.begin(broken, sizeof(broken)));
+  TEST_ASSERT_FALSE(reports.next(observation));
+  TEST_ASSERT_EQUAL(0, reports.remaining());
+
+  static const uint8_t command_complete[] = {0x0E, 0x04, 0x01, 0x0C, 0x20, 0x00};
+  TEST_ASSERT_FALSE(reports.begin(command_complete, sizeof(command_complete)));
+  TEST_ASSERT_FALSE(reports.begin(LEGACY_EVENT, 40));
+}
+
+void test_hci_parse_event() {
+  HCIBeaconParser parser;
+
+  handled = 0;
+  TEST_ASSERT_EQUAL(3, parser.parse(LEGACY_EVENT, sizeof(LEGACY_EVENT), count_beacon));
+  TEST_ASSERT_EQUAL(2, handled);
+  TEST_ASSERT_EQUAL(1, parser.parse(EXTENDED_EVENT, sizeof(EXTENDED_EVENT), count_beacon));
+  TEST_ASSERT_EQUAL(2, handled);
+
+  BeaconBatchBuffer<8> batch;
+  ScanObservation observations[8];
+  TEST_ASSERT_EQUAL(2, parser.parseBatch(LEGACY_EVENT, sizeof(LEGACY_EVENT), batch, observations));
+  TEST_ASSERT_EQUAL(3, batch.count);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, batch.type[0]);
+  TEST_ASSERT_EQUAL(2, batch.minor[0]);
+  TEST_ASSERT_EQUAL(BEACON_TYPE_EDDYSTONE_UID, batch.type[1]);
+  TEST_ASSERT_EQUAL(0x10, batch.id[1][15]);
+  TEST_ASSERT_FALSE(batch.valid[2]);
+  TEST_ASSERT_EQUAL(-70, observations[1].rssi);
+
+  // Rows are limited by the batch capacity
+  BeaconBatchBuffer<1> small;
+  TEST_ASSERT_EQUAL(1, parser.parseBatch(LEGACY_EVENT, sizeof(LEGACY_EVENT), small));
+  TEST_ASSERT_EQUAL(1, small.count);
+}
+
+// LE Extended Advertising Report event carrying the iBeacon of
+// LEGACY_EVENT, with the given event type
+static uint16_t buildExtended(uint8_t* event, uint16_t event_type) {
+  // Address type, address, PHYs, SID, TX power, RSSI, periodic interval,
+  // direct address type and address
+  static const uint8_t fixed[] = {0x01, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0x01, 0x00, 0xFF, 0xC5,
+                                  0xBA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  uint8_t len = LEGACY_EVENT[12];
+
+  event[0] = HCI_EVENT_LE_META;
+  event[1] = 2 + 24 + len;
+  event[2] = HCI_SUBEVENT_EXTENDED_ADVERTISING_REPORT;
+  event[3] = 1;
+  event[4] = event_type & 0xFF;
+  event[5] = event_type >> 8;
+  memcpy(&event[6], fixed, sizeof(fixed));
+  event[27] = len;
+  memcpy(&event[28], &LEGACY_EVENT[13], len);
+  return 28 + len;
+}
+
+void test_hci_extended_fragments() {
+  uint8_t event[64];
+  HCIReportReader reports;
+  ScanObservation observation;
+  HCIBeaconParser parser;
+  BeaconBatchBuffer<4> batch;
+  ScanObservation observations[4];
+
+  // A complete report parses as usual
+  uint16_t len = buildExtended(event, 0x00);
+  TEST_ASSERT_TRUE(reports.begin(event, len));
+  TEST_ASSERT_TRUE(reports.next(observation));
+  TEST_ASSERT_EQUAL(0, observation.flags);
+  TEST_ASSERT_EQUAL(0xC6, observation.address[5]);
+  TEST_ASSERT_EQUAL(-70, observation.rssi);
+  TEST_ASSERT_TRUE(observation.complete());
+  handled = 0;
+  TEST_ASSERT_EQUAL(1, parser.parse(event, len, count_beacon));
+  TEST_ASSERT_EQUAL(1, handled);
+  TEST_ASSERT_EQUAL(1, parser.parseBatch(event, len, batch));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, batch.type[0]);
+
+  // Data_Status "incomplete, more data to come" and "incomplete, truncated"
+  static const uint8_t status[] = {SCAN_OBSERVATION_INCOMPLETE, SCAN_OBSERVATION_TRUNCATED};
+  for (uint8_t i = 0; i < sizeof(status); i++) {
+    len = buildExtended(event, status[i] | SCAN_OBSERVATION_SCANNABLE);
+    TEST_ASSERT_TRUE(reports.begin(event, len));
+    TEST_ASSERT_TRUE(reports.next(observation));
+    TEST_ASSERT_EQUAL(status[i] | SCAN_OBSERVATION_SCANNABLE, observation.flags);
+    TEST_ASSERT_FALSE(observation.complete());
+
+    // Counted as a report, but not handed over as a beacon
+    handled = 0;
+    TEST_ASSERT_EQUAL(1, parser.parse(event, len, count_beacon));
+    TEST_ASSERT_EQUAL(0, handled);
+
+    TEST_ASSERT_EQUAL(0, parser.parseBatch(event, len, batch, observations));
+    TEST_ASSERT_EQUAL(1, batch.count);
+    TEST_ASSERT_FALSE(batch.valid[0]);
+    TEST_ASSERT_EQUAL(30, observations[0].payload_len);
+    TEST_ASSERT_FALSE(observations[0].complete());
+  }
+}
+
+// H4 stream: a command, the legacy report event, an ACL packet, a stray
+// byte, a Command Complete event and the extended report event
+static size_t buildStream(uint8_t* stream) {
+  static const uint8_t command[] = {0x01, 0x0B, 0x20, 0x01, 0x01};
+  static const uint8_t acl[] = {0x02, 0x40, 0x00, 0x05, 0x00, 0x01, 0x00, 0x04, 0x00, 0x0A};
+  static const uint8_t command_complete[] = {0x04, 0x0E, 0x04, 0x01, 0x0B, 0x20, 0x00};
+
+  size_t len = 0;
+  memcpy(&stream[len], command, sizeof(command));
+  len += sizeof(command);
+  stream[len++] = 0x04;
+  memcpy(&stream[len], LEGACY_EVENT, sizeof(LEGACY_EVENT));
+  len += sizeof(LEGACY_EVENT);
+  memcpy(&stream[len], acl, sizeof(acl));
+  len += sizeof(acl);
+  stream[len++] = 0xFF;
+  memcpy(&stream[len], command_complete, sizeof(command_complete));
+  len += sizeof(command_complete);
+  stream[len++] = 0x04;
+  memcpy(&stream[len], EXTENDED_EVENT, sizeof(EXTENDED_EVENT));
+  len += sizeof(EXTENDED_EVENT);
+  return len;
+}
+
+void test_h4_stream_chunking() {
+  uint8_t stream[256];
+  size_t len = buildStream(stream);
+  HCIBeaconParser parser;
+
+  // In one piece, every event is parsed in place
+  H4StreamDecoder whole(parser);
+  handled = 0;
+  TEST_ASSERT_EQUAL(4, whole.feed(stream, len, count_beacon));
+  TEST_ASSERT_EQUAL(2, handled);
+  TEST_ASSERT_EQUAL(2, whole.events());
+  TEST_ASSERT_EQUAL(0, whole.copies());
+  TEST_ASSERT_EQUAL(1, whole.resyncs());
+
+  // Any chunking gives the same reports
+  for (size_t chunk = 1; chunk < len; chunk++) {
+    H4StreamDecoder decoder(parser);
+    uint16_t reports = 0;
+    handled = 0;
+    for (size_t pos = 0; pos < len; pos += chunk) {
+      reports += decoder.feed(&stream[pos], len - pos < chunk ? len - pos : chunk, count_beacon);
+    }
+    TEST_ASSERT_EQUAL(4, reports);
+    TEST_ASSERT_EQUAL(2, handled);
+    TEST_ASSERT_EQUAL(2, decoder.events());
+    TEST_ASSERT_EQUAL(1, decoder.resyncs());
+  }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <unistd.h>
+
+void test_h4_stream_pipe() {
+  int fds[2];
+  TEST_ASSERT_EQUAL(0, pipe(fds));
+
+  // Recorded bytes, written in pieces that do not line up with packets
+  uint8_t stream[256];
+  size_t len = buildStream(stream);
+  for (uint8_t copy = 0; copy < 10; copy++) {
+    for (size_t pos = 0; pos < len; pos += 50) {
+      size_t piece = len - pos < 50 ? len - pos : 50;
+      TEST_ASSERT_EQUAL((ssize_t)piece, write(fds[1], &stream[pos], piece));
+    }
+  }
+  close(fds[1]);
+
+  HCIBeaconParser parser;
+  H4StreamDecoder decoder(parser);
+  uint8_t chunk[200];
+  ssize_t got;
+  uint16_t reports = 0;
+  handled = 0;
+  while ((got = read(fds[0], chunk, sizeof(chunk))) > 0) {
+    reports += decoder.feed(chunk, got, count_beacon);
+  }
+  close(fds[0]);
+
+  TEST_ASSERT_EQUAL(40, reports);
+  TEST_ASSERT_EQUAL(20, handled);
+  TEST_ASSERT_EQUAL(20, decoder.events());
+  // Only events split between two reads were copied
+  TEST_ASSERT_TRUE(decoder.copies() > 0 && decoder.copies() < decoder.events());
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include <unity.h>
+#include <string.h>
+#include "BLEBeaconParser.h"
+#include "BeaconTracker.h"
+#include "ScanObservation.h"
+#include "ScanRing.h"
+
+static const uint8_t IBEACON_PACKET[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x5F, 0x2D, 0xD8,
+                                         0x96, 0xB8, 0x86, 0x45, 0x49, 0xAE, 0x01, 0xE4, 0x1A,
+                                         0xCD, 0x7A, 0x35, 0x4A, 0x00, 0x07, 0x00, 0x09, 0xC5};
+
+void test_scan_observation_parse() {
+  TEST_ASSERT_TRUE(sizeof(ScanObservation) <= 32);
+
+  ScanObservation observation;
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_UNAVAILABLE, observation.rssi);
+
+  observation.payload = IBEACON_PACKET;
+  observation.payload_len = sizeof(IBEACON_PACKET);
+  observation.timestamp_us = 5000000;
+  observation.rssi = -72;
+
+  BLEBeaconParser parser;
+  BeaconData result;
+  BeaconKey key;
+  TEST_ASSERT_TRUE(parser.parse(observation, result, key));
+  TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL(7, result.getIBeacon().major);
+
+  BeaconView view;
+  TEST_ASSERT_TRUE(parser.parseView(observation, view));
+  TEST_ASSERT_TRUE(view.key() == key);
+
+  // Extended payloads longer than 255 bytes are parsed whole, not truncated
+  static uint8_t extended[300];
+  memset(extended, 'x', sizeof(extended));
+  extended[0] = 0xFE;
+  extended[1] = 0x09;
+  extended[255] = 0x11;
+  extended[256] = 0x09;
+  memcpy(&extended[273], IBEACON_PACKET, sizeof(IBEACON_PACKET));
+  observation.payload = extended;
+  observation.payload_len = sizeof(extended);
+  TEST_ASSERT_TRUE(parser.parse(observation, result));
+  TEST_ASSERT_EQUAL(9, result.getIBeacon().minor);
+
+  // The tracker takes RSSI and time (in milliseconds) from the observation
+  static BeaconTrackerBuffer<8> tracker;
+  observation.payload = IBEACON_PACKET;
+  observation.payload_len = sizeof(IBEACON_PACKET);
+  TEST_ASSERT_TRUE(tracker.update(key, result, observation));
+  BeaconTrackInfo info;
+  TEST_ASSERT_TRUE(tracker.find(key, info));
+  TEST_ASSERT_EQUAL(-72, info.last_rssi);
+  TEST_ASSERT_EQUAL(5000, info.last_seen);
+}
+
+void test_scan_observation_through_ring() {
+  static ScanRingBuffer<4> ring;
+  const uint8_t address[6] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+
+  ScanObservation observation;
+  observation.payload = IBEACON_PACKET;
+  observation.payload_len = sizeof(IBEACON_PACKET);
+  observation.timestamp_us = 123456789;
+  memcpy(observation.address, address, sizeof(address));
+  observation.address_type = 1;
+  observation.rssi = -55;
+  observation.channel = 38;
+  observation.flags = SCAN_OBSERVATION_LEGACY | SCAN_OBSERVATION_SCANNABLE;
+  TEST_ASSERT_TRUE(ring.push(observation));
+
+  ScanObservation queued = ring.slot(0).observation();
+  TEST_ASSERT_TRUE(queued.payload != IBEACON_PACKET);
+  TEST_ASSERT_EQUAL(sizeof(IBEACON_PACKET), queued.payload_len);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(IBEACON_PACKET, queued.payload, sizeof(IBEACON_PACKET));
+  TEST_ASSERT_TRUE(queued.timestamp_us == 123456789);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(address, queued.address, 6);
+  TEST_ASSERT_EQUAL(1, queued.address_type);
+  TEST_ASSERT_EQUAL(-55, queued.rssi);
+  TEST_ASSERT_EQUAL(38, queued.channel);
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_UNAVAILABLE, queued.tx_power);
+  TEST_ASSERT_EQUAL(SCAN_OBSERVATION_LEGACY | SCAN_OBSERVATION_SCANNABLE, queued.flags);
+  ring.release(1);
+}
@@ -0,0 +1,93 @@
+#include <unity.h>
+#include <string.h>
+#include <thread>
+#include "ScanRing.h"
+
+void test_scan_ring_fifo_and_overflow() {
+  static ScanRingBuffer<4> ring;
+  uint8_t data[SCAN_RING_DATA_SIZE + 1];
+  const uint8_t address[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+
+  for (uint8_t i = 0; i < sizeof(data); i++) {
+    data[i] = i;
+  }
+
+  TEST_ASSERT_EQUAL(0, ring.readable());
+  for (uint8_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(ring.push(&data[i], 10, -40 - i, address, 1));
+  }
+
+  // Full ring drops and counts
+  TEST_ASSERT_FALSE(ring.push(data, 10, -40));
+  TEST_ASSERT_EQUAL(1, ring.overflows());
+
+  // Reports longer than a slot are rejected
+  TEST_ASSERT_FALSE(ring.push(data, SCAN_RING_DATA_SIZE + 1, -40));
+  TEST_ASSERT_EQUAL(1, ring.oversized());
+
+  TEST_ASSERT_EQUAL(4, ring.readable());
+  const ScanRingSlot& first = ring.slot(0);
+  TEST_ASSERT_EQUAL(10, first.len);
+  TEST_ASSERT_EQUAL(-40, first.rssi);
+  TEST_ASSERT_EQUAL(1, first.address_type);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(address, first.address, 6);
+  TEST_ASSERT_EQUAL(3, ring.slot(3).data[0]);
+
+  // Releasing a batch frees room for the producer
+  ring.release(2);
+  TEST_ASSERT_EQUAL(2, ring.readable());
+  TEST_ASSERT_TRUE(ring.push(data, SCAN_RING_DATA_SIZE, -50));
+
+  ScanRingSlot out;
+  TEST_ASSERT_TRUE(ring.pop(out));
+  TEST_ASSERT_EQUAL(2, out.data[0]);
+  TEST_ASSERT_TRUE(ring.pop(out));
+  TEST_ASSERT_EQUAL(3, out.data[0]);
+  TEST_ASSERT_TRUE(ring.pop(out));
+  TEST_ASSERT_EQUAL(SCAN_RING_DATA_SIZE, out.len);
+  TEST_ASSERT_EQUAL(0, out.address[0]);
+  TEST_ASSERT_FALSE(ring.pop(out));
+}
+
+void test_scan_ring_concurrent() {
+  static ScanRingBuffer<64> ring;
+  const uint32_t total = 200000;
+
+  // Producer thread pushes a sequence number per report; the consumer
+  // must see every report that was not dropped, in order
+  std::thread producer([&]() {
+    for (uint32_t n = 0; n < total; n++) {
+      uint8_t data[8];
+      memcpy(data, &n, sizeof(n));
+      memcpy(&data[4], &n, sizeof(n));
+      ring.push(data, sizeof(data), -60);
+    }
+  });
+
+  uint32_t received = 0;
+  uint32_t last = 0;
+  bool ordered = true;
+  bool intact = true;
+
+  while (received + ring.overflows() < total) {
+    uint16_t count = ring.readable();
+    for (uint16_t i = 0; i < count; i++) {
+      const ScanRingSlot& slot = ring.slot(i);
+      uint32_t a;
+      uint32_t b;
+      memcpy(&a, slot.data, sizeof(a));
+      memcpy(&b, &slot.data[4], sizeof(b));
+      intact = intact && a == b && slot.len == 8;
+      ordered = ordered && (received == 0 || a > last);
+      last = a;
+      received++;
+    }
+    ring.release(count);
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(intact);
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL(total, received + ring.overflows());
+  TEST_ASSERT_EQUAL(0, ring.readable());
+}
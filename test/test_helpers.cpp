@@ -24,6 +24,11 @@ void test_findManufacturerData() {
   // Let's check what the actual implementation returns
   TEST_ASSERT_EQUAL(3, out_len);  // 5 (ad_len) - 2 (CompanyID) = 3
   TEST_ASSERT_EQUAL(0x01, out_data[0]);
+
+  // A structure too short for a company ID, last in the buffer, is not read past
+  uint8_t short_field[] = {0x02, 0xFF, 0x4C};
+  TEST_ASSERT_FALSE(BLEBeaconParser::findManufacturerData(short_field, sizeof(short_field), 0x004C,
+                                                          out_data, out_len));
 }
 
 void test_findServiceData() {
@@ -42,6 +47,10 @@ void test_findServiceData() {
   TEST_ASSERT_EQUAL(5, out_len);
   TEST_ASSERT_EQUAL(0xAA, out_data[0]);
   TEST_ASSERT_EQUAL(0xFE, out_data[1]);
+
+  uint8_t short_field[] = {0x02, 0x16, 0xAA};
+  TEST_ASSERT_FALSE(
+    BLEBeaconParser::findServiceData(short_field, sizeof(short_field), 0xFEAA, out_data, out_len));
 }
 
 void test_unknown_beacon() {
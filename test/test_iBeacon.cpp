@@ -27,8 +27,9 @@ void test_iBeacon_parse() {
   TEST_ASSERT_TRUE(success);
   TEST_ASSERT_TRUE(result.valid);
   TEST_ASSERT_EQUAL(BEACON_TYPE_IBEACON, result.type);
+  TEST_ASSERT_EQUAL_MEMORY(&ibeacon_packet[6], result.getIBeacon().uuid, 16);
   TEST_ASSERT_EQUAL_STRING("5F2DD896-B886-4549-AE01-E41ACD7A354A",
-                           result.getIBeacon().uuid.c_str());
+                           result.getIBeacon().uuidString().c_str());
   TEST_ASSERT_EQUAL(1, result.getIBeacon().major);
   TEST_ASSERT_EQUAL(2, result.getIBeacon().minor);
   TEST_ASSERT_EQUAL(-59, result.getIBeacon().tx_power);
@@ -22,6 +22,69 @@ void test_findServiceData();
 void test_unknown_beacon();
 void test_null_data();
 void test_empty_data();
+void test_tokenizer_locates_fields();
+void test_tokenizer_bounds();
+void test_tokenizer_many_fields();
+void test_dispatch_lookup();
+void test_dispatch_skips_unmatched_fields();
+void test_dispatch_skip_decoder();
+void test_parse_batch_packets();
+void test_parse_batch_packed();
+void test_prefilter_signatures();
+void test_prefilter_matches_scalar();
+void test_beacon_data_memcpy_relocation();
+void test_eddystone_url_length_limit();
+void test_eddystone_url_expansion_table();
+void test_eddystone_url_cache();
+void test_view_ibeacon_fields();
+void test_view_eddystone_frames();
+void test_composed_parser_single_format();
+void test_composed_parser_batch();
+void test_custom_format_dispatch();
+void test_custom_format_shares_builtin_key();
+void test_layout_compile();
+void test_layout_extract();
+void test_hash_matches_scalar();
+void test_beacon_key_identity();
+void test_parse_cache_hits();
+void test_parse_cache_eviction();
+void test_parse_cache_clock_hand();
+void test_tracker_updates();
+void test_tracker_eviction_and_expiry();
+void test_scan_ring_fifo_and_overflow();
+void test_scan_ring_concurrent();
+#if defined(__linux__)
+void test_pipeline_shards_beacon_state();
+void test_pipeline_extended_payload();
+#endif
+void test_scan_observation_parse();
+void test_scan_observation_through_ring();
+void test_aggregator_tumbling_window();
+void test_aggregator_sliding_window();
+void test_aggregator_late_packet();
+void test_presence_enter_exit();
+void test_presence_wheel_levels();
+void test_region_index_lookup();
+void test_region_index_matches_linear_scan();
+void test_filter_compile();
+void test_filter_match();
+void test_capture_record_encoding();
+#if defined(__unix__) || defined(__APPLE__)
+void test_capture_file_replay();
+#endif
+void test_import_pcap_link_layer();
+void test_import_btsnoop_reports();
+void test_hci_report_reader();
+void test_hci_parse_event();
+void test_hci_extended_fragments();
+void test_h4_stream_chunking();
+#if defined(__unix__) || defined(__APPLE__)
+void test_h4_stream_pipe();
+#endif
+void test_tokenizer_extended_length();
+void test_chain_tokenizer_fragments();
+void test_presence_time_wrap();
+void test_region_index_minor_bands();
 
 int main(int argc, char** argv) {
   UNITY_BEGIN();
@@ -37,6 +100,69 @@ int main(int argc, char** argv) {
   RUN_TEST(test_unknown_beacon);
   RUN_TEST(test_null_data);
   RUN_TEST(test_empty_data);
+  RUN_TEST(test_tokenizer_locates_fields);
+  RUN_TEST(test_tokenizer_bounds);
+  RUN_TEST(test_tokenizer_many_fields);
+  RUN_TEST(test_dispatch_lookup);
+  RUN_TEST(test_dispatch_skips_unmatched_fields);
+  RUN_TEST(test_dispatch_skip_decoder);
+  RUN_TEST(test_parse_batch_packets);
+  RUN_TEST(test_parse_batch_packed);
+  RUN_TEST(test_prefilter_signatures);
+  RUN_TEST(test_prefilter_matches_scalar);
+  RUN_TEST(test_beacon_data_memcpy_relocation);
+  RUN_TEST(test_eddystone_url_length_limit);
+  RUN_TEST(test_eddystone_url_expansion_table);
+  RUN_TEST(test_eddystone_url_cache);
+  RUN_TEST(test_view_ibeacon_fields);
+  RUN_TEST(test_view_eddystone_frames);
+  RUN_TEST(test_composed_parser_single_format);
+  RUN_TEST(test_composed_parser_batch);
+  RUN_TEST(test_custom_format_dispatch);
+  RUN_TEST(test_custom_format_shares_builtin_key);
+  RUN_TEST(test_layout_compile);
+  RUN_TEST(test_layout_extract);
+  RUN_TEST(test_hash_matches_scalar);
+  RUN_TEST(test_beacon_key_identity);
+  RUN_TEST(test_parse_cache_hits);
+  RUN_TEST(test_parse_cache_eviction);
+  RUN_TEST(test_parse_cache_clock_hand);
+  RUN_TEST(test_tracker_updates);
+  RUN_TEST(test_tracker_eviction_and_expiry);
+  RUN_TEST(test_scan_ring_fifo_and_overflow);
+  RUN_TEST(test_scan_ring_concurrent);
+#if defined(__linux__)
+  RUN_TEST(test_pipeline_shards_beacon_state);
+  RUN_TEST(test_pipeline_extended_payload);
+#endif
+  RUN_TEST(test_scan_observation_parse);
+  RUN_TEST(test_scan_observation_through_ring);
+  RUN_TEST(test_aggregator_tumbling_window);
+  RUN_TEST(test_aggregator_sliding_window);
+  RUN_TEST(test_aggregator_late_packet);
+  RUN_TEST(test_presence_enter_exit);
+  RUN_TEST(test_presence_wheel_levels);
+  RUN_TEST(test_region_index_lookup);
+  RUN_TEST(test_region_index_matches_linear_scan);
+  RUN_TEST(test_filter_compile);
+  RUN_TEST(test_filter_match);
+  RUN_TEST(test_capture_record_encoding);
+#if defined(__unix__) || defined(__APPLE__)
+  RUN_TEST(test_capture_file_replay);
+#endif
+  RUN_TEST(test_import_pcap_link_layer);
+  RUN_TEST(test_import_btsnoop_reports);
+  RUN_TEST(test_hci_report_reader);
+  RUN_TEST(test_hci_parse_event);
+  RUN_TEST(test_hci_extended_fragments);
+  RUN_TEST(test_h4_stream_chunking);
+#if defined(__unix__) || defined(__APPLE__)
+  RUN_TEST(test_h4_stream_pipe);
+#endif
+  RUN_TEST(test_tokenizer_extended_length);
+  RUN_TEST(test_chain_tokenizer_fragments);
+  RUN_TEST(test_presence_time_wrap);
+  RUN_TEST(test_region_index_minor_bands);
 
   UNITY_END();
   return 0;